@@ -0,0 +1,86 @@
+// cooper/examples/actor_pool_bench.cpp
+//
+// This is a benchmark of the rate at which short-lived actors can be
+// created and destroyed, comparing new actors against ones recycled from
+// an actor_pool.
+//
+// Each pass creates a "session" actor, sends it a message, and then
+// releases it, as a server might do for each request. Both versions
+// release the actors asynchronously, in their own threads, so at the end
+// the benchmark waits for the work threads to go quiet.
+//
+// Copyright (c) 2026, Frank Pagliughi. All Rights Reserved.
+//
+
+#include "cooper/actor_pool.h"
+#include <iostream>
+#include <chrono>
+#include <string>
+
+using namespace std;
+using namespace std::chrono;
+
+/////////////////////////////////////////////////////////////////////////////
+
+// A session actor with a bit of state
+class session : public cooper::actor
+{
+	string user_;
+	size_t nreq_ = 0;
+
+public:
+	void request(const string& user) {
+		cast([this, user] {
+			user_ = user;
+			++nreq_;
+		});
+	}
+	void reset() {
+		user_.clear();
+		nreq_ = 0;
+	}
+};
+
+// --------------------------------------------------------------------------
+
+// Runs the test function n times and reports the rate.
+template <typename Func>
+void run(const string& name, size_t n, Func f)
+{
+	auto& thrs = cooper::sys_work_threads::instance();
+	thrs.wait_quiescent();
+
+	auto start = steady_clock::now();
+	for (size_t i=0; i<n; ++i)
+		f();
+	thrs.wait_quiescent();
+
+	auto t = duration<double>(steady_clock::now() - start).count();
+	cout << name << ": " << size_t(n/t) << " actors/sec" << endl;
+}
+
+// --------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	size_t n = (argc > 1) ? stoul(argv[1]) : 1000000;
+
+	cout << "Creating and destroying " << n << " actors" << endl;
+
+	run("new", n, [] {
+		auto s = cooper::make_actor<session>();
+		s->request("bubba");
+	});
+
+	cooper::actor_pool<session> pool;
+
+	run("pooled", n, [&pool] {
+		auto s = pool.acquire();
+		s->request("bubba");
+	});
+
+	cout << "Pool created " << pool.num_created() << " and recycled "
+		<< pool.num_recycled() << " actors" << endl;
+
+	return 0;
+}
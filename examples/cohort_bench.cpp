@@ -0,0 +1,126 @@
+// cooper/examples/cohort_bench.cpp
+//
+// This is a benchmark of the rate at which messages can be sent to a large
+// number of tiny actors, comparing individual actors against the members
+// of a cohort.
+//
+// Each actor is just a counter. Random increments are sent to them and
+// then the total is read back.
+//
+// Copyright (c) 2026, Frank Pagliughi. All Rights Reserved.
+//
+
+#include "cooper/cohort.h"
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+/////////////////////////////////////////////////////////////////////////////
+
+// A single counter actor
+class counter : public cooper::actor
+{
+	int64_t count_ = 0;
+
+public:
+	counter(cooper::work_thread& thr) : actor(thr) {}
+
+	void add(int64_t val) {
+		cast([this, val] { count_ += val; });
+	}
+
+	int64_t count() {
+		return call([this] { return count_; });
+	}
+};
+
+// A cohort of counters, with the counts in a single array.
+class counters : public cooper::cohort<int64_t>
+{
+	vector<int64_t> count_;
+
+protected:
+	void on_batch(const member_id* ids, const int64_t* msgs, size_t n) override {
+		auto count = count_.data();
+		for (size_t i=0; i<n; ++i)
+			count[ids[i]] += msgs[i];
+	}
+
+public:
+	counters(cooper::work_thread& thr, size_t n) : cohort(thr, n), count_(n, 0) {}
+
+	void add(member_id id, int64_t val) { send(id, val); }
+
+	int64_t total() {
+		return call([this] {
+			int64_t sum = 0;
+			for (auto c : count_) sum += c;
+			return sum;
+		});
+	}
+};
+
+// --------------------------------------------------------------------------
+
+// Runs the test function and reports the rate.
+template <typename Func>
+void run(const string& name, size_t n, Func f)
+{
+	auto start = steady_clock::now();
+	auto total = f();
+	auto t = duration<double>(steady_clock::now() - start).count();
+	cout << name << ": " << size_t(n/t) << " msgs/sec  [total: "
+		<< total << "]" << endl;
+}
+
+// --------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	size_t nActor = (argc > 1) ? stoul(argv[1]) : 100000;
+	size_t nMsg = (argc > 2) ? stoul(argv[2]) : 2000000;
+
+	cout << "Sending " << nMsg << " messages to " << nActor << " counters" << endl;
+
+	// The sequence of actors to receive the messages
+	mt19937 rng(42);
+	uniform_int_distribution<uint32_t> dist(0, uint32_t(nActor-1));
+
+	vector<uint32_t> ids(nMsg);
+	for (auto& id : ids)
+		id = dist(rng);
+
+	cooper::work_thread thr;
+
+	{
+		vector<unique_ptr<counter>> actors;
+		for (size_t i=0; i<nActor; ++i)
+			actors.push_back(make_unique<counter>(thr));
+
+		run("actors", nMsg, [&] {
+			for (auto id : ids)
+				actors[id]->add(1);
+			int64_t total = 0;
+			for (auto& a : actors)
+				total += a->count();
+			return total;
+		});
+	}
+
+	{
+		counters cnt(thr, nActor);
+
+		run("cohort", nMsg, [&] {
+			for (auto id : ids)
+				cnt.add(id, 1);
+			return cnt.total();
+		});
+	}
+
+	return 0;
+}
@@ -0,0 +1,107 @@
+// cooper/examples/core_bench.cpp
+//
+// This is a benchmark of the rate at which actors on different threads can
+// send messages to each other, comparing the default set of work threads
+// against the thread-per-core set with its mesh of SPSC queues.
+//
+// There's one actor per thread, in a ring. A number of tokens are passed
+// around the ring, each hop being a cast to the actor on the next thread,
+// until all the tokens have made the requested number of hops.
+//
+// Copyright (c) 2026, Frank Pagliughi. All Rights Reserved.
+//
+
+#include "cooper/core_threads.h"
+#include "cooper/actor.h"
+#include <iostream>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+/////////////////////////////////////////////////////////////////////////////
+
+// A node in the ring, which passes each token on to the next one
+class node : public cooper::actor
+{
+	node* next_ = nullptr;
+	uint64_t nHops_ = 0;
+
+public:
+	node(cooper::work_thread& thr) : actor(thr) {}
+
+	void set_next(node* next) { next_ = next; }
+
+	void pass(size_t hopsLeft) {
+		cast([this, hopsLeft] {
+			++nHops_;
+			if (hopsLeft > 1)
+				next_->pass(hopsLeft-1);
+		});
+	}
+
+	uint64_t num_hops() {
+		return call([this] { return nHops_; });
+	}
+};
+
+// --------------------------------------------------------------------------
+
+// Passes the tokens around a ring of actors on the threads, and reports
+// the rate.
+void run(const string& name, cooper::work_threads& thrs,
+		 size_t nToken, size_t nHop)
+{
+	size_t n = thrs.size();
+
+	vector<unique_ptr<node>> ring;
+	for (size_t i=0; i<n; ++i)
+		ring.push_back(make_unique<node>(thrs[i]));
+	for (size_t i=0; i<n; ++i)
+		ring[i]->set_next(ring[(i+1) % n].get());
+
+	thrs.wait_quiescent();
+	auto start = steady_clock::now();
+
+	for (size_t i=0; i<nToken; ++i)
+		ring[i % n]->pass(nHop);
+	thrs.wait_quiescent();
+
+	auto t = duration<double>(steady_clock::now() - start).count();
+
+	uint64_t total = 0;
+	for (auto& nd : ring)
+		total += nd->num_hops();
+
+	cout << name << ": " << size_t(total/t) << " msgs/sec  [total: "
+		<< total << "]" << endl;
+}
+
+// --------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	size_t nThr = (argc > 1) ? stoul(argv[1]) : thread::hardware_concurrency();
+	size_t nToken = (argc > 2) ? stoul(argv[2]) : 1000;
+	size_t nHop = (argc > 3) ? stoul(argv[3]) : 10000;
+
+	nThr = max<size_t>(nThr, 2);
+
+	cout << "Passing " << nToken << " tokens " << nHop << " hops around "
+		<< nThr << " threads" << endl;
+
+	{
+		cooper::work_threads thrs(nThr);
+		run("work_threads", thrs, nToken, nHop);
+	}
+
+	{
+		cooper::core_threads thrs(nThr);
+		run("core_threads", thrs, nToken, nHop);
+	}
+
+	return 0;
+}
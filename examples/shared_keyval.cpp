@@ -68,6 +68,19 @@ private:
         return {};
     }
 
+    // Get the next entry after the key, or the first one if there's no key.
+    // The position is kept as a key, not an iterator, since other messages
+    // can modify the map between the chunks of a scan.
+    optional<std::pair<string, string>> handle_scan_next(optional<string>& after) {
+        assert(on_actor_thread());
+        auto p = after ? kv_.upper_bound(*after) : kv_.begin();
+        if (p == kv_.end())
+            return {};
+
+        after = p->first;
+        return { *p };
+    }
+
 public:
     /**
      * Create an empty key/value store.
@@ -98,6 +111,25 @@ public:
         return call(&shared_keyval::handle_get, this, key);
     }
 
+    /**
+     * Scans all the entries in the key/value store, in key order.
+     *
+     * The entries are streamed back in chunks rather than copied out all
+     * at once, so the store can handle other requests during a long scan.
+     * Entries that are added or removed while the scan is running may or
+     * may not be seen.
+     *
+     * @param window The most entries to buffer ahead of the reader.
+     * @return A stream of key/value pairs.
+     */
+    cooper::stream<std::pair<string, string>> scan(size_t window=64) {
+        cooper::stream_options opts;
+        opts.window = window;
+        return call_stream([this, after=optional<string>{}]() mutable {
+            return handle_scan_next(after);
+        }, opts);
+    }
+
 	/**
      * Wait for all pending operations to complete.
      * As a simple "trick" you can always wait for all pending operations to
@@ -128,6 +160,12 @@ int main()
     else {
         cout << "No value for key: " << k << endl;
     }
+
+    for (int i=0; i<10; ++i)
+        kv.set("key" + to_string(i), "val" + to_string(i));
+
+    for (const auto& [key, val] : kv.scan(4))
+        cout << "  " << key << ": " << val << endl;
     return 0;
 }
 
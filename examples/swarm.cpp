@@ -2,6 +2,12 @@
 //
 // This is an example of creating a large number of actors.
 //
+// The actors are chained together, each owning the next one. They are
+// released with a deferred delete, so when the head of the chain is
+// released, each one is destroyed in its own thread, which then queues the
+// destruction of the next. Tearing down the swarm doesn't require a round
+// trip to each of the actors.
+//
 // Copyright (c) 2023, Frank Pagliughi. All Rights Reserved.
 //
 
@@ -20,7 +26,7 @@ using namespace std::literals::chrono_literals;
 class swarmer : public cooper::actor
 {
 public:
-	using ptr_t = std::unique_ptr<swarmer>;
+	using ptr_t = cooper::actor_ptr<swarmer>;
 
 private:
     /** An identifier for this object */
@@ -34,14 +40,13 @@ public:
 	swarmer(swarmer&& other) : n_(other.n_), next_(std::move(other.next_)) {}
     ~swarmer() {
         cout << "[Shutting down " << n_ << "]" << endl;
-        flush();
     }
 
 	static ptr_t create(size_t n) {
-		return std::make_unique<swarmer>(n);
+		return cooper::make_actor<swarmer>(n);
 	}
 	static ptr_t create(size_t n, ptr_t next) {
-		return std::make_unique<swarmer>(n, std::move(next));
+		return cooper::make_actor<swarmer>(n, std::move(next));
 	}
 
 	size_t num() const { return n_; }
@@ -76,9 +81,13 @@ int main(int argc, char* argv[])
 
 	next->alert("Hi there!");
 
-	cooper::sys_work_threads::instance().flush();
+	// Wait for the alert to make its way through the whole swarm.
+	auto& thrs = cooper::sys_work_threads::instance();
+	thrs.wait_quiescent();
 
-    next.reset();
+	// Release the swarm, and wait for it to finish shutting down.
+	next.reset();
+	thrs.wait_quiescent();
 	return 0;
 }
 
@@ -43,9 +43,113 @@
 #define __cooper_actor_h
 
 #include "cooper/work_thread.h"
+#include "cooper/execution.h"
+#include "cooper/stream.h"
+#include <memory>
 
 namespace cooper {
 
+struct deferred_delete;
+class actor;
+class mobile_actor;
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A placement hint to put a new actor onto the same thread as another one.
+ *
+ * Actors that exchange a lot of messages are much cheaper to run on the
+ * same thread, where each message is a queue push without any cross-core
+ * handoff. Pass this to the constructor of the new actor, or to a
+ * @ref placement, like:
+ *
+ *     auto b = std::make_unique<my_actor>(colocate_with(*a));
+ */
+class colocate_with
+{
+	/** The thread of the other actor */
+	work_thread& thr_;
+
+public:
+	/**
+	 * Creates a hint to place a new actor with an existing one.
+	 * @param other The actor to share a thread with.
+	 */
+	explicit colocate_with(const actor& other);
+	/**
+	 * Creates a hint to place a new actor with a mobile one.
+	 * This is the thread that the other actor is on right now.
+	 * @param other The actor to share a thread with.
+	 */
+	explicit colocate_with(const mobile_actor& other);
+	/**
+	 * Gets the thread for the new actor.
+	 * @return The thread for the new actor.
+	 */
+	work_thread& get_thread() const { return thr_; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Scope-based placement of new actors onto a specific work thread.
+ *
+ * Normally, each new actor is assigned the next thread from the system
+ * collection of work threads. While an object of this class exists, any
+ * actor created by the current thread is placed onto the specified thread
+ * instead. This includes any actors created by the constructor of that
+ * actor, so a group of actors built together land on the same thread.
+ *
+ * Placements can be nested. The previous one is restored when the object
+ * goes out of scope.
+ */
+class placement
+{
+	/** The previous placement for the thread */
+	work_thread* prev_;
+
+	/** Gets the current placement for the calling thread */
+	static work_thread*& current() {
+		thread_local work_thread* thr = nullptr;
+		return thr;
+	}
+
+	// Non-copyable
+	placement(const placement&) =delete;
+	placement& operator=(const placement&) =delete;
+
+public:
+	/**
+	 * Places any actors created by this thread onto the specified thread,
+	 * until this object goes out of scope.
+	 * @param thr The thread for the new actors.
+	 */
+	explicit placement(work_thread& thr) : prev_(current()) {
+		current() = &thr;
+	}
+	/**
+	 * Places any actors created by this thread with another actor, until
+	 * this object goes out of scope.
+	 * @param hint The actor to share a thread with.
+	 */
+	explicit placement(const colocate_with& hint) : placement(hint.get_thread()) {}
+	/**
+	 * Restores the previous placement.
+	 */
+	~placement() { current() = prev_; }
+	/**
+	 * Gets the thread onto which the next actor created by the calling
+	 * thread should be placed.
+	 * @return The thread from the innermost placement in the calling
+	 *  	   thread, if any, otherwise the next one from the system
+	 *  	   collection of work threads.
+	 */
+	static work_thread& next_thread() {
+		auto thr = current();
+		return thr ? *thr : sys_work_threads::instance().next_thread();
+	}
+};
+
 /////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -56,7 +160,35 @@ class actor
 	/** The actor's thread */
 	work_thread& thr_;
 
+	/** The deleter needs to get to the actor's thread */
+	friend struct deferred_delete;
+	/** The placement hint needs to get to the actor's thread */
+	friend class colocate_with;
+
 protected:
+	/**
+	 * Gets the work thread that runs the actor.
+	 * @return The work thread that runs the actor.
+	 */
+	work_thread& get_thread() const { return thr_; }
+	/**
+	 * Gets the arena for the message that the actor is handling.
+	 * This is only available if the actor's thread was given one with
+	 * work_thread::use_arena(), and only while handling a message. It's
+	 * reset after each message, so it's only for temporary allocations.
+	 * @return The arena for the current message, or @em nullptr if there
+	 *  	   isn't one.
+	 */
+	arena* message_arena() const { return arena::current(); }
+	/**
+	 * Gets a scheduler for the actor's thread.
+	 * This can be used to build senders that complete in the actor's
+	 * context, such as: schedule(scheduler()) | then([this] { ... })
+	 * @return A scheduler for the actor's thread.
+	 */
+	work_thread_scheduler scheduler() const {
+		return work_thread_scheduler(thr_);
+	}
 	/**
 	 * Determines if the currently executing thread is the actor.
 	 * @return @em true if the current thread is the internal actor thread,
@@ -77,7 +209,7 @@ protected:
 	 */
 	template <class Func>
 	typename std::invoke_result_t<Func> call(Func&& f) {
-		return thr_.submit(std::forward<Func>(f)).get();
+		return detail::get_result(thr_.submit(std::forward<Func>(f)));
 	}
 	/**
 	 * Blocking call to wait for a task to execute in the internal thread.
@@ -93,7 +225,7 @@ protected:
 	 */
 	template <class Func, class... Args>
 	typename std::invoke_result_t<Func,Args...> call(Func&& f, Args&&... args) {
-		return thr_.submit(std::forward<Func>(f), std::forward<Args>(args)...).get();
+		return detail::get_result(thr_.submit(std::forward<Func>(f), std::forward<Args>(args)...));
 	}
 	/**
 	 * Sends a task to run in the thread asynchronously.
@@ -106,7 +238,7 @@ protected:
 	 * @throws Any exception thrown by the task.
 	 */
 	template <class Func>
-	void cast(Func&& f) { thr_.submit(std::forward<Func>(f)); }
+	void cast(Func&& f) { thr_.cast(std::forward<Func>(f)); }
 	/**
 	 * Sends a task to run in the thread asynchronously.
 	 * This is the same as @ref submit, but completely discards the return
@@ -119,19 +251,115 @@ protected:
 	 */
 	template <class Func, class... Args>
 	void cast(Func&& f, Args&&... args) {
-		thr_.submit(std::forward<Func>(f), std::forward<Args>(args)...);
+		thr_.cast(std::forward<Func>(f), std::forward<Args>(args)...);
+	}
+	/**
+	 * Starts a streaming reply from the actor.
+	 * The generator runs in the actor thread, producing a batch of items at
+	 * a time, with the actor handling its other messages in between. See
+	 * @ref stream for the flow control.
+	 * @param gen The generator. It returns a std::optional with the next
+	 *  		  item, or std::nullopt at the end of the stream.
+	 * @param opts The flow control parameters.
+	 * @return The stream for the client to read the items.
+	 */
+	template <class Gen>
+	auto call_stream(Gen gen, const stream_options& opts=stream_options{}) {
+		return make_stream(thr_, std::move(gen), opts);
 	}
 
 public:
-	actor() : thr_(sys_work_threads::instance().next_thread()) {}
+	/**
+	 * Creates an actor.
+	 * It is assigned to the thread from the current @ref placement, if
+	 * any, otherwise to the next thread in the system collection.
+	 */
+	actor() : thr_(placement::next_thread()) {}
+	/**
+	 * Creates an actor on a specific thread.
+	 * @param thr The thread for the actor.
+	 */
+	explicit actor(work_thread& thr) : thr_(thr) {}
+	/**
+	 * Creates an actor on the same thread as another one.
+	 * @param hint The actor to share a thread with.
+	 */
+	explicit actor(const colocate_with& hint) : thr_(hint.get_thread()) {}
 };
 
+inline colocate_with::colocate_with(const actor& other) : thr_(other.thr_) {}
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A deleter that destroys an actor asynchronously, in its own thread.
+ *
+ * Rather than deleting the object immediately, this queues the deletion
+ * to the actor's thread, behind any messages that are already pending for
+ * it. So the caller does not block, and there's no need for the actor to
+ * flush its queue in the destructor. Destroying a large graph of actors
+ * this way is a pipelined operation rather than a series of round trips to
+ * each of the actor threads.
+ *
+ * @par
+ * Since the destructor runs in the context of the actor's thread, it must
+ * @em not do a call() to the actor, as that would deadlock. It can,
+ * however, release other actors that it owns which use this deleter.
+ *
+ * This can be used with std::unique_ptr or std::shared_ptr for any type
+ * derived from @ref actor. See @ref actor_ptr and @ref make_actor.
+ */
+struct deferred_delete
+{
+	/**
+	 * Queues the actor to be deleted in its own thread.
+	 * If the thread was already shut down, the actor is deleted
+	 * immediately, in the context of the caller.
+	 * @param p Pointer to the actor to delete.
+	 */
+	template <typename T>
+	void operator()(T* p) const {
+		if (p)
+			static_cast<actor*>(p)->thr_.finalize([p]{ delete p; });
+	}
+};
+
+/**
+ * A unique pointer to an actor that destroys it asynchronously, in its
+ * own thread.
+ */
+template <typename T>
+using actor_ptr = std::unique_ptr<T, deferred_delete>;
+
+/**
+ * Creates an actor that is destroyed asynchronously, in its own thread.
+ * @param args The arguments for the actor's constructor.
+ * @return A unique pointer to the new actor.
+ */
+template <typename T, typename... Args>
+actor_ptr<T> make_actor(Args&&... args) {
+	return actor_ptr<T>(new T(std::forward<Args>(args)...));
+}
+
+/**
+ * Creates a shared actor that is destroyed asynchronously, in its own
+ * thread, when the last reference to it is released.
+ * @param args The arguments for the actor's constructor.
+ * @return A shared pointer to the new actor.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> make_shared_actor(Args&&... args) {
+	return std::shared_ptr<T>(new T(std::forward<Args>(args)...),
+							  deferred_delete{});
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 template <typename T>
 struct this_actor : actor
 {
 	using This = T;
+	using actor::actor;
 };
 
 /////////////////////////////////////////////////////////////////////////////
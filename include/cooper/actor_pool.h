@@ -0,0 +1,230 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file actor_pool.h
+/// Implementation of the class 'actor_pool'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_actor_pool_h
+#define __cooper_actor_pool_h
+
+#include "cooper/actor.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A pool of recycled actors of a single type.
+ *
+ * This is meant for short-lived actors, like ones that are created and
+ * destroyed for each request or session. Rather than allocating a new
+ * object each time, an actor that is released goes back to the pool to be
+ * handed out again.
+ *
+ * The pool keeps a separate free list for each work thread. When an actor
+ * is acquired, the thread is chosen with a round-robin counter that is
+ * local to the calling thread, so there's no contention on a shared
+ * counter, and a recycled actor from that thread's list is used if one is
+ * available. Otherwise a new one is created on that thread.
+ *
+ * When the pointer to an actor is released, the actor's reset() method is
+ * queued to run in its own thread, behind any pending messages, and then
+ * the actor is put back in the free list. So, like a @ref deferred_delete,
+ * the release never blocks the caller.
+ *
+ * @par
+ * The actor type must be default constructible, and must have a public
+ * method, void reset(), to return it to a newly-constructed state. It
+ * runs in the actor's thread.
+ *
+ * @param T The type of actor. It must derive from @ref actor.
+ */
+template <typename T>
+class actor_pool
+{
+	/** The free list of recycled actors for one work thread */
+	struct free_list {
+		std::mutex lock;
+		std::vector<T*> actors;
+	};
+
+	/** The state that is shared with the actors that are handed out */
+	struct state {
+		work_threads& thrs;
+		size_t maxFree;
+		std::vector<free_list> lists;
+		std::atomic<size_t> nCreated;
+		std::atomic<size_t> nRecycled;
+
+		state(work_threads& thrs, size_t maxFree)
+			: thrs(thrs), maxFree(maxFree), lists(thrs.size()),
+				nCreated(0), nRecycled(0) {}
+		~state() {
+			for (auto& lst : lists)
+				for (auto p : lst.actors)
+					delete p;
+		}
+		// Puts a reset actor into the free list for its thread, or deletes
+		// it if the list is full.
+		void put(size_t idx, T* p) {
+			auto& lst = lists[idx];
+			std::unique_lock<std::mutex> g(lst.lock);
+			if (lst.actors.size() < maxFree) {
+				lst.actors.push_back(p);
+				return;
+			}
+			g.unlock();
+			delete p;
+		}
+	};
+
+	/** The shared state of the pool */
+	std::shared_ptr<state> st_;
+
+public:
+	/**
+	 * A deleter that returns an actor to the pool.
+	 * This holds a reference to the pool state, so actors can be released
+	 * after the pool itself was destroyed.
+	 */
+	class releaser
+	{
+		std::shared_ptr<state> st_;
+		size_t idx_;
+
+	public:
+		releaser() : idx_(0) {}
+		releaser(std::shared_ptr<state> st, size_t idx)
+			: st_(std::move(st)), idx_(idx) {}
+		/**
+		 * Queues the actor to be reset and recycled in its own thread.
+		 * @param p Pointer to the actor to release.
+		 */
+		void operator()(T* p) const {
+			if (!p)
+				return;
+			st_->thrs[idx_].finalize([st=st_, idx=idx_, p] {
+				try {
+					p->reset();
+				}
+				catch (...) {
+					delete p;
+					return;
+				}
+				st->put(idx, p);
+			});
+		}
+	};
+
+	/** A pointer to an actor that returns it to the pool when released */
+	using ptr = std::unique_ptr<T, releaser>;
+
+	/**
+	 * Creates a pool for actors on the system work threads.
+	 * @param maxFree The maximum number of released actors to keep for
+	 *  			  each thread. Any beyond this are deleted.
+	 */
+	explicit actor_pool(size_t maxFree=1024)
+		: actor_pool(sys_work_threads::instance(), maxFree) {}
+	/**
+	 * Creates a pool for actors on a specific collection of work threads.
+	 * @param thrs The work threads for the actors.
+	 * @param maxFree The maximum number of released actors to keep for
+	 *  			  each thread. Any beyond this are deleted.
+	 */
+	actor_pool(work_threads& thrs, size_t maxFree)
+		: st_(std::make_shared<state>(thrs, maxFree)) {}
+	/**
+	 * Creates actors in advance and puts them in the free lists.
+	 * @param n The number of actors to create for each thread.
+	 */
+	void reserve(size_t n) {
+		for (size_t idx=0; idx<st_->lists.size(); ++idx) {
+			placement plc(st_->thrs[idx]);
+			for (size_t i=0; i<n; ++i) {
+				st_->put(idx, new T);
+				++st_->nCreated;
+			}
+		}
+	}
+	/**
+	 * Gets an actor from the pool.
+	 * This recycles a released actor, if one is available for the next
+	 * thread, otherwise it creates a new one.
+	 * @return A pointer to the actor that returns it to the pool when
+	 *  	   released.
+	 */
+	ptr acquire() {
+		size_t idx = st_->thrs.local_next_thread_idx();
+		auto& lst = st_->lists[idx];
+		{
+			std::lock_guard<std::mutex> g(lst.lock);
+			if (!lst.actors.empty()) {
+				T* p = lst.actors.back();
+				lst.actors.pop_back();
+				++st_->nRecycled;
+				return ptr(p, releaser(st_, idx));
+			}
+		}
+		placement plc(st_->thrs[idx]);
+		T* p = new T;
+		++st_->nCreated;
+		return ptr(p, releaser(st_, idx));
+	}
+	/**
+	 * Gets the number of actors that the pool has created.
+	 * @return The number of actors that the pool has created.
+	 */
+	size_t num_created() const { return st_->nCreated; }
+	/**
+	 * Gets the number of times that an actor was recycled from the pool.
+	 * @return The number of times that an actor was recycled.
+	 */
+	size_t num_recycled() const { return st_->nRecycled; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_actor_pool_h
@@ -0,0 +1,199 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file arena.h
+/// Implementation of the class 'arena'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#ifndef __cooper_arena_h
+#define __cooper_arena_h
+
+#include <memory_resource>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A monotonic memory arena that is released in bulk.
+ *
+ * Memory is handed out by bumping a pointer through a list of fixed-size
+ * blocks, and individual deallocations do nothing. All of it is released
+ * at once with reset(), which just rewinds the pointer to the start of the
+ * first block. The blocks are kept for re-use, so once the arena has grown
+ * to fit the largest message, it stops touching the system allocator.
+ * Requests larger than a block get a dedicated allocation, which is freed
+ * on the reset.
+ *
+ * This is a std::pmr::memory_resource, so it can be used directly with
+ * the pmr containers and strings, like:
+ * @code
+ *   std::pmr::vector<token> toks{arena::current()};
+ * @endcode
+ *
+ * @par
+ * A work thread can be given an arena with work_thread::use_arena(). It's
+ * then the current arena while each task runs, and is reset after each
+ * one. So it's for temporary allocations that die with the message. Any
+ * object created in it must be destroyed, or abandoned, by the end of the
+ * message, and nothing allocated from it can be kept in the actor's state.
+ *
+ * @par
+ * An arena is not thread-safe. It must only be used by one thread at a
+ * time.
+ */
+class arena : public std::pmr::memory_resource
+{
+	/** The size of each block */
+	size_t blockSize_;
+	/** The blocks, all of which are kept across resets */
+	std::vector<std::unique_ptr<char[]>> blocks_;
+	/** Dedicated allocations for large requests, freed on reset */
+	std::vector<std::unique_ptr<char[]>> large_;
+	/** The block that we're currently allocating from */
+	size_t curBlk_;
+	/** The next free byte in the current block */
+	char* ptr_;
+	/** The end of the current block */
+	char* end_;
+	/** The number of bytes handed out since the last reset */
+	size_t nUsed_;
+
+	friend class work_thread;
+
+	/**
+	 * Gets a reference to the arena for the calling thread.
+	 * This is set by the work thread around each task.
+	 */
+	static arena*& current_ref() {
+		thread_local arena* a = nullptr;
+		return a;
+	}
+	/**
+	 * Makes an arena current for the scope of a task, resetting it
+	 * afterward.
+	 */
+	class scope {
+		arena* a_;
+		arena* prev_;
+	public:
+		explicit scope(arena* a) : a_(a), prev_(current_ref()) {
+			current_ref() = a;
+		}
+		~scope() {
+			current_ref() = prev_;
+			if (a_)
+				a_->reset();
+		}
+	};
+
+	/** Moves to the next block, or gets a new one, to fit the request. */
+	void* next_block(size_t n, size_t align);
+
+	// Non-copyable
+	arena(const arena&) =delete;
+	arena& operator=(const arena&) =delete;
+
+protected:
+	/** Allocates memory from the arena */
+	void* do_allocate(size_t n, size_t align) override {
+		auto addr = (uintptr_t(ptr_) + (align - 1)) & ~uintptr_t(align - 1);
+		if (!ptr_ || addr + n > uintptr_t(end_))
+			return next_block(n, align);
+		ptr_ = reinterpret_cast<char*>(addr + n);
+		nUsed_ += n;
+		return reinterpret_cast<void*>(addr);
+	}
+	/** Individual deallocations do nothing */
+	void do_deallocate(void*, size_t, size_t) override {}
+	/** Arenas are only equal to themselves */
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+
+public:
+	/** The default size of the arena blocks */
+	static constexpr size_t DFLT_BLOCK_SIZE = 64*1024;
+	/**
+	 * Creates an arena.
+	 * No memory is allocated until it's first used.
+	 * @param blockSize The size of each block.
+	 */
+	explicit arena(size_t blockSize=DFLT_BLOCK_SIZE)
+		: blockSize_(blockSize), curBlk_(0), ptr_(nullptr), end_(nullptr), nUsed_(0) {}
+	/**
+	 * Gets the arena for the task that is running on the calling thread.
+	 * @return The arena for the current task, or @em nullptr if the
+	 *  	   calling thread isn't running a task on a work thread that has
+	 *  	   an arena.
+	 */
+	static arena* current() { return current_ref(); }
+	/**
+	 * Releases all the memory that was handed out since the last reset.
+	 * The blocks are kept for re-use.
+	 */
+	void reset();
+	/**
+	 * Releases all the memory, including the blocks.
+	 */
+	void release();
+	/**
+	 * Gets the size of the blocks.
+	 * @return The size of the blocks.
+	 */
+	size_t block_size() const { return blockSize_; }
+	/**
+	 * Gets the number of blocks that the arena is holding.
+	 * @return The number of blocks that the arena is holding.
+	 */
+	size_t num_blocks() const { return blocks_.size(); }
+	/**
+	 * Gets the number of bytes handed out since the last reset.
+	 * @return The number of bytes handed out since the last reset.
+	 */
+	size_t used() const { return nUsed_; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_arena_h
@@ -0,0 +1,379 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file codel.h
+/// CoDel-style load shedding for actors
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_codel_h
+#define __cooper_codel_h
+
+#include "cooper/actor.h"
+#include <chrono>
+#include <atomic>
+#include <cmath>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The configuration for CoDel load shedding.
+ */
+struct codel_options
+{
+	/**
+	 * The acceptable amount of time for a task to wait in the queue.
+	 * Short bursts above this are fine. It's only a problem if the
+	 * minimum delay stays above it for a full interval.
+	 */
+	std::chrono::nanoseconds target = std::chrono::milliseconds(5);
+	/**
+	 * The time over which the delay must stay above the target before
+	 * shedding starts. This should be on the order of the longest time
+	 * that a burst of tasks is expected to take to clear.
+	 */
+	std::chrono::nanoseconds interval = std::chrono::milliseconds(100);
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A CoDel (controlled delay) queue manager.
+ *
+ * Rather than limiting the length of a queue, which is hard to tune, this
+ * watches how long each task waited in the queue before running, its
+ * "sojourn time." If the minimum sojourn time stays above a target for a
+ * whole interval, the queue has a standing backlog, and not just a burst,
+ * and the manager enters the overloaded state. While overloaded, it
+ * signals the queue to shed tasks, at a rate that increases with the
+ * square root of the number of sheds, until the delay drops back below
+ * the target.
+ *
+ * The sojourn times are reported from the consumer thread. The overloaded
+ * state can be read from any thread.
+ */
+class codel
+{
+public:
+	/** The clock used to time the tasks */
+	using clock = std::chrono::steady_clock;
+	/** A point in time for the clock */
+	using time_point = clock::time_point;
+
+private:
+	/** The configuration */
+	codel_options opts_;
+	/** When the delay will have been above the target for an interval */
+	time_point firstAbove_;
+	/** When to shed the next task, while overloaded */
+	time_point shedNext_;
+	/** The number of tasks shed since entering the overloaded state */
+	uint32_t count_;
+	/** The shed count from the last time the overloaded state ended */
+	uint32_t lastCount_;
+	/** Whether the queue is overloaded */
+	std::atomic<bool> overloaded_;
+
+	/** Gets the time of the next shed after the one at time 't' */
+	time_point control_law(time_point t) const {
+		return t + std::chrono::duration_cast<clock::duration>(
+						opts_.interval / std::sqrt(double(count_)));
+	}
+	/**
+	 * Determines if the delay has been above the target for at least an
+	 * interval.
+	 */
+	bool over_target(std::chrono::nanoseconds sojourn, time_point now) {
+		if (sojourn < opts_.target) {
+			firstAbove_ = time_point{};
+			return false;
+		}
+		if (firstAbove_ == time_point{}) {
+			firstAbove_ = now + opts_.interval;
+			return false;
+		}
+		return now >= firstAbove_;
+	}
+	/**
+	 * Updates the state for a task coming off the queue.
+	 * @param enqueued The time the task was put into the queue.
+	 * @param now The time the task came off the queue.
+	 * @param sheddable Whether the task can be shed. If not, its delay
+	 *  				still counts, but it doesn't take up a shed slot.
+	 * @return @em true if the task should be shed, @em false if it should
+	 *  	   run.
+	 */
+	bool update(time_point enqueued, time_point now, bool sheddable) {
+		bool over = over_target(now - enqueued, now);
+
+		if (overloaded_) {
+			if (!over) {
+				overloaded_ = false;
+				lastCount_ = count_;
+			}
+			else if (sheddable && now >= shedNext_) {
+				++count_;
+				shedNext_ = control_law(shedNext_);
+				return true;
+			}
+			return false;
+		}
+
+		if (over) {
+			overloaded_ = true;
+			// If we were just overloaded, pick up at about the same rate
+			count_ = (lastCount_ > 2 && now - shedNext_ < 8*opts_.interval)
+						? lastCount_ - 2 : 1;
+			if (sheddable) {
+				shedNext_ = control_law(now);
+				return true;
+			}
+			// Leave the first shed for the next task that can take it
+			--count_;
+			shedNext_ = now;
+		}
+		return false;
+	}
+
+public:
+	/**
+	 * Creates a queue manager.
+	 * @param opts The configuration.
+	 */
+	explicit codel(const codel_options& opts=codel_options{})
+		: opts_(opts), count_(0), lastCount_(0), overloaded_(false) {}
+	/**
+	 * Gets the configuration.
+	 * @return The configuration.
+	 */
+	const codel_options& options() const { return opts_; }
+	/**
+	 * Determines if the queue is overloaded.
+	 * This can be called from any thread.
+	 * @return @em true if the queue is in the overloaded state, @em false
+	 *  	   if not.
+	 */
+	bool overloaded() const { return overloaded_; }
+	/**
+	 * Reports a task coming off the queue.
+	 * This must be called from the consumer thread.
+	 * @param enqueued The time the task was put into the queue.
+	 * @param now The time the task came off the queue.
+	 * @return @em true if the task should be shed, @em false if it should
+	 *  	   run.
+	 */
+	bool on_dequeue(time_point enqueued, time_point now=clock::now()) {
+		return update(enqueued, now, true);
+	}
+	/**
+	 * Reports a task that can't be shed coming off the queue.
+	 * Its delay counts toward the overloaded state, but it doesn't use up
+	 * a shed, so the shedding schedule isn't thrown off by tasks that
+	 * always run.
+	 * This must be called from the consumer thread.
+	 * @param enqueued The time the task was put into the queue.
+	 * @param now The time the task came off the queue.
+	 */
+	void on_dequeue_unsheddable(time_point enqueued, time_point now=clock::now()) {
+		update(enqueued, now, false);
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Base class for an actor that sheds load when its messages are delayed
+ * too long in the queue.
+ *
+ * Each message is stamped with the time it was queued, and the time it
+ * waited is reported to a @ref codel manager just before it runs. When
+ * the delay stays too high, the actor is overloaded and starts shedding
+ * its non-critical messages. New ones are rejected by cast(), and some of
+ * the ones already queued are discarded when they come off the queue.
+ * Normal behavior resumes when the delay recovers.
+ *
+ * Messages sent with cast_critical() or call() are never shed, although
+ * their delay still counts toward the overload state.
+ *
+ * @par
+ * Since the actor's messages share the queue of its work thread, the
+ * delay includes the time spent waiting behind the tasks of any other
+ * actors on that thread.
+ */
+class codel_actor : public actor
+{
+	/** The queue manager */
+	codel codel_;
+	/**
+	 * The time, in clock ticks, that a message from this actor last came
+	 * off the queue, or a probe was let through in the overloaded state.
+	 */
+	std::atomic<codel::clock::rep> lastSeen_;
+	/** The number of messages rejected when they were sent */
+	std::atomic<size_t> nRejected_;
+	/** The number of messages discarded when they came off the queue */
+	std::atomic<size_t> nShed_;
+
+	/** Gets the current time in clock ticks */
+	static codel::clock::rep now_ticks() {
+		return codel::clock::now().time_since_epoch().count();
+	}
+	/**
+	 * Determines if a new, non-critical, message should be let into the
+	 * queue.
+	 * If no messages have come off the queue for an interval, the
+	 * overloaded state might be stale, so one message is let through as a
+	 * probe.
+	 */
+	bool admit() {
+		if (!codel_.overloaded())
+			return true;
+
+		auto now = now_ticks();
+		auto last = lastSeen_.load();
+		auto interval = std::chrono::duration_cast<codel::clock::duration>(
+							codel_.options().interval).count();
+
+		if (now - last >= interval && lastSeen_.compare_exchange_strong(last, now))
+			return true;
+
+		++nRejected_;
+		return false;
+	}
+	/**
+	 * Reports a message coming off the queue.
+	 * @param enqueued The time the message was queued.
+	 * @param sheddable Whether the message can be shed.
+	 * @return @em true if the message should be shed, @em false if not.
+	 */
+	bool dequeue(codel::time_point enqueued, bool sheddable=true) {
+		auto now = codel::clock::now();
+		lastSeen_ = now.time_since_epoch().count();
+		if (!sheddable) {
+			codel_.on_dequeue_unsheddable(enqueued, now);
+			return false;
+		}
+		return codel_.on_dequeue(enqueued, now);
+	}
+
+protected:
+	/**
+	 * Sends a non-critical task to run in the actor thread asynchronously.
+	 * If the actor is overloaded, the task might be rejected now, or shed
+	 * before it runs.
+	 * @param f The function object for the thread to execute.
+	 * @return @em true if the task was queued, @em false if it was
+	 *  	   rejected.
+	 */
+	template <class Func>
+	bool cast(Func&& f) {
+		if (!admit())
+			return false;
+		actor::cast([this, t=codel::clock::now(), f=std::forward<Func>(f)]() mutable {
+			if (dequeue(t))
+				++nShed_;
+			else
+				f();
+		});
+		return true;
+	}
+	/**
+	 * Sends a critical task to run in the actor thread asynchronously.
+	 * This is never shed.
+	 * @param f The function object for the thread to execute.
+	 */
+	template <class Func>
+	void cast_critical(Func&& f) {
+		actor::cast([this, t=codel::clock::now(), f=std::forward<Func>(f)]() mutable {
+			dequeue(t, false);
+			f();
+		});
+	}
+	/**
+	 * Blocking call to wait for a task to execute in the actor thread.
+	 * This is never shed.
+	 * @param f The function object for the thread to execute.
+	 * @return The task's return value.
+	 * @throws Any exception thrown by the task.
+	 */
+	template <class Func>
+	typename std::invoke_result_t<Func> call(Func&& f) {
+		return actor::call([this, t=codel::clock::now(), f=std::forward<Func>(f)]() mutable {
+			dequeue(t, false);
+			return f();
+		});
+	}
+
+public:
+	/**
+	 * Creates an actor that sheds load.
+	 * @param opts The configuration for the load shedding.
+	 */
+	explicit codel_actor(const codel_options& opts=codel_options{})
+		: codel_(opts), lastSeen_(now_ticks()), nRejected_(0), nShed_(0) {}
+	/**
+	 * Creates an actor that sheds load on a specific thread.
+	 * @param thr The thread for the actor.
+	 * @param opts The configuration for the load shedding.
+	 */
+	codel_actor(work_thread& thr, const codel_options& opts=codel_options{})
+		: actor(thr), codel_(opts), lastSeen_(now_ticks()),
+			nRejected_(0), nShed_(0) {}
+	/**
+	 * Determines if the actor is currently overloaded.
+	 * @return @em true if the actor is overloaded, @em false if not.
+	 */
+	bool overloaded() const { return codel_.overloaded(); }
+	/**
+	 * Gets the number of messages that were rejected when sent.
+	 * @return The number of messages that were rejected when sent.
+	 */
+	size_t num_rejected() const { return nRejected_; }
+	/**
+	 * Gets the number of queued messages that were discarded.
+	 * @return The number of queued messages that were discarded.
+	 */
+	size_t num_shed() const { return nShed_; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_codel_h
@@ -0,0 +1,319 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file cohort.h
+/// Implementation of the class 'cohort'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_cohort_h
+#define __cooper_cohort_h
+
+#include "cooper/actor.h"
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Base class for a cohort of many small actors of the same type.
+ *
+ * When modeling huge numbers of tiny, identical actors, like counters or
+ * per-device state machines, the cost of dispatching each message to each
+ * actor swamps the work done by the handler. A cohort instead holds the
+ * state for all of its members in structure-of-arrays form, typically as
+ * a set of vectors indexed by the member ID, and handles the messages for
+ * the members in batches.
+ *
+ * Messages sent to the members are queued together, in a single mailbox
+ * for the cohort, and a single task is queued to the cohort's thread to
+ * drain it. That task hands the messages to on_batch() as parallel arrays
+ * of member IDs and messages, so the handler can run a tight loop over
+ * them that the compiler is able to vectorize.
+ *
+ * @par
+ * Each call to on_batch() contains at most one message for any member.
+ * When a member has several messages pending, they are split across
+ * successive calls, in the order they were sent. So the handler can
+ * update the state of all the members in the batch without any
+ * dependencies between the loop iterations, while the messages to each
+ * member are still seen in order.
+ *
+ * @par
+ * An exception thrown by on_batch() is discarded, the same as with any
+ * other task on a work thread, and the cohort moves on to the next batch.
+ *
+ * @param Msg The type of message sent to the members. This should be
+ *  		  small and cheap to copy, like a number or small struct.
+ */
+template <typename Msg>
+class cohort : public actor
+{
+public:
+	/** The type of message sent to the members */
+	using message_type = Msg;
+	/** The type used to identify the members */
+	using member_id = uint32_t;
+
+private:
+	/** Lock for the mailbox */
+	std::mutex lock_;
+	/** The member IDs of the queued messages */
+	std::vector<member_id> ids_;
+	/** The queued messages */
+	std::vector<message_type> msgs_;
+	/** Whether a task is queued to drain the mailbox */
+	bool scheduled_;
+
+	// The rest are only used in the actor thread.
+
+	/** The number of members in the cohort */
+	size_t nMember_;
+	/** The number of messages seen for each member in the current drain */
+	std::vector<uint32_t> seen_;
+	/** The member IDs of the messages being drained */
+	std::vector<member_id> drainIds_;
+	/** The messages being drained */
+	std::vector<message_type> drainMsgs_;
+	/** The member IDs in the current batch */
+	std::vector<member_id> batchIds_;
+	/** The messages in the current batch */
+	std::vector<message_type> batchMsgs_;
+	/** The batch number for each of the messages being drained */
+	std::vector<uint32_t> rank_;
+	/** The start of each batch in the batch arrays */
+	std::vector<size_t> batchStart_;
+	/** The next free slot in each batch, while laying them out */
+	std::vector<size_t> batchPos_;
+
+	/** Simple, scope-based lock guard */
+	using guard = std::lock_guard<std::mutex>;
+
+	/** Queues a task to drain the mailbox */
+	void schedule() {
+		try {
+			cast([this] { drain(); });
+		}
+		catch (...) {
+			guard g(lock_);
+			scheduled_ = false;
+			throw;
+		}
+	}
+	/**
+	 * Hands a batch to the derived class. An exception from the handler
+	 * is discarded, so the rest of the batches are still delivered, in
+	 * order.
+	 */
+	void run_batch(const member_id* ids, const message_type* msgs, size_t n) {
+		try {
+			on_batch(ids, msgs, n);
+		}
+		catch (...) {}
+	}
+	/**
+	 * Drains the mailbox, handing the messages to the derived class in
+	 * batches.
+	 * This runs in the actor thread.
+	 */
+	void drain() {
+		{
+			guard g(lock_);
+			ids_.swap(drainIds_);
+			msgs_.swap(drainMsgs_);
+			scheduled_ = false;
+		}
+
+		// Drop any messages for members that are out of range, which can
+		// only happen if they were sent to a bad ID, or the cohort shrank
+		// after they were sent.
+
+		size_t n = 0, nDrain = drainIds_.size();
+		for (size_t i=0; i<nDrain; ++i) {
+			if (drainIds_[i] >= nMember_)
+				continue;
+			if (n != i) {
+				drainIds_[n] = drainIds_[i];
+				drainMsgs_[n] = std::move(drainMsgs_[i]);
+			}
+			++n;
+		}
+		if (n != nDrain) {
+			drainIds_.erase(drainIds_.begin()+n, drainIds_.end());
+			drainMsgs_.erase(drainMsgs_.begin()+n, drainMsgs_.end());
+		}
+
+		if (n == 0)
+			return;
+
+		// Rank each message by how many earlier messages there were for
+		// the same member. The rank is the batch it goes into. Then lay
+		// the batches out with a stable counting sort.
+
+		if (seen_.size() < nMember_)
+			seen_.resize(nMember_, 0);
+
+		rank_.resize(n);
+		batchStart_.assign(1, 0);
+
+		for (size_t i=0; i<n; ++i) {
+			uint32_t k = seen_[drainIds_[i]]++;
+			if (k+1 == batchStart_.size())
+				batchStart_.push_back(0);
+			++batchStart_[k+1];
+			rank_[i] = k;
+		}
+		for (size_t i=0; i<n; ++i)
+			seen_[drainIds_[i]] = 0;
+
+		size_t nBatch = batchStart_.size() - 1;
+
+		if (nBatch == 1) {
+			run_batch(drainIds_.data(), drainMsgs_.data(), n);
+		}
+		else {
+			for (size_t k=1; k<=nBatch; ++k)
+				batchStart_[k] += batchStart_[k-1];
+
+			batchIds_.resize(n);
+			batchMsgs_.resize(n);
+
+			batchPos_.assign(batchStart_.begin(), batchStart_.end()-1);
+			for (size_t i=0; i<n; ++i) {
+				size_t j = batchPos_[rank_[i]]++;
+				batchIds_[j] = drainIds_[i];
+				batchMsgs_[j] = std::move(drainMsgs_[i]);
+			}
+
+			for (size_t k=0; k<nBatch; ++k) {
+				size_t b = batchStart_[k], e = batchStart_[k+1];
+				run_batch(batchIds_.data()+b, batchMsgs_.data()+b, e-b);
+			}
+		}
+
+		drainIds_.clear();
+		drainMsgs_.clear();
+	}
+
+protected:
+	/**
+	 * Handles a batch of messages for the members of the cohort.
+	 * This runs in the actor thread. The batch holds at most one message
+	 * for any member.
+	 * @param ids The IDs of the members that are receiving the messages.
+	 * @param msgs The messages, in parallel with the IDs.
+	 * @param n The number of messages in the batch.
+	 */
+	virtual void on_batch(const member_id* ids, const message_type* msgs,
+						  size_t n) =0;
+	/**
+	 * Sets the number of members in the cohort.
+	 * The derived class should call this whenever it resizes its state
+	 * arrays, in the actor thread, or in the constructor.
+	 * @param n The number of members in the cohort.
+	 */
+	void set_size(size_t n) { nMember_ = n; }
+
+public:
+	/**
+	 * Creates a cohort.
+	 * @param n The initial number of members in the cohort.
+	 */
+	explicit cohort(size_t n=0) : scheduled_(false), nMember_(n) {}
+	/**
+	 * Creates a cohort on a specific thread.
+	 * @param thr The thread for the cohort.
+	 * @param n The initial number of members in the cohort.
+	 */
+	cohort(work_thread& thr, size_t n=0)
+		: actor(thr), scheduled_(false), nMember_(n) {}
+	/**
+	 * Gets the number of members in the cohort.
+	 * This must only be called from the actor thread.
+	 * @return The number of members in the cohort.
+	 */
+	size_t size() const { return nMember_; }
+	/**
+	 * Sends a message to a member of the cohort.
+	 * @param id The ID of the member. This must be less than the size of
+	 *  		 the cohort by the time the message is handled, or the
+	 *  		 message is dropped.
+	 * @param msg The message.
+	 */
+	void send(member_id id, message_type msg) {
+		bool sched;
+		{
+			guard g(lock_);
+			ids_.push_back(id);
+			msgs_.push_back(std::move(msg));
+			sched = !scheduled_;
+			scheduled_ = true;
+		}
+		if (sched)
+			schedule();
+	}
+	/**
+	 * Sends a number of messages to the members of the cohort, all at
+	 * once.
+	 * @param ids The IDs of the members.
+	 * @param msgs The messages, in parallel with the IDs.
+	 * @param n The number of messages.
+	 */
+	void send(const member_id* ids, const message_type* msgs, size_t n) {
+		if (n == 0)
+			return;
+		bool sched;
+		{
+			guard g(lock_);
+			ids_.insert(ids_.end(), ids, ids+n);
+			msgs_.insert(msgs_.end(), msgs, msgs+n);
+			sched = !scheduled_;
+			scheduled_ = true;
+		}
+		if (sched)
+			schedule();
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_cohort_h
@@ -0,0 +1,424 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file colocate.h
+/// Implementation of the classes 'mobile_actor' and 'colocator'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_colocate_h
+#define __cooper_colocate_h
+
+#include "cooper/actor.h"
+#include "cooper/timer.h"
+#include "cooper/sync.h"
+#include <unordered_set>
+#include <unordered_map>
+#include <functional>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Parameters for re-placing actors by their message traffic.
+ */
+struct colocate_options
+{
+	/**
+	 * The least number of messages that an actor must exchange with the
+	 * actors on another thread, beyond what it exchanges with the ones on
+	 * its own thread, before it's moved there.
+	 */
+	uint64_t min_messages = 100;
+	/**
+	 * How many times more traffic an actor must have with another thread
+	 * than with its own before it moves. This keeps actors that talk to
+	 * several threads about equally from bouncing between them.
+	 */
+	double gain = 2.0;
+	/**
+	 * The most actors that a thread can hold, as a multiple of the average
+	 * number per thread. This keeps the whole group from piling onto one
+	 * thread.
+	 */
+	double balance = 1.25;
+	/**
+	 * The most actors moved in one pass.
+	 */
+	size_t max_moves = 64;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Re-places actors to put the ones that talk to each other on the same
+ * thread.
+ *
+ * Each @ref mobile_actor that registers with a colocator counts the
+ * messages that it sends to the other registered actors. On each pass,
+ * the colocator adds up the traffic between every pair of actors, in both
+ * directions, and moves an actor to another thread when it exchanges a lot
+ * more messages with the actors there than with the ones on its own
+ * thread. Passes run periodically from a timer, or on demand with
+ * rebalance().
+ *
+ * The counts are halved after each pass, so the placement follows changes
+ * in the traffic pattern, but doesn't react to short bursts. Moves are
+ * limited by the balance option, so that a tightly-connected group of
+ * actors is spread over no fewer threads than it needs.
+ */
+class colocator
+{
+	/** Lock for the collection of actors */
+	std::mutex lock_;
+	/** The registered actors */
+	std::unordered_set<mobile_actor*> actors_;
+	/** The parameters */
+	colocate_options opts_;
+	/** The most threads that the actors were seen on */
+	size_t nThread_;
+	/** The number of passes */
+	std::atomic<uint64_t> nPass_;
+	/** The number of moves */
+	std::atomic<uint64_t> nMove_;
+	/** The timer to run the passes */
+	periodic_timer tmr_;
+
+	friend class mobile_actor;
+
+	/** Registers an actor */
+	void add(mobile_actor* act);
+	/** Unregisters an actor */
+	void remove(mobile_actor* act);
+
+	// Non-copyable
+	colocator(const colocator&) =delete;
+	colocator& operator=(const colocator&) =delete;
+
+public:
+	/**
+	 * Creates a colocator that only re-places actors when rebalance() is
+	 * called.
+	 * @param opts The parameters.
+	 */
+	explicit colocator(const colocate_options& opts=colocate_options{});
+	/**
+	 * Creates a colocator that periodically re-places actors.
+	 * @param interval The time between passes.
+	 * @param opts The parameters.
+	 */
+	explicit colocator(const std::chrono::nanoseconds& interval,
+					   const colocate_options& opts=colocate_options{});
+	/**
+	 * Stops the passes.
+	 * Any actors using this colocator must be destroyed first.
+	 */
+	~colocator();
+	/**
+	 * Runs a pass over the message traffic, moving any actors that would
+	 * do better on another thread.
+	 * @return The number of actors that were moved.
+	 */
+	size_t rebalance();
+	/**
+	 * Gets the number of registered actors.
+	 * @return The number of registered actors.
+	 */
+	size_t size();
+	/**
+	 * Gets the number of passes run so far.
+	 * @return The number of passes run so far.
+	 */
+	uint64_t num_passes() const { return nPass_; }
+	/**
+	 * Gets the total number of actors moved.
+	 * @return The total number of actors moved.
+	 */
+	uint64_t num_moves() const { return nMove_; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Base class for actors that can move between threads.
+ *
+ * A regular @ref actor is bound to its thread for life. This one has its
+ * own mailbox, drained by a task on whichever thread it's on at the time,
+ * so it can be moved with move_to(), or by a @ref colocator, at any point,
+ * even with messages pending. The messages are always handled in the order
+ * they were sent, and never on two threads at once. A move takes effect
+ * after the message being handled, if any.
+ *
+ * The price is an extra lock and queue on each message, so this is meant
+ * for actors whose best placement isn't known until they're running.
+ *
+ * @par
+ * Since the thread can change between messages, the actor must not hold
+ * anything tied to a particular thread, like another actor that it expects
+ * to share a thread with.
+ *
+ * @par
+ * A derived class must call stop() at the start of its destructor, unless
+ * it's sure that no messages can be pending or running by then. Otherwise
+ * a handler could run against members that were already destroyed. In a
+ * debug build, the base destructor asserts that this was done. A handler
+ * can also destroy its own actor.
+ *
+ * @par
+ * If the drain task is dropped from the thread's queue, such as by
+ * work_thread::discard(), the messages in the mailbox are discarded with
+ * it. Any callers waiting on them get a "broken promise" error.
+ */
+class mobile_actor
+{
+	/** Lock for the mailbox and thread */
+	sync::mutex lock_;
+	/** Signaled when the mailbox is drained */
+	sync::condition_variable cond_;
+	/** The current thread. Changed only under the lock. */
+	std::atomic<work_thread*> thr_;
+	/** The queued messages */
+	std::deque<func_wrapper> mbox_;
+	/** Whether a task is queued to drain the mailbox */
+	bool scheduled_;
+	/** Whether the actor was stopped */
+	bool stopped_;
+	/**
+	 * Set by stop() when a handler destroys its own actor, so the drain
+	 * knows not to touch it again. Only used in the actor's thread.
+	 */
+	bool* dead_;
+	/** The colocator, if any */
+	colocator* col_;
+	/** The number of times the actor moved */
+	std::atomic<uint64_t> nMove_;
+
+	/** Lock for the traffic counts */
+	std::mutex trafficLock_;
+	/** The messages sent to other actors in the same colocator */
+	std::unordered_map<mobile_actor*, uint64_t> sent_;
+
+	/** The most messages handled before yielding the thread */
+	static constexpr size_t MAX_BATCH = 64;
+
+	using guard = std::lock_guard<sync::mutex>;
+	using unique_guard = std::unique_lock<sync::mutex>;
+
+	friend class colocator;
+	friend class colocate_with;
+
+	/** The actor handling a message on the calling thread, if any */
+	static mobile_actor*& current() {
+		thread_local mobile_actor* act = nullptr;
+		return act;
+	}
+
+	/**
+	 * Move-only guard for a queued drain task. If the task is dropped
+	 * without running, such as when the thread's queue is discarded, it
+	 * cancels the drain.
+	 */
+	struct drain_task {
+		mobile_actor* act;
+
+		explicit drain_task(mobile_actor* act) : act(act) {}
+		drain_task(drain_task&& other) : act(other.act) { other.act = nullptr; }
+		~drain_task() {
+			if (act)
+				act->cancel_drain();
+		}
+	};
+
+	/** Queues a message, and a task to drain the mailbox if needed */
+	void send(func_wrapper f);
+	/** Queues a task to drain the mailbox to the current thread */
+	void schedule();
+	/**
+	 * Clears the schedule after a drain task was dropped, discarding the
+	 * queued messages, since there's no longer a task to handle them.
+	 */
+	void cancel_drain();
+	/** Handles the queued messages. This runs in the thread 'thr'. */
+	void drain(work_thread* thr);
+	/** Takes the traffic counts, halving the ones kept for next time */
+	std::unordered_map<mobile_actor*, uint64_t> take_traffic();
+
+	// Non-copyable
+	mobile_actor(const mobile_actor&) =delete;
+	mobile_actor& operator=(const mobile_actor&) =delete;
+
+protected:
+	/**
+	 * Gets the work thread that runs the actor.
+	 * This can change between messages.
+	 * @return The work thread that runs the actor.
+	 */
+	work_thread& get_thread() const { return *thr_.load(); }
+	/**
+	 * Determines if the currently executing thread is the actor.
+	 * @return @em true if the current thread is the actor's thread, @em
+	 *  	   false if not.
+	 */
+	bool on_actor_thread() const {
+		return std::this_thread::get_id() == thr_.load()->get_id();
+	}
+	/**
+	 * Blocking call to wait for a task to execute in the actor.
+	 * @param f The function object for the actor to execute
+	 * @return The task's return value.
+	 * @throws Any exception thrown by the task.
+	 */
+	template <class Func>
+	typename std::invoke_result_t<Func> call(Func f) {
+		using result_type = typename std::invoke_result_t<Func>;
+		std::packaged_task<result_type()> task(std::move(f));
+		auto fut = task.get_future();
+		send(std::move(task));
+		return detail::get_result(std::move(fut));
+	}
+	/**
+	 * Blocking call to wait for a task to execute in the actor.
+	 * @param f The function object for the actor to execute
+	 * @param args The arguments to the function.
+	 * @return The task's return value.
+	 * @throws Any exception thrown by the task.
+	 */
+	template <class Func, class... Args>
+	typename std::invoke_result_t<Func,Args...> call(Func&& f, Args&&... args) {
+		return call(std::bind(std::forward<Func>(f), std::forward<Args>(args)...));
+	}
+	/**
+	 * Sends a task to run in the actor asynchronously.
+	 * If the task throws an exception, it is ignored.
+	 * @param f The function object for the actor to execute
+	 */
+	template <class Func>
+	void cast(Func f) { send(std::move(f)); }
+	/**
+	 * Sends a task to run in the actor asynchronously.
+	 * @param f The function object for the actor to execute
+	 * @param args The arguments to the function.
+	 */
+	template <class Func, class... Args>
+	void cast(Func&& f, Args&&... args) {
+		cast(std::bind(std::forward<Func>(f), std::forward<Args>(args)...));
+	}
+	/**
+	 * Stops the actor.
+	 * This unregisters it from its colocator, and discards any queued
+	 * messages. Unless called from one of the actor's own handlers, it
+	 * then waits for the message being handled, if any. After this, any
+	 * message sent to the actor throws @ref queue_closed.
+	 * @par
+	 * A derived class must call this at the start of its destructor. It's
+	 * safe to call more than once.
+	 */
+	void stop();
+
+public:
+	/**
+	 * Creates an actor.
+	 * It is assigned to the thread from the current @ref placement, if
+	 * any, otherwise to the next thread in the system collection.
+	 */
+	mobile_actor() : mobile_actor(placement::next_thread()) {}
+	/**
+	 * Creates an actor on a specific thread.
+	 * @param thr The thread for the actor.
+	 */
+	explicit mobile_actor(work_thread& thr);
+	/**
+	 * Creates an actor on the same thread as another one.
+	 * @param hint The actor to share a thread with.
+	 */
+	explicit mobile_actor(const colocate_with& hint)
+		: mobile_actor(hint.get_thread()) {}
+	/**
+	 * Creates an actor that is re-placed by a colocator.
+	 * @param col The colocator for the actor.
+	 */
+	explicit mobile_actor(colocator& col)
+		: mobile_actor(col, placement::next_thread()) {}
+	/**
+	 * Creates an actor on a specific thread, that is re-placed by a
+	 * colocator.
+	 * @param col The colocator for the actor.
+	 * @param thr The initial thread for the actor.
+	 */
+	mobile_actor(colocator& col, work_thread& thr);
+	/**
+	 * Creates an actor that is re-placed by a colocator, starting on the
+	 * same thread as another one.
+	 * @param col The colocator for the actor.
+	 * @param hint The actor to share a thread with.
+	 */
+	mobile_actor(colocator& col, const colocate_with& hint)
+		: mobile_actor(col, hint.get_thread()) {}
+	/**
+	 * Destroys the actor.
+	 * This calls stop(), but by now the derived part of the actor is
+	 * gone, so the derived class needs to call it first.
+	 */
+	virtual ~mobile_actor();
+	/**
+	 * Moves the actor to another thread.
+	 * This can be called from any thread, including the actor's own. Any
+	 * messages still queued are handled on the new thread.
+	 * @param thr The new thread for the actor.
+	 */
+	void move_to(work_thread& thr);
+	/**
+	 * Gets the number of times the actor moved to another thread.
+	 * @return The number of times the actor moved to another thread.
+	 */
+	uint64_t num_moves() const { return nMove_; }
+};
+
+inline colocate_with::colocate_with(const mobile_actor& other)
+	: thr_(*other.thr_.load()) {}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_colocate_h
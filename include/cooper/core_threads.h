@@ -0,0 +1,289 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file core_threads.h
+/// Implementation of the class 'core_threads'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_core_threads_h
+#define __cooper_core_threads_h
+
+#include "cooper/work_thread.h"
+#include "cooper/spsc_queue.h"
+#include <condition_variable>
+#include <memory>
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Parameters for a set of thread-per-core work threads.
+ */
+struct core_options
+{
+	/**
+	 * The capacity of the queue between each pair of threads. Messages
+	 * beyond this go to a locked overflow list for the pair.
+	 */
+	size_t ring_capacity = 256;
+	/**
+	 * The most tasks that a thread takes from one queue before moving on
+	 * to the next.
+	 */
+	size_t batch = 64;
+	/**
+	 * Whether to pin each thread to its own core. This is only supported
+	 * on Linux, and is ignored elsewhere.
+	 */
+	bool pin = true;
+};
+
+#if !defined(COOPER_SINGLE_THREADED)
+
+namespace detail {
+
+/**
+ * The mesh of queues that connects a set of @ref core_threads.
+ *
+ * There's a single-producer, single-consumer queue from each thread to
+ * every other thread, including itself. Only a task running on thread @em
+ * i pushes into the queues in row @em i, and only thread @em j pops from
+ * the ones in column @em j, so a message between two threads never
+ * contends with any other sender.
+ *
+ * When a queue is full, the sender puts the extra messages in a locked
+ * overflow list for the pair, and keeps using it until the receiver has
+ * taken them. The receiver only takes them once it has emptied the queue,
+ * so the messages from one thread to another are never reordered. Since
+ * it's the receiver that drains the list, a sender that blocks after a
+ * burst of messages, like for an actor call(), can't hold them back.
+ *
+ * Each thread polls its inbound queues in turn, then its regular queue
+ * for tasks from outside the mesh. When there's nothing to do it spins
+ * briefly and then parks until a sender wakes it.
+ */
+class core_mesh
+{
+	/** The state for each thread */
+	struct alignas(64) core {
+		/** The work thread */
+		work_thread* thr = nullptr;
+		/** Whether the thread is parked, waiting for work */
+		std::atomic<bool> sleeping { false };
+		/** Whether the thread was closed to new messages */
+		std::atomic<bool> closed { false };
+		/** Lock for parking */
+		std::mutex lock;
+		/** Signaled to wake the thread */
+		std::condition_variable cond;
+
+		// The rest is only written by the thread itself
+
+		/** The number of messages sent through the mesh */
+		std::atomic<uint64_t> nSent { 0 };
+		/** The number of messages that went to the overflow lists */
+		std::atomic<uint64_t> nOverflowed { 0 };
+	};
+
+	/** The connection from one thread to another */
+	struct alignas(64) link {
+		/** The queue */
+		spsc_queue<func_wrapper> ring;
+		/** Whether the sender is in the middle of sending a message */
+		std::atomic<bool> sending { false };
+		/** The number of messages in the overflow list */
+		std::atomic<size_t> nOverflow { 0 };
+		/** Lock for the overflow list */
+		std::mutex lock;
+		/** Messages that didn't fit in the queue */
+		std::deque<func_wrapper> overflow;
+
+		explicit link(size_t cap) : ring(cap) {}
+	};
+
+	/** The number of threads */
+	size_t n_;
+	/** The most tasks taken from one queue at a time */
+	size_t batch_;
+	/** The connections, indexed as [from*n + to] */
+	std::vector<std::unique_ptr<link>> links_;
+	/** The state for each thread */
+	std::unique_ptr<core[]> cores_;
+
+	/** Gets the connection between two threads */
+	link& get_link(size_t from, size_t to) {
+		return *links_[from*n_ + to];
+	}
+	/**
+	 * Determines if any inbound connection for a thread has messages, or
+	 * a message on the way.
+	 */
+	bool has_inbound(size_t me);
+	/** Determines if a thread has anything to do */
+	bool has_work(size_t me);
+	/**
+	 * Runs the messages from one inbound connection.
+	 * @return The number of messages that were run.
+	 */
+	size_t run_link(size_t from, size_t me);
+	/** Parks a thread until it's woken */
+	void park(size_t me);
+	/** Runs a task in a thread, and counts it as completed */
+	static void run_task(work_thread* thr, func_wrapper& task);
+
+public:
+	/**
+	 * Creates the mesh for a set of threads.
+	 * @param thrs The threads.
+	 * @param opts The parameters.
+	 */
+	core_mesh(work_threads& thrs, const core_options& opts);
+	/**
+	 * Sends a message from one thread in the mesh to another.
+	 * This must be called from thread @em from.
+	 * @param from The index of the sending thread.
+	 * @param to The index of the receiving thread.
+	 * @param task The message.
+	 * @throws queue_closed if the receiving thread was closed.
+	 */
+	void send(size_t from, size_t to, func_wrapper&& task);
+	/**
+	 * Runs the polling loop for a thread until it's closed and drained.
+	 * @param me The index of the thread.
+	 */
+	void run(size_t me);
+	/**
+	 * Marks a thread as closed to new messages from the mesh.
+	 * @param i The index of the thread.
+	 */
+	void close(size_t i) { cores_[i].closed.store(true); }
+	/**
+	 * Wakes a thread if it's parked.
+	 * @param i The index of the thread.
+	 */
+	void wake(size_t i);
+	/**
+	 * Gets the total number of messages sent through the mesh.
+	 * @return The total number of messages sent through the mesh.
+	 */
+	uint64_t num_sent() const;
+	/**
+	 * Gets the number of messages that found their queue full.
+	 * @return The number of messages that found their queue full.
+	 */
+	uint64_t num_overflowed() const;
+};
+
+}
+
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A set of thread-per-core work threads, connected by a mesh of
+ * single-producer, single-consumer queues.
+ *
+ * This is a shared-nothing variant of @ref work_threads, for the highest
+ * message throughput. There's one thread per core, each optionally pinned
+ * to its core, and a dedicated lock-free queue from every thread to every
+ * other one. A message sent by a task running on one of the threads to
+ * another one, such as a cast from one actor to another, goes through the
+ * queue for that pair, so it never contends with any other sender. The
+ * receiver polls its queues in batches. Tasks sent from outside the set
+ * still go through each thread's regular queue.
+ *
+ * Actors are placed on the threads as usual, with an explicit thread or a
+ * @ref placement, and never move.
+ *
+ * @par
+ * A thread that is idle spins briefly before it parks, so a mostly idle
+ * set costs little CPU, but the first message after a quiet period pays
+ * for a wake-up. As with any collection of threads that message each
+ * other, call wait_quiescent() before shutting it down.
+ *
+ * @par
+ * In the single-threaded build, this is just a regular set of threads.
+ */
+class core_threads : public work_threads
+{
+#if !defined(COOPER_SINGLE_THREADED)
+	/** The mesh */
+	std::unique_ptr<detail::core_mesh> mesh_;
+#endif
+
+public:
+	/**
+	 * Creates a set with one thread per core.
+	 * @param opts The parameters.
+	 */
+	explicit core_threads(const core_options& opts=core_options{})
+		: core_threads(std::thread::hardware_concurrency(), opts) {}
+	/**
+	 * Creates a set with the specified number of threads.
+	 * @param n The number of threads.
+	 * @param opts The parameters.
+	 */
+	core_threads(size_t n, const core_options& opts=core_options{});
+	/**
+	 * Destroys the set, draining and stopping all the threads.
+	 */
+	~core_threads();
+	/**
+	 * Gets the total number of messages sent between the threads through
+	 * the mesh.
+	 * @return The number of messages sent through the mesh.
+	 */
+	uint64_t num_mesh_sends() const;
+	/**
+	 * Gets the number of messages that found the queue to their receiver
+	 * full, and went to the overflow list.
+	 * @return The number of messages held for a full queue.
+	 */
+	uint64_t num_overflows() const;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_core_threads_h
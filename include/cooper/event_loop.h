@@ -0,0 +1,223 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file event_loop.h
+/// Implementation of the class 'event_loop'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef __cooper_event_loop_h
+#define __cooper_event_loop_h
+
+#if defined(COOPER_SINGLE_THREADED)
+
+#include <thread>
+#include <vector>
+#include <chrono>
+#include "cooper/exception.h"
+
+namespace cooper {
+
+class work_thread;
+class timer;
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The event loop for the single-threaded build.
+ *
+ * When the library is built with COOPER_SINGLE_THREADED defined, work
+ * threads and timers don't create any OS threads. Instead they register
+ * with this singleton, and their tasks and callbacks all run in the one
+ * thread that runs the loop. Tasks are taken from the work threads
+ * round-robin, one at a time, and a timer fires in between tasks when it
+ * comes due. Each work thread still runs its own tasks one at a time, in
+ * order, so actors see the same guarantees that they get from real
+ * threads.
+ *
+ * @par
+ * The application would normally call run() from its main thread after
+ * setting up its actors, but it rarely has to. Any call that blocks, like
+ * an actor's call(), or flushing or shutting down a work thread, runs the
+ * loop in the calling thread until it can complete. A task that is
+ * running is never re-entered, so if a task makes a blocking call into its
+ * own work thread, the loop runs out of work and the call throws a
+ * @ref would_block exception rather than hang forever.
+ *
+ * @par
+ * None of this is thread-safe. The loop, and all of the work threads,
+ * timers and actors, must only be used from a single thread.
+ */
+class event_loop
+{
+	/** The clock for the timers */
+	using clock = std::chrono::steady_clock;
+	/** The ID of the thread that created the loop */
+	std::thread::id id_;
+	/** The registered work threads */
+	std::vector<work_thread*> thrs_;
+	/** The index of the next work thread to check for a task */
+	size_t next_;
+	/** The running timers */
+	std::vector<timer*> timers_;
+
+	event_loop() : id_(std::this_thread::get_id()), next_(0) {}
+
+	// Non-copyable
+	event_loop(const event_loop&) =delete;
+	event_loop& operator=(const event_loop&) =delete;
+
+	/** Gets the running timer with the earliest deadline, if any */
+	timer* next_timer() const;
+
+public:
+	/**
+	 * Gets a reference to the singleton event loop.
+	 * @return A reference to the singleton event loop.
+	 */
+	static event_loop& instance();
+	/**
+	 * Gets the ID of the thread that runs the loop.
+	 * This is the thread that first used the loop, and is what each of the
+	 * work threads reports as its ID.
+	 * @return The ID of the thread that runs the loop.
+	 */
+	std::thread::id get_id() const { return id_; }
+	/**
+	 * Registers a work thread with the loop.
+	 * @param thr The work thread.
+	 */
+	void add(work_thread* thr);
+	/**
+	 * Unregisters a work thread.
+	 * @param thr The work thread.
+	 */
+	void remove(work_thread* thr);
+	/**
+	 * Registers a running timer with the loop.
+	 * @param tmr The timer.
+	 */
+	void add(timer* tmr);
+	/**
+	 * Unregisters a timer.
+	 * @param tmr The timer.
+	 */
+	void remove(timer* tmr);
+	/**
+	 * Runs one task, or fires one timer that is due, without blocking.
+	 * @return @em true if anything ran, @em false if there was nothing
+	 *  	   ready to run.
+	 */
+	bool poll_one();
+	/**
+	 * Runs all the tasks and timers that are ready, without blocking.
+	 * This includes any tasks queued by the ones that it runs.
+	 * @return The number of tasks and timers that ran.
+	 */
+	size_t poll();
+	/**
+	 * Runs one task or timer, waiting up to an absolute time point for a
+	 * timer to come due if there are no tasks ready.
+	 * @param absTime The absolute time to wait to before timing out.
+	 * @return @em true if anything ran, @em false if there was nothing to
+	 *  	   run before the timeout.
+	 */
+	bool run_one_until(const clock::time_point& absTime);
+	/**
+	 * Runs one task or timer, waiting for a timer to come due if there are
+	 * no tasks ready.
+	 * @return @em true if anything ran, @em false if there are no tasks
+	 *  	   ready and no running timers.
+	 */
+	bool run_one() { return run_one_until(clock::time_point::max()); }
+	/**
+	 * Runs the loop until there are no tasks left and no running timers.
+	 * Note that this won't return while any periodic timer is running.
+	 * @return The number of tasks and timers that ran.
+	 */
+	size_t run();
+	/**
+	 * Runs the loop until a condition is met.
+	 * @param pred The condition.
+	 * @return @em true if the condition was met, @em false if the loop ran
+	 *  	   out of work first.
+	 */
+	template <class Predicate>
+	bool run_until(Predicate pred) {
+		while (!pred()) {
+			if (!run_one())
+				return pred();
+		}
+		return true;
+	}
+	/**
+	 * Runs the loop until a condition is met, or an absolute time point.
+	 * @param pred The condition.
+	 * @param absTime The absolute time to run to before timing out.
+	 * @return @em true if the condition was met, @em false if the loop ran
+	 *  	   out of work or timed out first.
+	 */
+	template <class Predicate>
+	bool run_until(Predicate pred, const clock::time_point& absTime) {
+		while (!pred()) {
+			if (!run_one_until(absTime))
+				return pred();
+		}
+		return true;
+	}
+	/**
+	 * Runs the loop until a condition is met, throwing if it can't be.
+	 * This is what the blocking calls use in place of waiting on another
+	 * thread.
+	 * @param pred The condition.
+	 * @throws would_block if the loop ran out of work before the condition
+	 *  	   was met.
+	 */
+	template <class Predicate>
+	void wait(Predicate pred) {
+		if (!run_until(std::move(pred)))
+			throw would_block();
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// COOPER_SINGLE_THREADED
+#endif		// __cooper_event_loop_h
@@ -0,0 +1,773 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file execution.h
+/// Sender and receiver scheduling on work threads
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_execution_h
+#define __cooper_execution_h
+
+#include "cooper/work_thread.h"
+#include <tuple>
+#include <variant>
+#include <optional>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+// This is a small, self-contained set of senders and receivers, in the
+// style of the C++ P2300 proposal (std::execution), for running work on
+// cooper's threads.
+//
+// A sender describes some work that will complete, later, with a value,
+// an error, or by being stopped. It doesn't do anything until it is
+// connected to a receiver, which gets the completion, and the resulting
+// operation is started.
+//
+// A receiver is any object with the member functions:
+//     void set_value(Vs&&... vals);	// zero or one value
+//     void set_error(std::exception_ptr);
+//     void set_stopped();
+//
+// A sender is any object with a 'value_type', which is void if it
+// completes with no value, and a connect(receiver) member function that
+// returns an operation with a start() member function. The operation
+// must stay in place from the time it is started until it completes, but
+// it can be moved before that.
+//
+// Work is put onto a thread with schedule(), which completes in that
+// thread. The algorithms, like then() and when_all(), run inline, in
+// whichever thread the work completes, so a chain of them runs entirely
+// in the scheduled thread. Nothing here creates a std::future, and the
+// only allocation is for the task that is queued to the thread.
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+// Internal helpers
+
+namespace detail {
+
+/**
+ * Calls a function with the values from a completion, and sends the
+ * result to a receiver. If the function throws, the exception is sent as
+ * an error.
+ */
+template <class R, class F, class... Args>
+void invoke_to(R& r, F& f, Args&&... args) {
+	using result_type = std::invoke_result_t<F&, Args...>;
+	if constexpr (std::is_void_v<result_type>) {
+		try {
+			f(std::forward<Args>(args)...);
+		}
+		catch (...) {
+			r.set_error(std::current_exception());
+			return;
+		}
+		r.set_value();
+	}
+	else {
+		std::optional<result_type> res;
+		try {
+			res.emplace(f(std::forward<Args>(args)...));
+		}
+		catch (...) {
+			r.set_error(std::current_exception());
+			return;
+		}
+		r.set_value(std::move(*res));
+	}
+}
+
+/** The result type of a function called with a sender's value */
+template <class F, class V>
+struct result_of_value { using type = std::invoke_result_t<F&, V>; };
+
+template <class F>
+struct result_of_value<F, void> { using type = std::invoke_result_t<F&>; };
+
+/** The type that holds a sender's value, with void as std::monostate */
+template <class V>
+using value_or_monostate = std::conditional_t<std::is_void_v<V>, std::monostate, V>;
+
+/** The shared state for sync_wait() */
+template <class V>
+struct sync_wait_state
+{
+	sync::mutex lock;
+	sync::condition_variable cond;
+	bool done = false;
+	std::optional<value_or_monostate<V>> val;
+	std::exception_ptr err;
+
+	void complete() {
+		std::lock_guard<sync::mutex> g(lock);
+		done = true;
+		cond.notify_one();
+	}
+};
+
+/** The receiver for sync_wait() */
+template <class V>
+struct sync_wait_receiver
+{
+	sync_wait_state<V>* st;
+
+	template <class... Args>
+	void set_value(Args&&... args) {
+		st->val.emplace(std::forward<Args>(args)...);
+		st->complete();
+	}
+	void set_error(std::exception_ptr e) {
+		st->err = std::move(e);
+		st->complete();
+	}
+	void set_stopped() { st->complete(); }
+};
+
+template <class S> struct detached_holder;
+
+/** The receiver for start_detached() */
+template <class S>
+struct detached_receiver
+{
+	detached_holder<S>* h;
+
+	template <class... Args>
+	void set_value(Args&&...);
+	void set_error(std::exception_ptr);
+	void set_stopped();
+};
+
+/** Keeps a detached operation on the heap until it completes */
+template <class S>
+struct detached_holder
+{
+	std::optional<decltype(std::declval<S>().connect(detached_receiver<S>{}))> op;
+};
+
+template <class S> template <class... Args>
+void detached_receiver<S>::set_value(Args&&...) { delete h; }
+
+template <class S>
+void detached_receiver<S>::set_error(std::exception_ptr) { delete h; }
+
+template <class S>
+void detached_receiver<S>::set_stopped() { delete h; }
+
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A scheduler that runs work on a single work thread.
+ */
+class work_thread_scheduler
+{
+	/** The thread */
+	work_thread* thr_;
+
+public:
+	/**
+	 * The operation that completes in the work thread.
+	 * @param R The type of receiver.
+	 */
+	template <class R>
+	class operation
+	{
+		/** The thread */
+		work_thread* thr_;
+		/** The receiver */
+		R r_;
+
+		/**
+		 * Gets the operation that the calling thread is starting, if any.
+		 * This lets a task that's destroyed because the thread refused it
+		 * leave the completion to start().
+		 */
+		static operation*& starting() {
+			thread_local operation* op = nullptr;
+			return op;
+		}
+
+		/**
+		 * The task queued to the thread.
+		 * If it's destroyed without running, as when the thread discards
+		 * its queue, the operation completes as stopped.
+		 */
+		class task
+		{
+			operation* op_;
+		public:
+			task(operation* op) : op_(op) {}
+			task(task&& other) : op_(other.op_) { other.op_ = nullptr; }
+			~task() {
+				if (op_ && starting() != op_)
+					op_->r_.set_stopped();
+			}
+			void operator()() {
+				auto op = op_;
+				op_ = nullptr;
+				op->r_.set_value();
+			}
+		};
+
+	public:
+		/**
+		 * Creates the operation.
+		 * @param thr The thread.
+		 * @param r The receiver.
+		 */
+		operation(work_thread* thr, R r) : thr_(thr), r_(std::move(r)) {}
+		/**
+		 * Queues a task to the thread which completes the operation.
+		 * If the thread is closed, this completes with a queue_closed
+		 * error, in the calling thread.
+		 * @par
+		 * The operation can complete, and be destroyed, in the work thread
+		 * as soon as the task is queued, so this must not touch it after
+		 * a successful post.
+		 */
+		void start() noexcept {
+			auto& cur = starting();
+			auto prev = cur;
+			cur = this;
+			try {
+				thr_->post(task(this));
+			}
+			catch (...) {
+				cur = prev;
+				r_.set_error(std::current_exception());
+				return;
+			}
+			cur = prev;
+		}
+	};
+
+	/**
+	 * The sender for a scheduler.
+	 */
+	class sender
+	{
+		/** The thread */
+		work_thread* thr_;
+
+	public:
+		/** The sender completes with no value */
+		using value_type = void;
+		/**
+		 * Creates a sender for the thread.
+		 * @param thr The thread.
+		 */
+		explicit sender(work_thread* thr) : thr_(thr) {}
+		/**
+		 * Connects the sender to a receiver.
+		 * @param r The receiver.
+		 * @return The operation.
+		 */
+		template <class R>
+		operation<std::decay_t<R>> connect(R&& r) const {
+			return operation<std::decay_t<R>>(thr_, std::forward<R>(r));
+		}
+	};
+
+	/**
+	 * Creates a scheduler for a work thread.
+	 * @param thr The thread.
+	 */
+	explicit work_thread_scheduler(work_thread& thr) : thr_(&thr) {}
+	/**
+	 * Gets a sender that completes in the thread.
+	 * @return A sender that completes in the thread.
+	 */
+	sender schedule() const { return sender(thr_); }
+	/**
+	 * Gets the thread for the scheduler.
+	 * @return The thread for the scheduler.
+	 */
+	work_thread& thread() const { return *thr_; }
+	/**
+	 * Determines if two schedulers use the same thread.
+	 */
+	bool operator==(const work_thread_scheduler& rhs) const {
+		return thr_ == rhs.thr_;
+	}
+	/**
+	 * Determines if two schedulers use different threads.
+	 */
+	bool operator!=(const work_thread_scheduler& rhs) const {
+		return thr_ != rhs.thr_;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A scheduler that spreads work over a collection of work threads.
+ * Each operation is sent to the next thread in the collection, chosen
+ * when the operation is started.
+ */
+class work_threads_scheduler
+{
+	/** The threads */
+	work_threads* thrs_;
+
+public:
+	/**
+	 * The operation that completes on one of the threads.
+	 * @param R The type of receiver.
+	 */
+	template <class R>
+	class operation
+	{
+		/** The threads */
+		work_threads* thrs_;
+		/** The receiver, until started */
+		std::optional<R> r_;
+		/** The operation on the chosen thread, once started */
+		std::optional<work_thread_scheduler::operation<R>> op_;
+
+	public:
+		/**
+		 * Creates the operation.
+		 * @param thrs The threads.
+		 * @param r The receiver.
+		 */
+		operation(work_threads* thrs, R r) : thrs_(thrs), r_(std::move(r)) {}
+		/**
+		 * Queues a task to the next thread, which completes the operation.
+		 */
+		void start() noexcept {
+			op_.emplace(&thrs_->local_next_thread(), std::move(*r_));
+			op_->start();
+		}
+	};
+
+	/**
+	 * The sender for a scheduler.
+	 */
+	class sender
+	{
+		/** The threads */
+		work_threads* thrs_;
+
+	public:
+		/** The sender completes with no value */
+		using value_type = void;
+		/**
+		 * Creates a sender for the threads.
+		 * @param thrs The threads.
+		 */
+		explicit sender(work_threads* thrs) : thrs_(thrs) {}
+		/**
+		 * Connects the sender to a receiver.
+		 * @param r The receiver.
+		 * @return The operation.
+		 */
+		template <class R>
+		operation<std::decay_t<R>> connect(R&& r) const {
+			return operation<std::decay_t<R>>(thrs_, std::forward<R>(r));
+		}
+	};
+
+	/**
+	 * Creates a scheduler for a collection of work threads.
+	 * @param thrs The threads.
+	 */
+	explicit work_threads_scheduler(work_threads& thrs) : thrs_(&thrs) {}
+	/**
+	 * Gets a sender that completes on one of the threads.
+	 * @return A sender that completes on one of the threads.
+	 */
+	sender schedule() const { return sender(thrs_); }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Gets a sender that completes in a work thread.
+ * @param thr The thread.
+ * @return A sender that completes in the thread.
+ */
+inline work_thread_scheduler::sender schedule(work_thread& thr) {
+	return work_thread_scheduler(thr).schedule();
+}
+
+/**
+ * Gets a sender that completes on one of a collection of work threads.
+ * @param thrs The threads.
+ * @return A sender that completes on one of the threads.
+ */
+inline work_threads_scheduler::sender schedule(work_threads& thrs) {
+	return work_threads_scheduler(thrs).schedule();
+}
+
+/**
+ * Gets a sender from a scheduler.
+ * @param sch The scheduler.
+ * @return A sender that completes on the scheduler.
+ */
+template <class Scheduler>
+auto schedule(const Scheduler& sch) -> decltype(sch.schedule()) {
+	return sch.schedule();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A sender that transforms the value of another sender with a function.
+ * @param S The type of the preceding sender.
+ * @param F The type of the function.
+ */
+template <class S, class F>
+class then_sender
+{
+	/** The preceding sender */
+	S s_;
+	/** The function */
+	F f_;
+
+	/** Receives the completion of the preceding sender */
+	template <class R>
+	struct receiver
+	{
+		R r;
+		F f;
+
+		template <class... Args>
+		void set_value(Args&&... args) {
+			detail::invoke_to(r, f, std::forward<Args>(args)...);
+		}
+		void set_error(std::exception_ptr e) { r.set_error(std::move(e)); }
+		void set_stopped() { r.set_stopped(); }
+	};
+
+public:
+	/** The sender completes with the result of the function */
+	using value_type = typename detail::result_of_value<F, typename S::value_type>::type;
+	/**
+	 * Creates the sender.
+	 * @param s The preceding sender.
+	 * @param f The function.
+	 */
+	then_sender(S s, F f) : s_(std::move(s)), f_(std::move(f)) {}
+	/**
+	 * Connects the sender to a receiver.
+	 * @param r The receiver.
+	 * @return The operation.
+	 */
+	template <class R>
+	auto connect(R&& r) && {
+		return std::move(s_).connect(
+			receiver<std::decay_t<R>>{ std::forward<R>(r), std::move(f_) });
+	}
+	/**
+	 * Connects a copy of the sender to a receiver.
+	 * @param r The receiver.
+	 * @return The operation.
+	 */
+	template <class R>
+	auto connect(R&& r) const & {
+		return s_.connect(receiver<std::decay_t<R>>{ std::forward<R>(r), f_ });
+	}
+};
+
+/**
+ * The pipeable form of then(), as in: schedule(thr) | then(f)
+ */
+template <class F>
+struct then_closure
+{
+	/** The function */
+	F f;
+};
+
+/**
+ * Creates a sender that calls a function with the value of another
+ * sender, and completes with its result.
+ * The function runs inline, in the context in which the preceding sender
+ * completes.
+ * @param s The preceding sender.
+ * @param f The function.
+ * @return A sender that completes with the result of the function.
+ */
+template <class S, class F>
+then_sender<std::decay_t<S>, std::decay_t<F>> then(S&& s, F&& f) {
+	return { std::forward<S>(s), std::forward<F>(f) };
+}
+
+/**
+ * Creates the pipeable form of then().
+ * @param f The function.
+ * @return An object that can be applied to a sender with operator|
+ */
+template <class F>
+then_closure<std::decay_t<F>> then(F&& f) {
+	return { std::forward<F>(f) };
+}
+
+/**
+ * Applies a then() to a sender.
+ * @param s The preceding sender.
+ * @param c The function from then().
+ * @return A sender that completes with the result of the function.
+ */
+template <class S, class F>
+then_sender<std::decay_t<S>, F> operator|(S&& s, then_closure<F> c) {
+	return { std::forward<S>(s), std::move(c.f) };
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A sender that completes when all of a set of senders complete.
+ *
+ * It completes with a tuple of their values, with std::monostate for any
+ * that have no value. If any of them fails, it completes with the first
+ * error, but only after they have all completed. Otherwise, if any is
+ * stopped, it completes as stopped.
+ *
+ * It completes inline, in the context of the last sender to complete.
+ */
+template <class... Ss>
+class when_all_sender
+{
+public:
+	/** The sender completes with a tuple of the values */
+	using value_type = std::tuple<detail::value_or_monostate<typename Ss::value_type>...>;
+
+private:
+	/** The senders */
+	std::tuple<Ss...> ss_;
+
+	/** The operation */
+	template <class R>
+	class operation
+	{
+		/** How the senders completed */
+		enum completion { VALUE, STOPPED, FAILED };
+
+		/** Receives the completion of one of the senders */
+		template <size_t I>
+		struct receiver
+		{
+			operation* op;
+
+			template <class... Args>
+			void set_value(Args&&... args) {
+				std::get<I>(op->vals_).emplace(std::forward<Args>(args)...);
+				op->arrive();
+			}
+			void set_error(std::exception_ptr e) {
+				// The first error wins, even over a stop
+				int st = VALUE;
+				if (op->state_.compare_exchange_strong(st, FAILED)
+						|| (st == STOPPED && op->state_.compare_exchange_strong(st, FAILED)))
+					op->err_ = std::move(e);
+				op->arrive();
+			}
+			void set_stopped() {
+				int st = VALUE;
+				op->state_.compare_exchange_strong(st, STOPPED);
+				op->arrive();
+			}
+		};
+
+		/** Connects each of the senders to its receiver */
+		template <size_t... I>
+		static auto connect_all(std::tuple<Ss...>& ss, operation* op,
+								std::index_sequence<I...>) {
+			return std::tuple<decltype(std::get<I>(std::move(ss)).connect(receiver<I>{ op }))...>(
+				std::get<I>(std::move(ss)).connect(receiver<I>{ op })...);
+		}
+
+		/** The type for the operations of the senders */
+		using ops_type = decltype(connect_all(std::declval<std::tuple<Ss...>&>(),
+											  nullptr, std::index_sequence_for<Ss...>{}));
+
+		/** The senders, until started */
+		std::tuple<Ss...> ss_;
+		/** The receiver */
+		R r_;
+		/** The values from the senders */
+		std::tuple<std::optional<detail::value_or_monostate<typename Ss::value_type>>...> vals_;
+		/** The number of senders that have yet to complete */
+		std::atomic<size_t> count_;
+		/** How the senders completed */
+		std::atomic<int> state_;
+		/** The first error */
+		std::exception_ptr err_;
+		/** The operations for the senders, once started */
+		std::optional<ops_type> ops_;
+
+		/** Counts a sender completing, and completes when they all have */
+		void arrive() {
+			if (--count_ != 0)
+				return;
+
+			switch (state_.load()) {
+				case FAILED:
+					r_.set_error(std::move(err_));
+					break;
+				case STOPPED:
+					r_.set_stopped();
+					break;
+				default:
+					std::apply([this](auto&... vals) {
+						r_.set_value(value_type(std::move(*vals)...));
+					}, vals_);
+			}
+		}
+
+	public:
+		operation(std::tuple<Ss...> ss, R r)
+			: ss_(std::move(ss)), r_(std::move(r)),
+				count_(sizeof...(Ss)), state_(VALUE) {}
+
+		operation(operation&& other)
+			: ss_(std::move(other.ss_)), r_(std::move(other.r_)),
+				count_(sizeof...(Ss)), state_(VALUE) {}
+
+		void start() noexcept {
+			if constexpr (sizeof...(Ss) == 0) {
+				r_.set_value(value_type());
+			}
+			else {
+				ops_.emplace(connect_all(ss_, this, std::index_sequence_for<Ss...>{}));
+				std::apply([](auto&... ops) { (ops.start(), ...); }, *ops_);
+			}
+		}
+	};
+
+public:
+	/**
+	 * Creates the sender.
+	 * @param ss The senders.
+	 */
+	explicit when_all_sender(Ss... ss) : ss_(std::move(ss)...) {}
+	/**
+	 * Connects the sender to a receiver.
+	 * @param r The receiver.
+	 * @return The operation.
+	 */
+	template <class R>
+	operation<std::decay_t<R>> connect(R&& r) && {
+		return operation<std::decay_t<R>>(std::move(ss_), std::forward<R>(r));
+	}
+	/**
+	 * Connects a copy of the sender to a receiver.
+	 * @param r The receiver.
+	 * @return The operation.
+	 */
+	template <class R>
+	operation<std::decay_t<R>> connect(R&& r) const & {
+		return operation<std::decay_t<R>>(ss_, std::forward<R>(r));
+	}
+};
+
+/**
+ * Creates a sender that completes when all of a set of senders complete.
+ * @param ss The senders.
+ * @return A sender that completes with a tuple of their values.
+ */
+template <class... Ss>
+when_all_sender<std::decay_t<Ss>...> when_all(Ss&&... ss) {
+	return when_all_sender<std::decay_t<Ss>...>(std::forward<Ss>(ss)...);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Starts the work for a sender and blocks the caller until it completes.
+ *
+ * This must not be called from a thread that the work needs to run on,
+ * or it will deadlock. In the single-threaded build, this runs the event
+ * loop until the work completes.
+ *
+ * @param s The sender.
+ * @return For a sender with a value, an optional with the value, which is
+ *  	   empty if the work was stopped. For a sender with no value,
+ *  	   @em true if it completed, or @em false if it was stopped.
+ * @throws The error from the sender, if it failed.
+ */
+template <class S>
+auto sync_wait(S&& s) {
+	using value_type = typename std::decay_t<S>::value_type;
+
+	detail::sync_wait_state<value_type> st;
+	auto op = std::forward<S>(s).connect(detail::sync_wait_receiver<value_type>{ &st });
+	op.start();
+
+#if defined(COOPER_SINGLE_THREADED)
+	event_loop::instance().wait([&st] { return st.done; });
+#endif
+	std::unique_lock<sync::mutex> g(st.lock);
+	st.cond.wait(g, [&st] { return st.done; });
+
+	if (st.err)
+		std::rethrow_exception(st.err);
+
+	if constexpr (std::is_void_v<value_type>)
+		return st.val.has_value();
+	else
+		return std::move(st.val);
+}
+
+/**
+ * Starts the work for a sender without waiting for it to complete.
+ * The operation is kept on the heap until it completes. Any value or
+ * error that it completes with is discarded.
+ * @param s The sender.
+ */
+template <class S>
+void start_detached(S&& s) {
+	using sender_type = std::decay_t<S>;
+	auto h = new detail::detached_holder<sender_type>;
+	h->op.emplace(std::forward<S>(s).connect(detail::detached_receiver<sender_type>{ h }));
+	h->op->start();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_execution_h
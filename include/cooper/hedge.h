@@ -0,0 +1,416 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file hedge.h
+/// Hedged calls to groups of replica actors
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef __cooper_hedge_h
+#define __cooper_hedge_h
+
+#include "cooper/actor.h"
+#include <vector>
+#include <memory>
+#include <future>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Parameters for hedged calls.
+ */
+struct hedge_options
+{
+	/**
+	 * The percentile of the recent response times to wait for before
+	 * sending a hedged request, in the range (0, 1).
+	 */
+	double percentile = 0.95;
+	/** The shortest that the hedge delay can be */
+	std::chrono::nanoseconds min_delay = std::chrono::microseconds(100);
+	/** The longest that the hedge delay can be */
+	std::chrono::nanoseconds max_delay = std::chrono::seconds(1);
+	/** The hedge delay to use until there are enough samples */
+	std::chrono::nanoseconds initial_delay = std::chrono::milliseconds(10);
+	/** The number of recent response times to keep */
+	size_t window = 1024;
+	/** The number of samples needed before the percentile is used */
+	size_t min_samples = 32;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Keeps a window of recent response times and tracks a percentile of
+ * them.
+ *
+ * The percentile is recomputed every so often as samples come in, rather
+ * than on every lookup, so reading it is just an atomic load. It's clamped
+ * to the range in the options.
+ */
+class latency_tracker
+{
+	/** The configuration */
+	hedge_options opts_;
+	/** Object lock */
+	std::mutex lock_;
+	/** The recent samples, in nanoseconds, as a ring buffer */
+	std::vector<int64_t> samples_;
+	/** The position of the next sample in the ring */
+	size_t pos_;
+	/** The total number of samples added */
+	uint64_t nSample_;
+	/** The current percentile, in nanoseconds */
+	std::atomic<int64_t> delay_;
+
+	/** Simple, scope-based lock guard */
+	using guard = std::lock_guard<std::mutex>;
+
+	/** The number of samples between updates of the percentile */
+	size_t update_interval() const {
+		return std::max<size_t>(1, opts_.window / 16);
+	}
+
+public:
+	/**
+	 * Creates a tracker.
+	 * @param opts The configuration.
+	 */
+	explicit latency_tracker(const hedge_options& opts=hedge_options{})
+		: opts_(opts), pos_(0), nSample_(0),
+			delay_(std::clamp(opts.initial_delay, opts.min_delay, opts.max_delay).count()) {
+		opts_.window = std::max<size_t>(opts_.window, 1);
+		samples_.reserve(opts_.window);
+	}
+	/**
+	 * Adds a response time.
+	 * @param d The response time.
+	 */
+	void add(std::chrono::nanoseconds d) {
+		guard g(lock_);
+		if (samples_.size() < opts_.window)
+			samples_.push_back(d.count());
+		else
+			samples_[pos_] = d.count();
+		pos_ = (pos_ + 1) % opts_.window;
+
+		if (++nSample_ < opts_.min_samples
+				|| (nSample_ - opts_.min_samples) % update_interval() != 0)
+			return;
+
+		auto v = samples_;
+		auto n = size_t(opts_.percentile * double(v.size()));
+		n = std::min(n, v.size()-1);
+		std::nth_element(v.begin(), v.begin()+n, v.end());
+
+		auto delay = std::clamp(std::chrono::nanoseconds(v[n]),
+								opts_.min_delay, opts_.max_delay);
+		delay_.store(delay.count(), std::memory_order_relaxed);
+	}
+	/**
+	 * Gets the current percentile of the response times.
+	 * @return The current percentile of the response times, clamped to
+	 *  	   the configured range.
+	 */
+	std::chrono::nanoseconds percentile() const {
+		return std::chrono::nanoseconds(delay_.load(std::memory_order_relaxed));
+	}
+	/**
+	 * Gets the total number of samples that were added.
+	 * @return The total number of samples that were added.
+	 */
+	uint64_t num_samples() {
+		guard g(lock_);
+		return nSample_;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A group of equivalent replica actors that handle hedged calls.
+ *
+ * A call goes to one replica, picked round-robin. If there's no reply
+ * within the hedge delay, the same request is sent to the next replica,
+ * and the caller gets whichever reply comes first. The hedge delay is a
+ * high percentile of the recent response times, so only the slowest few
+ * percent of calls are hedged, which cuts the tail latency from an
+ * occasional slow replica at the cost of a few percent more load.
+ *
+ * When one of the requests completes, the other is cancelled if it
+ * hasn't started yet, which is the usual case when the slow replica is
+ * backed up. If it's already running, it runs to completion, and its
+ * result is dropped.
+ *
+ * If a request throws, the caller waits for the other one, if it was
+ * sent, and only gets the exception if both fail.
+ *
+ * @par
+ * Each replica is created on a separate work thread, as far as possible.
+ * The requests are function objects that run in the replica's thread and
+ * are passed a reference to it, so they can use its state directly. Since
+ * either replica could run a request, it must not depend on which one it
+ * gets, and it has to be safe to run it twice.
+ *
+ * @param T The type of replica. It must derive from @ref actor.
+ */
+template <typename T>
+class replica_group
+{
+	/** The state that is shared with the queued requests */
+	struct state {
+		latency_tracker lat;
+		std::atomic<size_t> nCall{0};
+		std::atomic<size_t> nHedged{0};
+		std::atomic<size_t> nHedgeWon{0};
+		std::atomic<size_t> nCancelled{0};
+
+		explicit state(const hedge_options& opts) : lat(opts) {}
+	};
+
+	/** The state for a single call */
+	template <typename R>
+	struct call_state {
+		std::promise<R> prom;
+		std::atomic<bool> done{false};
+		std::atomic<int> nPending{1};
+		/** Lock for the error */
+		std::mutex lock;
+		/** The first error from a request */
+		std::exception_ptr err;
+
+		/**
+		 * Records a failed request. If it was the last one pending, the
+		 * call completes with the first error.
+		 */
+		void fail(std::exception_ptr e) {
+			{
+				std::lock_guard<std::mutex> g(lock);
+				if (!err)
+					err = e;
+			}
+			if (--nPending == 0 && !done.exchange(true))
+				prom.set_exception(err);
+		}
+	};
+
+	/**
+	 * Move-only guard for a queued request.
+	 * If the request is dropped without running, such as when the work
+	 * thread is closed or its queue is discarded, the request fails with
+	 * a @ref queue_closed error, so the caller isn't left waiting.
+	 */
+	template <typename R>
+	struct request {
+		std::shared_ptr<call_state<R>> cs;
+
+		explicit request(std::shared_ptr<call_state<R>> cs) : cs(std::move(cs)) {}
+		request(request&& other) : cs(std::move(other.cs)) {}
+		~request() {
+			if (cs)
+				cs->fail(std::make_exception_ptr(queue_closed()));
+		}
+	};
+
+	/** The replicas */
+	std::vector<actor_ptr<T>> reps_;
+	/** The work thread for each replica */
+	std::vector<work_thread*> thrs_;
+	/** The index of the next replica for a call */
+	std::atomic<size_t> next_;
+	/** The shared state */
+	std::shared_ptr<state> st_;
+
+	/**
+	 * Queues a request to a replica.
+	 * If the request can't be queued, or is dropped from the queue, it
+	 * fails, and the call completes if it was the last one pending.
+	 */
+	template <typename R, class Func>
+	void send(size_t idx, std::shared_ptr<call_state<R>> cs,
+			  std::shared_ptr<Func> f, bool hedge) {
+		T* rep = reps_[idx].get();
+		auto sent = std::chrono::steady_clock::now();
+		request<R> req(std::move(cs));
+		try {
+			thrs_[idx]->post([st=st_, req=std::move(req), f, rep, sent, hedge]() mutable {
+				run_request(st, std::move(req.cs), f, rep, sent, hedge);
+			});
+		}
+		catch (...) {
+			// The request guard was destroyed, and recorded the failure
+		}
+	}
+
+	/** Runs a request in the replica's thread */
+	template <typename R, class Func>
+	static void run_request(std::shared_ptr<state> st, std::shared_ptr<call_state<R>> cs,
+						  std::shared_ptr<Func> f, T* rep,
+						  std::chrono::steady_clock::time_point sent, bool hedge) {
+		if (cs->done.load(std::memory_order_acquire)) {
+			++st->nCancelled;
+			return;
+		}
+		try {
+			if constexpr (std::is_void_v<R>) {
+				(*f)(*rep);
+				st->lat.add(std::chrono::steady_clock::now() - sent);
+				if (!cs->done.exchange(true)) {
+					if (hedge) ++st->nHedgeWon;
+					cs->prom.set_value();
+				}
+			}
+			else {
+				R val = (*f)(*rep);
+				st->lat.add(std::chrono::steady_clock::now() - sent);
+				if (!cs->done.exchange(true)) {
+					if (hedge) ++st->nHedgeWon;
+					cs->prom.set_value(std::move(val));
+				}
+			}
+		}
+		catch (...) {
+			cs->fail(std::current_exception());
+		}
+	}
+
+	// Non-copyable
+	replica_group(const replica_group&) =delete;
+	replica_group& operator=(const replica_group&) =delete;
+
+public:
+	/**
+	 * Creates a group of replicas.
+	 * @param thrs The work threads for the replicas. Each replica goes on
+	 *  		   the next thread in the collection.
+	 * @param n The number of replicas.
+	 * @param opts The configuration for hedging.
+	 * @param args The arguments for the constructor of each replica.
+	 */
+	template <class... Args>
+	replica_group(work_threads& thrs, size_t n, const hedge_options& opts,
+				  Args&&... args)
+		: next_(0), st_(std::make_shared<state>(opts)) {
+		for (size_t i=0; i<n; ++i) {
+			auto& thr = thrs[i % thrs.size()];
+			placement plc(thr);
+			reps_.push_back(make_actor<T>(args...));
+			thrs_.push_back(&thr);
+		}
+	}
+	/**
+	 * Gets the number of replicas.
+	 * @return The number of replicas.
+	 */
+	size_t size() const { return reps_.size(); }
+	/**
+	 * Gets a reference to one of the replicas.
+	 * @param i The index of the replica.
+	 * @return A reference to the replica.
+	 */
+	T& operator[](size_t i) { return *reps_[i]; }
+	/**
+	 * Makes a hedged call to the replicas.
+	 * @param f The function object to run in a replica's thread. It is
+	 *  		passed a reference to the replica.
+	 * @return The result from the first replica to complete the request.
+	 * @throws Any exception thrown by the request, if every replica that
+	 *  	   ran it failed.
+	 * @throws queue_closed if the requests were dropped without running,
+	 *  	   because the replicas' threads were closed or discarded their
+	 *  	   queues.
+	 */
+	template <class Func>
+	std::invoke_result_t<Func, T&> call(Func f) {
+		using result_type = std::invoke_result_t<Func, T&>;
+
+		auto cs = std::make_shared<call_state<result_type>>();
+		auto fut = cs->prom.get_future();
+		auto pf = std::make_shared<Func>(std::move(f));
+
+		size_t n = reps_.size();
+		size_t idx = next_++ % n;
+		++st_->nCall;
+		send(idx, cs, pf, false);
+
+		if (n > 1 && fut.wait_for(hedge_delay()) == std::future_status::timeout) {
+			++cs->nPending;
+			++st_->nHedged;
+			send((idx+1) % n, cs, pf, true);
+		}
+		return detail::get_result(std::move(fut));
+	}
+	/**
+	 * Gets the current delay before a call is hedged.
+	 * @return The current delay before a call is hedged.
+	 */
+	std::chrono::nanoseconds hedge_delay() const { return st_->lat.percentile(); }
+	/**
+	 * Gets the number of calls made to the group.
+	 * @return The number of calls made to the group.
+	 */
+	size_t num_calls() const { return st_->nCall; }
+	/**
+	 * Gets the number of calls that were hedged.
+	 * @return The number of calls that sent a second request.
+	 */
+	size_t num_hedged() const { return st_->nHedged; }
+	/**
+	 * Gets the number of hedged calls that were answered by the second
+	 * request.
+	 * @return The number of times the hedged request won.
+	 */
+	size_t num_hedge_wins() const { return st_->nHedgeWon; }
+	/**
+	 * Gets the number of requests that were cancelled before they started.
+	 * @return The number of requests that were cancelled.
+	 */
+	size_t num_cancelled() const { return st_->nCancelled; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_hedge_h
@@ -0,0 +1,366 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file hibernate.h
+/// Implementation of the classes 'hibernating_actor' and 'hibernator'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_hibernate_h
+#define __cooper_hibernate_h
+
+#include "cooper/actor.h"
+#include "cooper/timer.h"
+#include <unordered_set>
+#include <unordered_map>
+#include <functional>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+namespace cooper {
+
+class hibernating_actor;
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Puts idle actors into hibernation.
+ *
+ * Actors that derive from @ref hibernating_actor register themselves with
+ * a hibernator. It runs a periodic timer which advances an "epoch" counter
+ * on each tick, and then scans the registered actors. Each actor records
+ * the epoch whenever it handles a message, so the scan can spot the idle
+ * actors just by reading a counter, without sending any messages to them.
+ * For each work thread that has idle actors, a single task is then sent
+ * to put them into hibernation, in the context of that thread.
+ *
+ * The idle time is measured in whole sweep intervals, so an actor
+ * hibernates after being idle for somewhere between the idle time and the
+ * idle time plus one interval.
+ *
+ * Actors that are already hibernating are set aside until they wake, so a
+ * sweep only looks at the ones that are awake.
+ *
+ * @par
+ * The actors are kept in separate sets for each work thread, each with its
+ * own lock, so hibernating the actors on one thread doesn't hold up the
+ * actors on any of the others. No lock is held while a task is sent to a
+ * thread.
+ */
+class hibernator
+{
+	/** A set of actors */
+	using actor_set = std::unordered_set<hibernating_actor*>;
+	/** The actors on a work thread */
+	struct thread_actors {
+		/**
+		 * Lock for the sets. This is held while the actors on the thread
+		 * hibernate.
+		 */
+		std::mutex lock;
+		/** The actors that are awake */
+		actor_set awake;
+		/** The actors that are hibernating */
+		actor_set asleep;
+	};
+	/** The actors on a thread, and the thread */
+	using thread_entry = std::pair<work_thread*, thread_actors*>;
+
+	/**
+	 * Move-only guard for a queued sweep task. It counts the task as
+	 * pending until it's destroyed, whether it ran or was dropped from
+	 * the thread's queue.
+	 */
+	struct pending_sweep {
+		hibernator* hib;
+
+		explicit pending_sweep(hibernator* hib) : hib(hib) { ++hib->nPending_; }
+		pending_sweep(pending_sweep&& other) : hib(other.hib) { other.hib = nullptr; }
+		~pending_sweep() {
+			if (hib)
+				--hib->nPending_;
+		}
+	};
+
+	/** Lock for the map of threads */
+	std::mutex lock_;
+	/**
+	 * The registered actors, by work thread. The entries are never removed,
+	 * so the actors can keep a pointer to theirs.
+	 */
+	std::unordered_map<work_thread*, std::unique_ptr<thread_actors>> actors_;
+	/** The threads for the sweep. Only used by the timer. */
+	std::vector<thread_entry> sweepThrs_;
+	/** The number of registered actors */
+	std::atomic<size_t> nActor_;
+	/** The number of sweep tasks that have yet to run */
+	std::atomic<size_t> nPending_;
+	/** The sweep counter */
+	std::atomic<uint64_t> epoch_;
+	/** The number of sweeps that an actor must be idle to hibernate */
+	uint64_t nIdle_;
+	/** The number of actors that are currently hibernating */
+	std::atomic<size_t> nHibernating_;
+	/** The timer to run the sweeps */
+	periodic_timer tmr_;
+
+	friend class hibernating_actor;
+
+	/** Advances the epoch and sends idle actors into hibernation */
+	void sweep();
+	/** Puts the idle actors on the calling work thread into hibernation */
+	void hibernate_idle(thread_actors* acts);
+	/** Registers an actor */
+	void add(hibernating_actor* act);
+	/** Unregisters an actor */
+	void remove(hibernating_actor* act);
+	/** Moves an actor that woke back to the awake set */
+	void wake(hibernating_actor* act);
+
+	// Non-copyable
+	hibernator(const hibernator&) =delete;
+	hibernator& operator=(const hibernator&) =delete;
+
+public:
+	/**
+	 * Creates a hibernator and starts the sweeps.
+	 * @param idleTime The amount of time that an actor must be idle before
+	 *  			   it hibernates.
+	 * @param interval The time between sweeps of the actors. This sets the
+	 *  			   resolution of the idle time.
+	 */
+	hibernator(const std::chrono::nanoseconds& idleTime,
+			   const std::chrono::nanoseconds& interval);
+	/**
+	 * Stops the sweeps.
+	 * Any actors using this hibernator must be destroyed first.
+	 */
+	~hibernator();
+	/**
+	 * Gets the current sweep epoch.
+	 * @return The current sweep epoch.
+	 */
+	uint64_t epoch() const { return epoch_; }
+	/**
+	 * Gets the number of registered actors.
+	 * @return The number of registered actors.
+	 */
+	size_t size() const { return nActor_; }
+	/**
+	 * Gets the number of actors that are currently hibernating.
+	 * @return The number of actors that are currently hibernating.
+	 */
+	size_t num_hibernating() const { return nHibernating_; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Base class for actors that can hibernate when idle.
+ *
+ * With very large numbers of actors that are mostly idle, like one per
+ * session, it helps to have the idle ones give back whatever memory they
+ * can. An actor that derives from this class and goes idle for the time
+ * set in its @ref hibernator gets a call to on_hibernate(), in its own
+ * thread, where it can release caches, compact its state, and so on. The
+ * next message sent to the actor wakes it, with a call to on_wake() before
+ * the message is handled, where it can restore anything it needs.
+ *
+ * This works transparently as long as the actor uses the call() and cast()
+ * from this class, which wrap each message to keep track of activity. The
+ * actor registers with the hibernator when it handles its first message,
+ * so a sweep never sees one that is only partly constructed.
+ *
+ * @par
+ * The sweep calls on_hibernate() in the actor's thread, so an actor that
+ * can be destroyed from another thread must call stop() at the start of
+ * the derived class's destructor. This unregisters it, waiting for a
+ * sweep that's in progress, before any of the derived members are torn
+ * down. In a debug build, the base destructor asserts that this was done.
+ *
+ * @par
+ * Note that actors share the task queue of their work thread, so there is
+ * no per-actor mailbox memory to release. The queue memory for an idle
+ * thread can be released with work_thread::queue_shrink_to_fit().
+ */
+class hibernating_actor : public actor
+{
+	/** The hibernator for the actor */
+	hibernator& hib_;
+	/** The epoch of the last message that the actor handled */
+	std::atomic<uint64_t> lastEpoch_;
+	/** Whether the actor is hibernating. Only used in the actor thread. */
+	bool hibernating_;
+	/** The hibernator's set for the actor's thread, once registered */
+	hibernator::thread_actors* acts_;
+	/** Whether stop() was called */
+	bool stopped_;
+
+	friend class hibernator;
+
+	/**
+	 * Marks the actor as active, registering it on the first message, and
+	 * waking it if it was hibernating.
+	 * This runs in the actor thread before each message.
+	 */
+	void touch() {
+		lastEpoch_.store(hib_.epoch(), std::memory_order_relaxed);
+		if (!acts_ && !stopped_)
+			hib_.add(this);
+		if (hibernating_) {
+			hibernating_ = false;
+			--hib_.nHibernating_;
+			hib_.wake(this);
+			on_wake();
+		}
+	}
+	/**
+	 * Puts the actor into hibernation if it is still idle.
+	 * This runs in the actor thread.
+	 */
+	void hibernate() {
+		uint64_t last = lastEpoch_.load(std::memory_order_relaxed);
+		if (!hibernating_ && hib_.epoch() - last >= hib_.nIdle_) {
+			hibernating_ = true;
+			++hib_.nHibernating_;
+			on_hibernate();
+		}
+	}
+
+protected:
+	/**
+	 * Called in the actor thread when the actor goes into hibernation.
+	 * The actor can release any memory that it doesn't need while idle.
+	 * This is called while the actors on the thread are locked, so it
+	 * must not destroy any hibernating actors on the same thread.
+	 */
+	virtual void on_hibernate() {}
+	/**
+	 * Called in the actor thread when the actor is woken by a message,
+	 * just before the message is handled.
+	 */
+	virtual void on_wake() {}
+	/**
+	 * Determines if the actor is hibernating.
+	 * This must only be called from the actor thread.
+	 * @return @em true if the actor is hibernating, @em false if not.
+	 */
+	bool hibernating() const { return hibernating_; }
+	/**
+	 * Unregisters the actor from the hibernator.
+	 * If a sweep is putting the actor into hibernation, this waits for it
+	 * to finish. After this, the actor won't hibernate again. A derived
+	 * class that can be destroyed from another thread must call this at
+	 * the start of its destructor. It's safe to call more than once.
+	 */
+	void stop();
+	/**
+	 * Blocking call to wait for a task to execute in the actor thread.
+	 * This wakes the actor if it is hibernating.
+	 * @param f The function object for the thread to execute
+	 * @return The task's return value.
+	 * @throws Any exception thrown by the task.
+	 */
+	template <class Func>
+	typename std::invoke_result_t<Func> call(Func&& f) {
+		return actor::call([this, f=std::forward<Func>(f)]() mutable {
+			touch();
+			return f();
+		});
+	}
+	/**
+	 * Blocking call to wait for a task to execute in the actor thread.
+	 * This wakes the actor if it is hibernating.
+	 * @param f The function object for the thread to execute
+	 * @param args The arguments to the function.
+	 * @return The task's return value.
+	 * @throws Any exception thrown by the task.
+	 */
+	template <class Func, class... Args>
+	typename std::invoke_result_t<Func,Args...> call(Func&& f, Args&&... args) {
+		return call(std::bind(std::forward<Func>(f), std::forward<Args>(args)...));
+	}
+	/**
+	 * Sends a task to run in the actor thread asynchronously.
+	 * This wakes the actor if it is hibernating.
+	 * @param f The function object for the thread to execute
+	 */
+	template <class Func>
+	void cast(Func&& f) {
+		actor::cast([this, f=std::forward<Func>(f)]() mutable {
+			touch();
+			f();
+		});
+	}
+	/**
+	 * Sends a task to run in the actor thread asynchronously.
+	 * This wakes the actor if it is hibernating.
+	 * @param f The function object for the thread to execute
+	 * @param args The arguments to the function.
+	 */
+	template <class Func, class... Args>
+	void cast(Func&& f, Args&&... args) {
+		cast(std::bind(std::forward<Func>(f), std::forward<Args>(args)...));
+	}
+
+public:
+	/**
+	 * Creates an actor that uses a hibernator.
+	 * @param hib The hibernator for the actor.
+	 */
+	explicit hibernating_actor(hibernator& hib);
+	/**
+	 * Creates an actor on a specific thread that uses a hibernator.
+	 * @param hib The hibernator for the actor.
+	 * @param thr The thread for the actor.
+	 */
+	hibernating_actor(hibernator& hib, work_thread& thr);
+	/**
+	 * Unregisters the actor from the hibernator, if stop() wasn't already
+	 * called.
+	 */
+	virtual ~hibernating_actor();
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_hibernate_h
@@ -0,0 +1,202 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file mpmc_ring.h
+/// Implementation of the class 'mpmc_ring'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#ifndef __cooper_mpmc_ring_h
+#define __cooper_mpmc_ring_h
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A bounded, lock-free queue for any number of producers and consumers.
+ *
+ * This is a fixed ring of cells, each with a sequence number that says
+ * whether it's ready to be written or read for the current lap around the
+ * ring. A producer claims a slot by advancing the shared tail with a
+ * compare-and-swap, fills it, then publishes it by bumping the cell's
+ * sequence. Consumers do the same at the head. So the only contention is
+ * among the producers on the tail, and among the consumers on the head,
+ * and neither side ever waits for a lock held by a thread that was
+ * preempted.
+ *
+ * It doesn't block; when full or empty the operations just fail. To use it
+ * as a blocking task queue, see the specialization of @ref task_queue for
+ * this type.
+ *
+ * @param T The type of items in the queue. This must be default
+ *  		constructible and move-assignable.
+ */
+template <typename T>
+class mpmc_ring
+{
+public:
+	/** The type of items in the queue */
+	using value_type = T;
+	/** The type used to specify the number of items in the queue */
+	using size_type = size_t;
+
+private:
+	/** The size of a cache line, to keep the two ends apart */
+	static constexpr size_t CACHE_LINE = 64;
+
+	/** A slot in the ring */
+	struct cell {
+		/** The lap position at which the cell can next be used */
+		std::atomic<size_type> seq;
+		/** The item */
+		T val;
+	};
+
+	/** The cells. The size is a power of two. */
+	std::unique_ptr<cell[]> cells_;
+	/** Mask to turn a position into a cell */
+	size_type mask_;
+
+	/** The next position to write */
+	alignas(CACHE_LINE) std::atomic<size_type> tail_;
+	/** The next position to read */
+	alignas(CACHE_LINE) std::atomic<size_type> head_;
+
+	// Non-copyable
+	mpmc_ring(const mpmc_ring&) =delete;
+	mpmc_ring& operator=(const mpmc_ring&) =delete;
+
+public:
+	/**
+	 * Creates a queue.
+	 * @param cap The capacity of the queue. This is rounded up to a power
+	 *  		  of two.
+	 */
+	explicit mpmc_ring(size_type cap) : tail_(0), head_(0) {
+		size_type n = 2;
+		while (n < cap)
+			n <<= 1;
+		cells_.reset(new cell[n]);
+		for (size_type i=0; i<n; ++i)
+			cells_[i].seq.store(i, std::memory_order_relaxed);
+		mask_ = n - 1;
+	}
+	/**
+	 * Gets the capacity of the queue.
+	 * @return The most items that the queue can hold.
+	 */
+	size_type capacity() const { return mask_ + 1; }
+	/**
+	 * Gets the number of items in the queue.
+	 * With other threads using the queue, this is only a snapshot.
+	 * @return The number of items in the queue.
+	 */
+	size_type size() const {
+		auto head = head_.load(std::memory_order_acquire);
+		auto tail = tail_.load(std::memory_order_acquire);
+		return (tail > head) ? (tail - head) : 0;
+	}
+	/**
+	 * Determines if the queue is empty.
+	 * With other threads using the queue, this is only a snapshot.
+	 * @return @em true if the queue is empty, @em false if not.
+	 */
+	bool empty() const { return size() == 0; }
+	/**
+	 * Attempts to push an item onto the back of the queue.
+	 * @param val The item to push. It's only moved from on success.
+	 * @return @em true if the item was pushed, @em false if the queue is
+	 *  	   full.
+	 */
+	bool try_push(T&& val) {
+		cell* c;
+		size_type pos = tail_.load(std::memory_order_relaxed);
+		while (true) {
+			c = &cells_[pos & mask_];
+			size_type seq = c->seq.load(std::memory_order_acquire);
+			auto dif = intptr_t(seq) - intptr_t(pos);
+			if (dif == 0) {
+				if (tail_.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed))
+					break;
+			}
+			else if (dif < 0)
+				return false;
+			else
+				pos = tail_.load(std::memory_order_relaxed);
+		}
+		c->val = std::move(val);
+		c->seq.store(pos+1, std::memory_order_release);
+		return true;
+	}
+	/**
+	 * Attempts to pop an item from the front of the queue.
+	 * @param val Pointer to a variable to get the item.
+	 * @return @em true if an item was popped, @em false if the queue is
+	 *  	   empty.
+	 */
+	bool try_pop(T* val) {
+		cell* c;
+		size_type pos = head_.load(std::memory_order_relaxed);
+		while (true) {
+			c = &cells_[pos & mask_];
+			size_type seq = c->seq.load(std::memory_order_acquire);
+			auto dif = intptr_t(seq) - intptr_t(pos+1);
+			if (dif == 0) {
+				if (head_.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed))
+					break;
+			}
+			else if (dif < 0)
+				return false;
+			else
+				pos = head_.load(std::memory_order_relaxed);
+		}
+		*val = std::move(c->val);
+		c->seq.store(pos + mask_ + 1, std::memory_order_release);
+		return true;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_mpmc_ring_h
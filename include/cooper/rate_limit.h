@@ -0,0 +1,522 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file rate_limit.h
+/// Token bucket rate limiting for actors
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_rate_limit_h
+#define __cooper_rate_limit_h
+
+#include "cooper/actor.h"
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <stdexcept>
+#include <cmath>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A token bucket.
+ *
+ * The bucket fills with tokens at a fixed rate, up to a maximum, the
+ * burst size. Each request takes a token out of it. So, over time, the
+ * requests are limited to the fill rate, but a burst of requests up to
+ * the size of the bucket can be handled all at once.
+ *
+ * This is not thread safe. The limiters that use it provide the locking.
+ */
+class token_bucket
+{
+public:
+	/** The clock used to refill the bucket */
+	using clock = std::chrono::steady_clock;
+	/** A point in time for the clock */
+	using time_point = clock::time_point;
+
+private:
+	/** The fill rate, in tokens per second */
+	double rate_;
+	/** The maximum number of tokens */
+	double burst_;
+	/**
+	 * The number of tokens in the bucket.
+	 * This goes negative when tokens are borrowed against the future.
+	 */
+	double tokens_;
+	/** The last time the bucket was refilled */
+	time_point last_;
+
+	/** Adds the tokens that accumulated since the last refill */
+	void refill(time_point now) {
+		if (now > last_) {
+			double dt = std::chrono::duration<double>(now - last_).count();
+			tokens_ = std::min(burst_, tokens_ + dt*rate_);
+			last_ = now;
+		}
+	}
+
+public:
+	/**
+	 * Checks that the parameters for a bucket are usable.
+	 * @param rate The fill rate, in tokens per second.
+	 * @param burst The maximum number of tokens in the bucket.
+	 * @throws std::invalid_argument if the rate is not a positive, finite
+	 *  	   number, or the burst is less than one token.
+	 */
+	static void check(double rate, double burst) {
+		if (!(rate > 0.0) || !std::isfinite(rate))
+			throw std::invalid_argument("token_bucket: rate must be positive");
+		if (!(burst >= 1.0) || !std::isfinite(burst))
+			throw std::invalid_argument("token_bucket: burst must be at least one");
+	}
+	/**
+	 * Creates a full bucket.
+	 * @param rate The fill rate, in tokens per second.
+	 * @param burst The maximum number of tokens in the bucket.
+	 * @param now The current time.
+	 * @throws std::invalid_argument if the rate is not a positive, finite
+	 *  	   number, or the burst is less than one token.
+	 */
+	token_bucket(double rate, double burst, time_point now=clock::now())
+		: rate_(rate), burst_(burst), tokens_(burst), last_(now) {
+		check(rate, burst);
+	}
+	/**
+	 * Gets the fill rate.
+	 * @return The fill rate, in tokens per second.
+	 */
+	double rate() const { return rate_; }
+	/**
+	 * Gets the size of the bucket.
+	 * @return The maximum number of tokens in the bucket.
+	 */
+	double burst() const { return burst_; }
+	/**
+	 * Gets the number of tokens in the bucket.
+	 * @param now The current time.
+	 * @return The number of tokens available.
+	 */
+	double available(time_point now=clock::now()) {
+		refill(now);
+		return tokens_;
+	}
+	/**
+	 * Determines if the bucket is full.
+	 * A full bucket is the same as a new one.
+	 * @param now The current time.
+	 * @return @em true if the bucket is full, @em false if not.
+	 */
+	bool full(time_point now=clock::now()) {
+		return available(now) >= burst_;
+	}
+	/**
+	 * Tries to take a token from the bucket.
+	 * @param now The current time.
+	 * @return @em true if a token was taken, @em false if the bucket is
+	 *  	   empty.
+	 */
+	bool try_take(time_point now=clock::now()) {
+		refill(now);
+		if (tokens_ < 1.0)
+			return false;
+		tokens_ -= 1.0;
+		return true;
+	}
+	/**
+	 * Takes a token from the bucket, borrowing against the future if it
+	 * is empty.
+	 * The caller should wait for the returned amount of time before
+	 * proceeding. If that would be longer than the maximum delay, no token
+	 * is taken.
+	 * @param maxDelay The longest that the caller is willing to wait.
+	 * @param delay Gets the amount of time to wait until the token is
+	 *  			available.
+	 * @param now The current time.
+	 * @return @em true if a token was taken, @em false if not.
+	 */
+	bool reserve(std::chrono::nanoseconds maxDelay,
+				 std::chrono::nanoseconds* delay,
+				 time_point now=clock::now()) {
+		refill(now);
+		double wait = (tokens_ >= 1.0) ? 0.0 : (1.0 - tokens_) / rate_;
+		auto d = std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::duration<double>(wait));
+		if (d > maxDelay)
+			return false;
+		tokens_ -= 1.0;
+		*delay = d;
+		return true;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * What a rate limiter does with a request when it's over the limit.
+ */
+enum class limit_mode
+{
+	/** Reject the request immediately. */
+	reject,
+	/**
+	 * Block the caller until the request fits within the limit.
+	 * If that would take longer than the maximum delay, the request is
+	 * rejected.
+	 *
+	 * The caller sleeps, so this should only be used for senders that have
+	 * a thread of their own. An actor that sends to a limited actor in this
+	 * mode stalls every other actor on its work thread while it waits, and
+	 * in the single-threaded build it stalls the whole event loop.
+	 */
+	delay
+};
+
+/**
+ * The configuration for a rate limiter.
+ */
+struct limit_options
+{
+	/** The sustained rate, in requests per second */
+	double rate = 1000.0;
+	/** The number of requests that can be let through all at once */
+	double burst = 100.0;
+	/** What to do with requests over the limit */
+	limit_mode mode = limit_mode::reject;
+	/** The longest that a request can be delayed, in delay mode */
+	std::chrono::nanoseconds max_delay = std::chrono::seconds(1);
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Base for the rate limiters, with the configuration and counters.
+ */
+class rate_limiter_base
+{
+protected:
+	/** The configuration */
+	limit_options opts_;
+	/** The number of requests let through without delay */
+	std::atomic<size_t> nAccepted_;
+	/** The number of requests let through after a delay */
+	std::atomic<size_t> nDelayed_;
+	/** The number of requests rejected */
+	std::atomic<size_t> nRejected_;
+
+	/**
+	 * Applies the limit to a request with the bucket, which must be
+	 * locked by the caller. This does not wait. For a delayed request, it
+	 * sets the time that the caller needs to wait.
+	 * @return @em true if the request is admitted, @em false if not.
+	 */
+	bool take(token_bucket& bkt, std::chrono::nanoseconds* delay) {
+		*delay = std::chrono::nanoseconds(0);
+		if (opts_.mode == limit_mode::reject) {
+			if (bkt.try_take())
+				return true;
+		}
+		else if (bkt.reserve(opts_.max_delay, delay)) {
+			return true;
+		}
+		++nRejected_;
+		return false;
+	}
+	/**
+	 * Waits out the delay for an admitted request, outside the lock, and
+	 * updates the counters.
+	 */
+	bool admitted(std::chrono::nanoseconds delay) {
+		if (delay.count() > 0) {
+			++nDelayed_;
+			std::this_thread::sleep_for(delay);
+		}
+		else
+			++nAccepted_;
+		return true;
+	}
+
+	/**
+	 * Creates the base with the configuration.
+	 * @param opts The configuration.
+	 * @throws std::invalid_argument if the rate is not a positive, finite
+	 *  	   number, or the burst is less than one request.
+	 */
+	explicit rate_limiter_base(const limit_options& opts)
+			: opts_(opts), nAccepted_(0), nDelayed_(0), nRejected_(0) {
+		token_bucket::check(opts.rate, opts.burst);
+	}
+
+public:
+	/**
+	 * Gets the configuration of the limiter.
+	 * @return The configuration of the limiter.
+	 */
+	const limit_options& options() const { return opts_; }
+	/**
+	 * Gets the number of requests that were let through without delay.
+	 * @return The number of requests let through without delay.
+	 */
+	size_t num_accepted() const { return nAccepted_; }
+	/**
+	 * Gets the number of requests that were let through after a delay.
+	 * @return The number of requests let through after a delay.
+	 */
+	size_t num_delayed() const { return nDelayed_; }
+	/**
+	 * Gets the number of requests that were rejected.
+	 * @return The number of requests rejected.
+	 */
+	size_t num_rejected() const { return nRejected_; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A rate limiter with a single limit shared by all callers.
+ */
+class rate_limiter : public rate_limiter_base
+{
+	/** Lock for the bucket */
+	std::mutex lock_;
+	/** The token bucket */
+	token_bucket bkt_;
+
+	/** Simple, scope-based lock guard */
+	using guard = std::lock_guard<std::mutex>;
+
+public:
+	/**
+	 * Creates a rate limiter.
+	 * @param opts The configuration.
+	 */
+	explicit rate_limiter(const limit_options& opts)
+		: rate_limiter_base(opts), bkt_(opts.rate, opts.burst) {}
+	/**
+	 * Checks whether a request can go through.
+	 * In delay mode this can put the calling thread to sleep.
+	 * @return @em true if the request can go through, @em false if it
+	 *  	   was rejected.
+	 */
+	bool admit() {
+		std::chrono::nanoseconds delay;
+		{
+			guard g(lock_);
+			if (!take(bkt_, &delay))
+				return false;
+		}
+		return admitted(delay);
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A rate limiter with a separate limit for each caller.
+ *
+ * Each caller is identified by a key, such as a client ID or address, and
+ * gets its own token bucket. This keeps a few misbehaving clients from
+ * using up the capacity for all the others. Buckets that have filled back
+ * up are discarded from time to time, so the memory use is proportional
+ * to the number of recently active callers.
+ *
+ * @param Key The type used to identify the callers.
+ * @param Hash The hash function for the keys.
+ */
+template <typename Key, class Hash=std::hash<Key>>
+class keyed_rate_limiter : public rate_limiter_base
+{
+public:
+	/** The type used to identify the callers */
+	using key_type = Key;
+
+private:
+	/** Lock for the buckets */
+	std::mutex lock_;
+	/** The token buckets for the callers */
+	std::unordered_map<Key, token_bucket, Hash> bkts_;
+	/** The number of buckets at which to prune the full ones */
+	size_t pruneSize_;
+
+	/** The smallest number of buckets worth pruning */
+	static constexpr size_t MIN_PRUNE_SIZE = 1024;
+
+	/** Simple, scope-based lock guard */
+	using guard = std::lock_guard<std::mutex>;
+
+	/** Discards the buckets that are full. The lock must be held. */
+	void prune() {
+		auto now = token_bucket::clock::now();
+		for (auto p = bkts_.begin(); p != bkts_.end(); ) {
+			if (p->second.full(now))
+				p = bkts_.erase(p);
+			else
+				++p;
+		}
+		pruneSize_ = std::max(MIN_PRUNE_SIZE, 2*bkts_.size());
+	}
+
+public:
+	/**
+	 * Creates a rate limiter.
+	 * @param opts The configuration for each caller.
+	 */
+	explicit keyed_rate_limiter(const limit_options& opts)
+		: rate_limiter_base(opts), pruneSize_(MIN_PRUNE_SIZE) {}
+	/**
+	 * Gets the number of callers that are currently being tracked.
+	 * @return The number of callers that are currently being tracked.
+	 */
+	size_t size() {
+		guard g(lock_);
+		return bkts_.size();
+	}
+	/**
+	 * Checks whether a request from the caller can go through.
+	 * In delay mode this can put the calling thread to sleep.
+	 * @param key The key for the caller.
+	 * @return @em true if the request can go through, @em false if it
+	 *  	   was rejected.
+	 */
+	bool admit(const key_type& key) {
+		std::chrono::nanoseconds delay;
+		{
+			guard g(lock_);
+			auto p = bkts_.find(key);
+			if (p == bkts_.end()) {
+				if (bkts_.size() >= pruneSize_)
+					prune();
+				p = bkts_.emplace(key, token_bucket(opts_.rate, opts_.burst)).first;
+			}
+			if (!take(p->second, &delay))
+				return false;
+		}
+		return admitted(delay);
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Base class for an actor that limits the rate of incoming messages.
+ *
+ * The limit is applied when a message is sent, in the context of the
+ * sender, before it is queued to the actor. So, an overload is throttled
+ * at the entry point rather than turning into an ever-growing queue.
+ * In reject mode the message is dropped, and in delay mode the sender is
+ * held back.
+ *
+ * @par
+ * In delay mode, the sender's thread sleeps. If the sender is itself an
+ * actor, that holds up every actor on its work thread, so delay mode is
+ * meant for senders outside of the actor system, like client threads.
+ *
+ * @param Limiter The type of limiter, either @ref rate_limiter for a
+ *  			  limit on all the senders, or @ref keyed_rate_limiter for
+ *  			  a limit on each sender.
+ */
+template <class Limiter=rate_limiter>
+class rate_limited_actor : public actor
+{
+	/** The rate limiter */
+	Limiter lim_;
+
+protected:
+	/**
+	 * Sends a task to run in the actor thread asynchronously, if it is
+	 * within the global limit.
+	 * @param f The function object for the thread to execute.
+	 * @return @em true if the task was queued, @em false if it was
+	 *  	   rejected by the limiter.
+	 */
+	template <class Func>
+	bool cast(Func&& f) {
+		if (!lim_.admit())
+			return false;
+		actor::cast(std::forward<Func>(f));
+		return true;
+	}
+	/**
+	 * Sends a task to run in the actor thread asynchronously, if it is
+	 * within the limit for the sender.
+	 * @param from The key for the sender.
+	 * @param f The function object for the thread to execute.
+	 * @return @em true if the task was queued, @em false if it was
+	 *  	   rejected by the limiter.
+	 */
+	template <class Key, class Func>
+	bool cast_from(const Key& from, Func&& f) {
+		if (!lim_.admit(from))
+			return false;
+		actor::cast(std::forward<Func>(f));
+		return true;
+	}
+
+public:
+	/**
+	 * Creates an actor with a rate limit.
+	 * @param opts The configuration for the limiter.
+	 */
+	explicit rate_limited_actor(const limit_options& opts) : lim_(opts) {}
+	/**
+	 * Creates an actor with a rate limit on a specific thread.
+	 * @param thr The thread for the actor.
+	 * @param opts The configuration for the limiter.
+	 */
+	rate_limited_actor(work_thread& thr, const limit_options& opts)
+		: actor(thr), lim_(opts) {}
+	/**
+	 * Gets the rate limiter for the actor.
+	 * This can be used to read the counters.
+	 * @return The rate limiter for the actor.
+	 */
+	Limiter& limiter() { return lim_; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_rate_limit_h
@@ -0,0 +1,476 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file reactive.h
+/// Incremental reactive cells for actors
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef __cooper_reactive_h
+#define __cooper_reactive_h
+
+#include "cooper/actor.h"
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace cooper {
+
+class reactive_actor;
+class observer;
+
+namespace detail {
+
+/** Determines if a type can be compared with == */
+template <typename T, typename=void>
+struct is_equality_comparable : std::false_type {};
+
+template <typename T>
+struct is_equality_comparable<T,
+		std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>>
+	: std::true_type {};
+
+/**
+ * Compares two values, if the type supports it.
+ * @return @em true if the values are known to be equal, @em false if they
+ *  	   differ, or can't be compared.
+ */
+template <typename T>
+bool same_value(const T& a, const T& b) {
+	if constexpr (is_equality_comparable<T>::value)
+		return a == b;
+	else
+		return false;
+}
+
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Base class for the reactive cells.
+ *
+ * The cells of an actor form a graph. Each one knows the cells that it
+ * reads, its inputs, and the ones that read it, its dependents. When an
+ * input cell changes, its dependents are marked dirty, all the way down
+ * the graph, but nothing is recomputed. That happens lazily, when a dirty
+ * cell is read. It first brings its inputs up to date, and then only
+ * recomputes if one of them actually changed value since it was last
+ * computed. So a change that is cut off part of the way, because a cell
+ * recomputes to the same value as before, goes no further.
+ *
+ * All the cells belong to a single @ref reactive_actor, and must only be
+ * used in that actor's thread.
+ */
+class cell_base
+{
+	/** The cells that this one reads */
+	std::vector<cell_base*> inputs_;
+	/** The cells that read this one */
+	std::vector<cell_base*> dependents_;
+
+	friend class reactive_actor;
+	template <typename T> friend class derived_cell;
+	friend class observer;
+
+protected:
+	/** The actor that owns the cell */
+	reactive_actor& owner_;
+	/** Whether the cell might be out of date */
+	bool dirty_;
+	/** The update epoch when the value last changed */
+	uint64_t changedAt_;
+	/** The update epoch when the value was last brought up to date */
+	uint64_t verifiedAt_;
+
+	/**
+	 * Creates a cell.
+	 * @param owner The actor that owns the cell.
+	 * @param inputs The cells that this one reads.
+	 */
+	cell_base(reactive_actor& owner, std::vector<cell_base*> inputs);
+	/**
+	 * Removes the cell from the graph.
+	 */
+	virtual ~cell_base();
+	/**
+	 * Marks the cell and all of its dependents as dirty.
+	 * A dirty cell's dependents are already dirty, so this stops there.
+	 */
+	void mark_dirty();
+	/** Marks all the dependents of the cell as dirty */
+	void mark_dependents_dirty() {
+		for (auto dep : dependents_)
+			dep->mark_dirty();
+	}
+	/**
+	 * Brings the inputs up to date.
+	 * @return @em true if any of them changed since this cell was last
+	 *  	   brought up to date.
+	 */
+	bool refresh_inputs() {
+		bool changed = false;
+		for (auto in : inputs_) {
+			in->refresh();
+			if (in->changedAt_ > verifiedAt_)
+				changed = true;
+		}
+		return changed;
+	}
+	/**
+	 * Brings the cell up to date, if it's dirty.
+	 */
+	virtual void refresh() {}
+
+	// Non-copyable
+	cell_base(const cell_base&) =delete;
+	cell_base& operator=(const cell_base&) =delete;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * An actor that keeps reactive cells.
+ *
+ * The actor declares its cells as members, inputs first, each listing the
+ * cells that it reads. Its message handlers set the input cells, and read
+ * the derived ones, which are only recomputed as needed.
+ *
+ * Any @ref observer cells, which have side effects rather than values,
+ * run once at the end of a burst of updates. The first change to an input
+ * after the observers last ran queues a task to the actor's thread to run
+ * them, so all the updates that are already queued to the actor are
+ * handled before it, and the observers see them all at once.
+ */
+class reactive_actor : public actor
+{
+	/** The update epoch, which counts changes to the input cells */
+	uint64_t epoch_;
+	/** Whether a task is queued to run the observers */
+	bool flushPending_;
+	/** The observer cells */
+	std::vector<observer*> observers_;
+	/** The number of times the observers were flushed */
+	size_t nFlush_;
+
+	friend class cell_base;
+	template <typename T> friend class input_cell;
+	template <typename T> friend class derived_cell;
+	friend class observer;
+
+	/** Called when an input cell changes */
+	void changed();
+
+protected:
+	/**
+	 * Runs any observers whose inputs changed.
+	 * This normally happens at the end of a burst of updates, but the
+	 * actor can call it to run them right away.
+	 */
+	void flush();
+
+public:
+	/**
+	 * Creates an actor.
+	 */
+	reactive_actor() : epoch_(0), flushPending_(false), nFlush_(0) {}
+	/**
+	 * Creates an actor on a specific thread.
+	 * @param thr The thread for the actor.
+	 */
+	explicit reactive_actor(work_thread& thr)
+		: actor(thr), epoch_(0), flushPending_(false), nFlush_(0) {}
+	/**
+	 * Gets the number of times that the observers were flushed.
+	 * This must be called in the actor's thread.
+	 * @return The number of times that the observers were flushed.
+	 */
+	size_t num_flushes() const { return nFlush_; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A reactive cell with a value that is set directly.
+ *
+ * Setting the cell to a value that compares equal to the current one does
+ * nothing.
+ *
+ * @param T The type of value.
+ */
+template <typename T>
+class input_cell : public cell_base
+{
+	/** The value */
+	T val_;
+
+public:
+	/**
+	 * Creates an input cell.
+	 * @param owner The actor that owns the cell.
+	 * @param val The initial value.
+	 */
+	input_cell(reactive_actor& owner, T val={})
+		: cell_base(owner, {}), val_(std::move(val)) {}
+	/**
+	 * Gets the value.
+	 * @return A reference to the value.
+	 */
+	const T& get() const { return val_; }
+	/**
+	 * Sets the value.
+	 * If it changed, this marks all the dependent cells dirty.
+	 * @param val The new value.
+	 */
+	void set(T val) {
+		if (detail::same_value(val, val_))
+			return;
+		val_ = std::move(val);
+		changedAt_ = ++owner_.epoch_;
+		mark_dependents_dirty();
+		owner_.changed();
+	}
+	/**
+	 * Modifies the value in place.
+	 * The cell is assumed to have changed.
+	 * @param f A function that is passed a reference to the value.
+	 */
+	template <class Func>
+	void modify(Func f) {
+		f(val_);
+		changedAt_ = ++owner_.epoch_;
+		mark_dependents_dirty();
+		owner_.changed();
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A reactive cell with a value that is computed from other cells.
+ *
+ * The value is only recomputed when it's read, and only if one of the
+ * input cells changed since the last time.
+ *
+ * @param T The type of value.
+ */
+template <typename T>
+class derived_cell : public cell_base
+{
+	/** The function to compute the value */
+	std::function<T()> func_;
+	/** The value, once it's been computed */
+	std::optional<T> val_;
+	/** The number of times that the value was computed */
+	size_t nCompute_;
+
+	void refresh() override {
+		if (!dirty_)
+			return;
+		bool stale = refresh_inputs() || !val_;
+		if (stale) {
+			T val = func_();
+			++nCompute_;
+			if (!val_ || !detail::same_value(val, *val_)) {
+				val_ = std::move(val);
+				changedAt_ = owner_.epoch_;
+			}
+		}
+		verifiedAt_ = owner_.epoch_;
+		dirty_ = false;
+	}
+
+public:
+	/**
+	 * Creates a derived cell.
+	 * @param owner The actor that owns the cell.
+	 * @param f The function to compute the value. It should only read the
+	 *  		cells listed as inputs.
+	 * @param inputs The cells that the function reads.
+	 */
+	template <class... Cells>
+	derived_cell(reactive_actor& owner, std::function<T()> f, Cells&... inputs)
+		: cell_base(owner, { static_cast<cell_base*>(&inputs)... }),
+			func_(std::move(f)), nCompute_(0) {
+		dirty_ = true;
+	}
+	/**
+	 * Gets the value, recomputing it if needed.
+	 * @return A reference to the value.
+	 */
+	const T& get() {
+		refresh();
+		return *val_;
+	}
+	/**
+	 * Determines if the cell might be out of date.
+	 * @return @em true if the cell might need to be recomputed, @em false
+	 *  	   if the value is current.
+	 */
+	bool dirty() const { return dirty_; }
+	/**
+	 * Gets the number of times that the value was computed.
+	 * @return The number of times that the value was computed.
+	 */
+	size_t num_computes() const { return nCompute_; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A reactive cell that runs a function for its side effects when any of
+ * its inputs change.
+ *
+ * Observers run at the end of a burst of updates to the actor, once, no
+ * matter how many times their inputs changed in the burst.
+ */
+class observer : public cell_base
+{
+	/** The function to run */
+	std::function<void()> func_;
+	/** The number of times that the function ran */
+	size_t nRun_;
+
+	friend class reactive_actor;
+
+	void refresh() override;
+
+public:
+	/**
+	 * Creates an observer.
+	 * The function first runs at the first flush after this is created.
+	 * @param owner The actor that owns the cell.
+	 * @param f The function to run.
+	 * @param inputs The cells that the function reads.
+	 */
+	template <class... Cells>
+	observer(reactive_actor& owner, std::function<void()> f, Cells&... inputs)
+		: cell_base(owner, { static_cast<cell_base*>(&inputs)... }),
+			func_(std::move(f)), nRun_(0) {
+		dirty_ = true;
+		owner_.observers_.push_back(this);
+	}
+	/**
+	 * Removes the observer from the actor.
+	 */
+	~observer();
+	/**
+	 * Gets the number of times that the function ran.
+	 * @return The number of times that the function ran.
+	 */
+	size_t num_runs() const { return nRun_; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+inline cell_base::cell_base(reactive_actor& owner, std::vector<cell_base*> inputs)
+	: inputs_(std::move(inputs)), owner_(owner), dirty_(false),
+		changedAt_(owner.epoch_), verifiedAt_(owner.epoch_)
+{
+	for (auto in : inputs_)
+		in->dependents_.push_back(this);
+}
+
+inline cell_base::~cell_base()
+{
+	for (auto in : inputs_) {
+		auto& deps = in->dependents_;
+		deps.erase(std::remove(deps.begin(), deps.end(), this), deps.end());
+	}
+}
+
+inline void cell_base::mark_dirty()
+{
+	if (dirty_)
+		return;
+	dirty_ = true;
+	mark_dependents_dirty();
+}
+
+// --------------------------------------------------------------------------
+// A flush is queued behind any updates that are already in the actor's
+// queue, so the observers see the whole burst at once.
+
+inline void reactive_actor::changed()
+{
+	if (flushPending_ || observers_.empty())
+		return;
+	flushPending_ = true;
+	try {
+		cast([this] { flush(); });
+	}
+	catch (...) {
+		flushPending_ = false;
+		throw;
+	}
+}
+
+inline void reactive_actor::flush()
+{
+	flushPending_ = false;
+	++nFlush_;
+	for (size_t i=0; i<observers_.size(); ++i)
+		observers_[i]->refresh();
+}
+
+inline void observer::refresh()
+{
+	if (!dirty_)
+		return;
+	if (refresh_inputs() || nRun_ == 0) {
+		func_();
+		++nRun_;
+	}
+	verifiedAt_ = owner_.epoch_;
+	dirty_ = false;
+}
+
+inline observer::~observer()
+{
+	auto& obs = owner_.observers_;
+	obs.erase(std::remove(obs.begin(), obs.end(), this), obs.end());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_reactive_h
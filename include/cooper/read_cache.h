@@ -0,0 +1,384 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file read_cache.h
+/// Client-side caching of the results of actor reads
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef __cooper_read_cache_h
+#define __cooper_read_cache_h
+
+#include "cooper/actor.h"
+#include "cooper/sync.h"
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+#include <utility>
+#include <atomic>
+#include <mutex>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A version counter for the state of an actor, used to validate cached
+ * reads of that state.
+ *
+ * This is really two counters. Clients bump the @em issued count when they
+ * send a write, and the actor bumps the @em applied count, in its own
+ * thread, after the write is done. When the two are equal, there are no
+ * writes in the actor's queue, and the applied count identifies the
+ * current state. A cached read that was taken at that version is still
+ * valid. When they differ, a write is on its way, and reads have to go
+ * through the actor's queue, behind it, to see its effect.
+ */
+class cache_version
+{
+	/** The number of writes sent to the actor */
+	std::atomic<uint64_t> issued_;
+	/** The number of writes the actor has completed */
+	std::atomic<uint64_t> applied_;
+
+public:
+	/**
+	 * Creates a version counter, starting at zero.
+	 */
+	cache_version() : issued_(0), applied_(0) {}
+	/**
+	 * Marks the start of a write.
+	 * This is called by the client before the write is queued to the
+	 * actor, so that the cached reads are invalidated right away.
+	 */
+	void begin_write() { issued_.fetch_add(1, std::memory_order_acq_rel); }
+	/**
+	 * Marks the end of a write.
+	 * This is called in the actor thread after the write was applied.
+	 */
+	void end_write() { applied_.fetch_add(1, std::memory_order_release); }
+	/**
+	 * Marks a change to the state that was not sent as a write.
+	 * This is called in the actor thread.
+	 */
+	void bump() {
+		begin_write();
+		end_write();
+	}
+	/**
+	 * Gets the version of the state that was last applied.
+	 * @return The version of the state that was last applied.
+	 */
+	uint64_t current() const { return applied_.load(std::memory_order_acquire); }
+	/**
+	 * Gets the current version if there are no writes in progress.
+	 * The applied count is read first. Since it never passes the issued
+	 * count, if the issued count then matches it, there were no writes in
+	 * progress at the time of the first read.
+	 * @param ver Pointer to a variable to get the version.
+	 * @return @em true if there are no writes in progress, @em false if
+	 *  	   there are.
+	 */
+	bool stable(uint64_t* ver) const {
+		uint64_t applied = applied_.load(std::memory_order_acquire);
+		if (issued_.load(std::memory_order_acquire) != applied)
+			return false;
+		*ver = applied;
+		return true;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A cache of the results of reads from an actor, tagged by version.
+ *
+ * An entry is only returned if it was taken at the version that it's
+ * looked up with, so stale entries are just ignored, and are replaced
+ * when the result is read again. When the cache fills up, the stale
+ * entries are dropped, and if that doesn't make room, it's cleared.
+ *
+ * A cache can be shared by all the clients of an actor, which is the
+ * default, or it can be private to a single thread, using a
+ * sync::null_mutex for the lock, so that hits don't touch any shared
+ * memory other than the actor's version counter. Either way, a cache must
+ * only be used with one actor.
+ *
+ * @param Key The type of key for the reads.
+ * @param T The type of the read result. It must be copyable and default
+ *  		constructible.
+ * @param Hash The hash function for the key.
+ * @param Mutex The type of lock for the cache.
+ */
+template <typename Key, typename T, class Hash=std::hash<Key>,
+		  class Mutex=std::mutex>
+class read_cache
+{
+public:
+	/** The type of key for the reads */
+	using key_type = Key;
+	/** The type of the read result */
+	using value_type = T;
+
+private:
+	/** A cached result and the version at which it was read */
+	struct entry {
+		uint64_t ver;
+		T val;
+	};
+
+	/** Object lock */
+	mutable Mutex lock_;
+	/** The cached entries */
+	std::unordered_map<Key, entry, Hash> entries_;
+	/** The maximum number of entries */
+	size_t maxSize_;
+	/** The number of lookups that found a valid entry */
+	size_t nHit_;
+	/** The number of lookups that didn't */
+	size_t nMiss_;
+
+	/** Simple, scope-based lock guard */
+	using guard = std::lock_guard<Mutex>;
+
+public:
+	/**
+	 * Creates a cache.
+	 * @param maxSize The maximum number of entries to keep.
+	 */
+	explicit read_cache(size_t maxSize=1024)
+		: maxSize_(std::max<size_t>(maxSize, 1)), nHit_(0), nMiss_(0) {}
+	/**
+	 * Looks up a result that was read at a specific version.
+	 * @param key The key for the read.
+	 * @param ver The version of the actor's state.
+	 * @param val Pointer to a variable to get the result.
+	 * @return @em true if a result was found for that version, @em false
+	 *  	   if not.
+	 */
+	bool find(const Key& key, uint64_t ver, T* val) {
+		guard g(lock_);
+		auto p = entries_.find(key);
+		if (p == entries_.end() || p->second.ver != ver) {
+			++nMiss_;
+			return false;
+		}
+		*val = p->second.val;
+		++nHit_;
+		return true;
+	}
+	/**
+	 * Puts a result into the cache.
+	 * This doesn't replace an entry that was read at a later version.
+	 * @param key The key for the read.
+	 * @param ver The version of the actor's state when it was read.
+	 * @param val The result.
+	 */
+	void insert(const Key& key, uint64_t ver, const T& val) {
+		guard g(lock_);
+		auto p = entries_.find(key);
+		if (p != entries_.end()) {
+			if (p->second.ver <= ver)
+				p->second = entry{ ver, val };
+			return;
+		}
+		if (entries_.size() >= maxSize_) {
+			for (auto q = entries_.begin(); q != entries_.end(); ) {
+				if (q->second.ver < ver)
+					q = entries_.erase(q);
+				else
+					++q;
+			}
+			if (entries_.size() >= maxSize_)
+				entries_.clear();
+		}
+		entries_.emplace(key, entry{ ver, val });
+	}
+	/**
+	 * Removes all the entries.
+	 */
+	void clear() {
+		guard g(lock_);
+		entries_.clear();
+	}
+	/**
+	 * Gets the number of entries, including any stale ones.
+	 * @return The number of entries.
+	 */
+	size_t size() const {
+		guard g(lock_);
+		return entries_.size();
+	}
+	/**
+	 * Gets the number of lookups that found a valid entry.
+	 * @return The number of cache hits.
+	 */
+	size_t num_hits() const {
+		guard g(lock_);
+		return nHit_;
+	}
+	/**
+	 * Gets the number of lookups that didn't find a valid entry.
+	 * @return The number of cache misses.
+	 */
+	size_t num_misses() const {
+		guard g(lock_);
+		return nMiss_;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Base class for an actor whose reads can be served from a cache.
+ *
+ * The actor sends its state changes through write() or call_write(),
+ * which keep a @ref cache_version, and its reads through read(), which
+ * checks a @ref read_cache first. A read is only served from the cache
+ * when no writes are queued or running, and the cached result was read at
+ * the current version, so a hit returns exactly what a call() would have.
+ * In particular, a client always sees its own writes, even ones that it
+ * sent with a cast.
+ *
+ * A hit never touches the actor's queue. A miss is a call() to the actor,
+ * which reads the result along with the version, in the actor thread.
+ *
+ * @par
+ * Any other change to the state that affects the reads, like one from a
+ * plain cast() or a timer, must call invalidate() in the actor thread.
+ */
+class cached_actor : public actor
+{
+	/** The version of the actor's state */
+	cache_version ver_;
+
+	/** Ends a write when it's destroyed, even if it was discarded */
+	struct write_guard {
+		cache_version* ver;
+		explicit write_guard(cache_version* ver) : ver(ver) {}
+		write_guard(write_guard&& other) : ver(other.ver) { other.ver = nullptr; }
+		~write_guard() { if (ver) ver->end_write(); }
+	};
+
+protected:
+	/**
+	 * Sends a task that changes the actor's state to run asynchronously.
+	 * This invalidates the cached reads right away.
+	 * @param f The function object for the thread to execute.
+	 */
+	template <class Func>
+	void write(Func f) {
+		ver_.begin_write();
+		write_guard wg(&ver_);
+		actor::cast([wg=std::move(wg), f=std::move(f)]() mutable {
+			auto g = std::move(wg);
+			f();
+		});
+	}
+	/**
+	 * Blocking call to a task that changes the actor's state.
+	 * This invalidates the cached reads right away.
+	 * @param f The function object for the thread to execute.
+	 * @return The task's return value.
+	 * @throws Any exception thrown by the task.
+	 */
+	template <class Func>
+	typename std::invoke_result_t<Func> call_write(Func f) {
+		ver_.begin_write();
+		write_guard wg(&ver_);
+		return actor::call([wg=std::move(wg), f=std::move(f)]() mutable {
+			auto g = std::move(wg);
+			return f();
+		});
+	}
+	/**
+	 * Reads from the actor's state, using a cached result if it's still
+	 * valid.
+	 * @param cache The cache for this type of read.
+	 * @param key The key for the read.
+	 * @param f The function object to do the read in the actor thread.
+	 * @return The result of the read.
+	 * @throws Any exception thrown by the read.
+	 */
+	template <class Cache, class Func>
+	typename Cache::value_type read(Cache& cache,
+									const typename Cache::key_type& key,
+									Func f) {
+		using value_type = typename Cache::value_type;
+
+		uint64_t ver;
+		value_type val;
+		if (ver_.stable(&ver) && cache.find(key, ver, &val))
+			return val;
+
+		auto res = actor::call([this, f=std::move(f)]() mutable {
+			return std::make_pair(f(), ver_.current());
+		});
+		cache.insert(key, res.second, res.first);
+		return std::move(res.first);
+	}
+	/**
+	 * Invalidates the cached reads after a change to the actor's state
+	 * that wasn't done by write() or call_write().
+	 * This must be called in the actor thread.
+	 */
+	void invalidate() { ver_.bump(); }
+
+public:
+	/**
+	 * Creates an actor.
+	 */
+	cached_actor() =default;
+	/**
+	 * Creates an actor on a specific thread.
+	 * @param thr The thread for the actor.
+	 */
+	explicit cached_actor(work_thread& thr) : actor(thr) {}
+	/**
+	 * Gets the version of the actor's state.
+	 * This is the number of writes that the actor has applied.
+	 * @return The version of the actor's state.
+	 */
+	uint64_t version() const { return ver_.current(); }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_read_cache_h
@@ -0,0 +1,328 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file registry.h
+/// Implementation of the class 'registry'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#ifndef __cooper_registry_h
+#define __cooper_registry_h
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A concurrent map of keys to actor handles with lock-free lookups.
+ *
+ * This is meant for routing requests to actors by name or ID on a hot
+ * path, where the lookups vastly outnumber the updates. Readers never take
+ * a lock. They find the current, immutable, snapshot of the map through an
+ * atomic pointer and search it directly.
+ *
+ * Updates are done in an RCU (read-copy-update) style. Writers are
+ * serialized with a mutex. Each one copies the current map, modifies the
+ * copy, and then atomically publishes it as the new snapshot. The old
+ * snapshot is destroyed only after a grace period in which all the readers
+ * that might still be looking at it have finished. Readers announce
+ * themselves by incrementing one of two counters, selected by the current
+ * epoch. A writer flips the epoch twice, waiting each time for the
+ * counter for the previous epoch to drain to zero.
+ *
+ * @par
+ * So, updates are relatively expensive - O(n) in the size of the map, plus
+ * the wait for the grace period. Batches of changes should be made with a
+ * single call to update() to pay that cost only once.
+ *
+ * @par
+ * The handles are returned to the readers by value, so they should be
+ * cheap to copy, like a raw or shared pointer to the actor.
+ *
+ * @param Key The type of the key used to find the actors, such as a
+ *  		  string name or numeric ID.
+ * @param Handle The type of the handle to the actor, such as
+ *  			 std::shared_ptr<my_actor>
+ * @param Map The type of map to use for the snapshots.
+ */
+template <typename Key, typename Handle,
+		  class Map=std::unordered_map<Key,Handle>>
+class registry
+{
+public:
+	/** The type of the key used to find the actors */
+	using key_type = Key;
+	/** The type of handle stored in the registry */
+	using handle_type = Handle;
+	/** The type of the map used for the snapshots */
+	using map_type = Map;
+	/** The type used to specify number of items in the map. */
+	using size_type = typename Map::size_type;
+
+private:
+	/** The current snapshot. Only replaced under the writer lock. */
+	std::atomic<const map_type*> snap_;
+	/** The read epoch. The low bit selects the reader counter. */
+	std::atomic<unsigned> epoch_;
+	/** The number of active readers in each of the two epochs. */
+	mutable std::atomic<size_t> nReader_[2];
+	/** Lock to serialize the writers */
+	std::mutex lock_;
+
+	/** Simple, scope-based lock guard */
+	using guard = std::lock_guard<std::mutex>;
+
+	/**
+	 * Scope-based read-side critical section.
+	 * While this exists, the snapshot that it loaded will not be destroyed.
+	 */
+	class reader
+	{
+		std::atomic<size_t>& cnt_;
+		const map_type* snap_;
+
+	public:
+		reader(const registry& reg)
+			: cnt_(reg.nReader_[reg.epoch_.load() & 1]) {
+			++cnt_;
+			snap_ = reg.snap_.load();
+		}
+		~reader() { --cnt_; }
+		const map_type& map() const { return *snap_; }
+	};
+
+	/**
+	 * Waits until no reader can still be using a snapshot that was
+	 * replaced before this call.
+	 */
+	void synchronize() {
+		for (int i=0; i<2; ++i) {
+			auto& cnt = nReader_[epoch_.fetch_add(1) & 1];
+			while (cnt.load() != 0)
+				std::this_thread::yield();
+		}
+	}
+	/**
+	 * Publishes a new snapshot and destroys the old one once it is no
+	 * longer in use.
+	 * The writer lock must be held.
+	 */
+	void publish(std::unique_ptr<const map_type> snap) {
+		std::unique_ptr<const map_type> old{ snap_.exchange(snap.release()) };
+		synchronize();
+	}
+
+	// Non-copyable
+	registry(const registry&) =delete;
+	registry& operator=(const registry&) =delete;
+
+public:
+	/**
+	 * Creates an empty registry.
+	 */
+	registry() : snap_{new map_type}, epoch_{0}, nReader_{{0}, {0}} {}
+	/**
+	 * Destroys the registry.
+	 * There should be no readers or writers using the object.
+	 */
+	~registry() { delete snap_.load(); }
+	/**
+	 * Determines if the registry is empty.
+	 * @return @em true if there are no actors in the registry, @em false
+	 *  	   otherwise.
+	 */
+	bool empty() const {
+		reader r(*this);
+		return r.map().empty();
+	}
+	/**
+	 * Gets the number of actors in the registry.
+	 * @return The number of actors in the registry.
+	 */
+	size_type size() const {
+		reader r(*this);
+		return r.map().size();
+	}
+	/**
+	 * Determines if there is an actor registered with the specified key.
+	 * This does not take a lock.
+	 * @param key The key to search for.
+	 * @return @em true if an actor is registered under the key, @em false
+	 *  	   if not.
+	 */
+	bool contains(const key_type& key) const {
+		reader r(*this);
+		return r.map().find(key) != r.map().end();
+	}
+	/**
+	 * Looks up the actor registered with the specified key.
+	 * This does not take a lock.
+	 * @param key The key to search for.
+	 * @return A copy of the handle of the registered actor, if found,
+	 *  	   otherwise @em nullopt.
+	 */
+	std::optional<handle_type> find(const key_type& key) const {
+		reader r(*this);
+		auto p = r.map().find(key);
+		if (p == r.map().end())
+			return {};
+		return { p->second };
+	}
+	/**
+	 * Looks up the actor registered with the specified key.
+	 * This does not take a lock.
+	 * @param key The key to search for.
+	 * @param h Pointer to a variable to receive the handle.
+	 * @return @em true if the actor was found, @em false if not.
+	 */
+	bool find(const key_type& key, handle_type* h) const {
+		reader r(*this);
+		auto p = r.map().find(key);
+		if (p == r.map().end())
+			return false;
+		*h = p->second;
+		return true;
+	}
+	/**
+	 * Registers an actor under the specified key, if the key is not
+	 * already in use.
+	 * @param key The key for the actor.
+	 * @param h The handle to the actor.
+	 * @return @em true if the actor was added, @em false if the key was
+	 *  	   already in use.
+	 */
+	bool insert(const key_type& key, handle_type h) {
+		bool added = false;
+		update([&](map_type& m) {
+			added = m.emplace(key, std::move(h)).second;
+		});
+		return added;
+	}
+	/**
+	 * Registers an actor under the specified key, replacing any actor that
+	 * was previously registered with it.
+	 * @param key The key for the actor.
+	 * @param h The handle to the actor.
+	 */
+	void insert_or_assign(const key_type& key, handle_type h) {
+		update([&](map_type& m) {
+			m.insert_or_assign(key, std::move(h));
+		});
+	}
+	/**
+	 * Removes the actor registered with the specified key.
+	 * @param key The key to remove.
+	 * @return @em true if an actor was removed, @em false if the key was
+	 *  	   not found.
+	 */
+	bool erase(const key_type& key) {
+		guard g(lock_);
+		const map_type& cur = *snap_.load();
+		if (cur.find(key) == cur.end())
+			return false;
+
+		std::unique_ptr<map_type> snap{ new map_type(cur) };
+		snap->erase(key);
+		publish(std::move(snap));
+		return true;
+	}
+	/**
+	 * Removes all the actors from the registry.
+	 */
+	void clear() {
+		guard g(lock_);
+		publish(std::make_unique<map_type>());
+	}
+	/**
+	 * Applies an arbitrary set of changes to the registry in a single
+	 * update.
+	 * The function is called with a private copy of the current map, which
+	 * it can modify as it sees fit. When it returns, the copy is published
+	 * as the new snapshot. Readers will see all the changes at once, or
+	 * none of them.
+	 * @param f A function with the signature void(map_type&)
+	 */
+	template <typename Func>
+	void update(Func f) {
+		guard g(lock_);
+		std::unique_ptr<map_type> snap{ new map_type(*snap_.load()) };
+		f(*snap);
+		publish(std::move(snap));
+	}
+	/**
+	 * Calls a function with each of the registered actors.
+	 * This iterates over a consistent snapshot of the registry without
+	 * taking a lock, but it does delay any writers until it completes, so
+	 * the function should be quick.
+	 * @param f A function with the signature void(const key_type&, const
+	 *  		handle_type&)
+	 */
+	template <typename Func>
+	void for_each(Func f) const {
+		reader r(*this);
+		for (const auto& [key, h] : r.map())
+			f(key, h);
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A registry to find shared actors by name.
+ */
+template <typename T>
+using actor_registry = registry<std::string, std::shared_ptr<T>>;
+
+/**
+ * A registry to find shared actors by numeric ID.
+ */
+template <typename T>
+using actor_id_registry = registry<uint64_t, std::shared_ptr<T>>;
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_registry_h
@@ -0,0 +1,305 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file ring_buffer.h
+/// Implementation of the class 'ring_buffer'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_ring_buffer_h
+#define __cooper_ring_buffer_h
+
+#include <memory>
+#include <utility>
+#include <algorithm>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A growable circular buffer that can be used as a FIFO container.
+ *
+ * This supports the operations needed to act as the underlying container
+ * of a std::queue, and thus of a @ref thread_queue, but unlike a
+ * std::deque, it keeps a single block of memory which is only released
+ * when explicitly requested. Once the buffer has grown to the size needed
+ * for a queue, items can be pushed and popped with no further memory
+ * allocations. And the memory can be reserved in advance, to keep the
+ * allocations out of the critical path entirely.
+ *
+ * When full, the capacity doubles.
+ *
+ * @param T The type of the items held in the buffer. This only needs to be
+ *  		move-constructible.
+ * @param Alloc The allocator for the buffer memory.
+ */
+template <typename T, class Alloc=std::allocator<T>>
+class ring_buffer
+{
+public:
+	/** The type of items held in the buffer */
+	using value_type = T;
+	/** The allocator for the buffer memory */
+	using allocator_type = Alloc;
+	/** The type used to specify the number of items in the buffer */
+	using size_type = size_t;
+	/** Reference to an item in the buffer */
+	using reference = T&;
+	/** Const reference to an item in the buffer */
+	using const_reference = const T&;
+
+	/** The smallest capacity allocated when the buffer needs to grow */
+	static constexpr size_type MIN_CAPACITY = 16;
+
+private:
+	using traits = std::allocator_traits<Alloc>;
+
+	/** The allocator */
+	Alloc alloc_;
+	/** The memory for the items */
+	T* buf_;
+	/** The number of items that fit in the memory */
+	size_type cap_;
+	/** Index of the first item */
+	size_type head_;
+	/** The number of items in the buffer */
+	size_type n_;
+
+	/**
+	 * Gets the position in memory of the i'th item in the buffer.
+	 * @param i The logical index of the item from the front.
+	 * @return The physical index of the item in the memory block.
+	 */
+	size_type pos(size_type i) const {
+		i += head_;
+		return (i >= cap_) ? (i - cap_) : i;
+	}
+	/**
+	 * Moves the items into a new memory block of the specified capacity.
+	 * @param cap The new capacity. This must be at least the current size.
+	 */
+	void reallocate(size_type cap) {
+		T* buf = (cap == 0) ? nullptr : traits::allocate(alloc_, cap);
+		for (size_type i=0; i<n_; ++i) {
+			T* p = buf_ + pos(i);
+			traits::construct(alloc_, buf+i, std::move(*p));
+			traits::destroy(alloc_, p);
+		}
+		if (buf_)
+			traits::deallocate(alloc_, buf_, cap_);
+		buf_ = buf;
+		cap_ = cap;
+		head_ = 0;
+	}
+	/**
+	 * Makes room for at least one more item.
+	 */
+	void grow() {
+		if (n_ == cap_)
+			reallocate(std::max(2*cap_, MIN_CAPACITY));
+	}
+
+	// Non-copyable
+	ring_buffer(const ring_buffer&) =delete;
+	ring_buffer& operator=(const ring_buffer&) =delete;
+
+public:
+	/**
+	 * Creates an empty buffer.
+	 * This does not allocate any memory.
+	 */
+	ring_buffer() : buf_(nullptr), cap_(0), head_(0), n_(0) {}
+	/**
+	 * Creates an empty buffer with memory for the specified number of
+	 * items.
+	 * @param cap The initial capacity of the buffer.
+	 */
+	explicit ring_buffer(size_type cap) : ring_buffer() { reserve(cap); }
+	/**
+	 * Move constructor.
+	 * @param other The buffer to move into this one. It is left empty.
+	 */
+	ring_buffer(ring_buffer&& other) noexcept
+			: alloc_(std::move(other.alloc_)), buf_(other.buf_),
+				cap_(other.cap_), head_(other.head_), n_(other.n_) {
+		other.buf_ = nullptr;
+		other.cap_ = other.head_ = other.n_ = 0;
+	}
+	/**
+	 * Destroys the items and releases the memory.
+	 */
+	~ring_buffer() {
+		clear();
+		if (buf_)
+			traits::deallocate(alloc_, buf_, cap_);
+	}
+	/**
+	 * Move assignment.
+	 * @param rhs The buffer to move into this one. It is left empty.
+	 * @return A reference to this object.
+	 */
+	ring_buffer& operator=(ring_buffer&& rhs) noexcept {
+		ring_buffer tmp(std::move(rhs));
+		swap(tmp);
+		return *this;
+	}
+	/**
+	 * Swaps the contents of this buffer with another.
+	 * @param other The other buffer.
+	 */
+	void swap(ring_buffer& other) noexcept {
+		using std::swap;
+		swap(alloc_, other.alloc_);
+		swap(buf_, other.buf_);
+		swap(cap_, other.cap_);
+		swap(head_, other.head_);
+		swap(n_, other.n_);
+	}
+	/**
+	 * Determines if the buffer is empty.
+	 * @return @em true if there are no items in the buffer.
+	 */
+	bool empty() const { return n_ == 0; }
+	/**
+	 * Gets the number of items in the buffer.
+	 * @return The number of items in the buffer.
+	 */
+	size_type size() const { return n_; }
+	/**
+	 * Gets the number of items that the buffer can hold without
+	 * allocating more memory.
+	 * @return The capacity of the buffer.
+	 */
+	size_type capacity() const { return cap_; }
+	/**
+	 * Makes sure that the buffer can hold at least the specified number of
+	 * items without allocating more memory.
+	 * @param cap The minimum capacity for the buffer.
+	 */
+	void reserve(size_type cap) {
+		if (cap > cap_)
+			reallocate(cap);
+	}
+	/**
+	 * Releases any memory not needed to hold the current items.
+	 * An empty buffer will release all of its memory.
+	 */
+	void shrink_to_fit() {
+		if (n_ < cap_)
+			reallocate(n_);
+	}
+	/**
+	 * Destroys all the items in the buffer.
+	 * This keeps the memory.
+	 */
+	void clear() {
+		while (n_ != 0)
+			pop_front();
+		head_ = 0;
+	}
+	/**
+	 * Gets a reference to the first item in the buffer.
+	 * The buffer must not be empty.
+	 * @return A reference to the first item in the buffer.
+	 */
+	reference front() { return buf_[head_]; }
+	/**
+	 * Gets a reference to the first item in the buffer.
+	 * The buffer must not be empty.
+	 * @return A reference to the first item in the buffer.
+	 */
+	const_reference front() const { return buf_[head_]; }
+	/**
+	 * Gets a reference to the last item in the buffer.
+	 * The buffer must not be empty.
+	 * @return A reference to the last item in the buffer.
+	 */
+	reference back() { return buf_[pos(n_-1)]; }
+	/**
+	 * Gets a reference to the last item in the buffer.
+	 * The buffer must not be empty.
+	 * @return A reference to the last item in the buffer.
+	 */
+	const_reference back() const { return buf_[pos(n_-1)]; }
+	/**
+	 * Constructs an item in place at the back of the buffer.
+	 * @param args The arguments for the item's constructor.
+	 * @return A reference to the new item.
+	 */
+	template <typename... Args>
+	reference emplace_back(Args&&... args) {
+		grow();
+		T* p = buf_ + pos(n_);
+		traits::construct(alloc_, p, std::forward<Args>(args)...);
+		++n_;
+		return *p;
+	}
+	/**
+	 * Copies an item to the back of the buffer.
+	 * @param val The item to add.
+	 */
+	void push_back(const value_type& val) { emplace_back(val); }
+	/**
+	 * Moves an item to the back of the buffer.
+	 * @param val The item to add.
+	 */
+	void push_back(value_type&& val) { emplace_back(std::move(val)); }
+	/**
+	 * Removes the item from the front of the buffer.
+	 * The buffer must not be empty.
+	 */
+	void pop_front() {
+		traits::destroy(alloc_, buf_ + head_);
+		head_ = pos(1);
+		--n_;
+	}
+};
+
+/**
+ * Swaps the contents of two buffers.
+ */
+template <typename T, class Alloc>
+void swap(ring_buffer<T,Alloc>& a, ring_buffer<T,Alloc>& b) noexcept {
+	a.swap(b);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_ring_buffer_h
@@ -0,0 +1,520 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file simulation.h
+/// Deterministic, single-threaded simulation of actors
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_simulation_h
+#define __cooper_simulation_h
+
+#include "cooper/func_wrapper.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <random>
+#include <deque>
+#include <vector>
+#include <unordered_set>
+#include <cstdint>
+
+namespace cooper {
+
+class sim_executor;
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The virtual clock for a simulation.
+ * Time starts at zero when the simulation is created, and only advances
+ * as the simulation runs.
+ */
+struct sim_clock
+{
+	using rep = std::chrono::nanoseconds::rep;
+	using period = std::chrono::nanoseconds::period;
+	using duration = std::chrono::nanoseconds;
+	using time_point = std::chrono::time_point<sim_clock>;
+	static constexpr bool is_steady = true;
+};
+
+/**
+ * A model of how long it takes to handle a message.
+ * It is given the simulation's random number generator, so costs can be
+ * drawn from a distribution and still be reproducible.
+ */
+using cost_model = std::function<sim_clock::duration(std::mt19937_64&)>;
+
+/**
+ * Creates a cost model in which every message takes the same time.
+ * @param cost The time to handle a message.
+ * @return The cost model.
+ */
+cost_model fixed_cost(sim_clock::duration cost);
+
+/**
+ * Creates a cost model in which the time to handle a message is
+ * exponentially distributed, as in an M/M/1 queue.
+ * @param mean The mean time to handle a message.
+ * @return The cost model.
+ */
+cost_model exponential_cost(sim_clock::duration mean);
+
+/**
+ * How to order events that happen at the same virtual time.
+ */
+enum class interleave
+{
+	/** In the order they were scheduled. */
+	fifo,
+	/** In a pseudo-random order determined by the seed. */
+	random
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A simulated work thread.
+ *
+ * Like a work_thread, it runs the tasks sent to it one at a time, in
+ * order, but in the virtual time of a @ref sim_executor. Each task takes
+ * a simulated amount of time given by a cost model, during which the
+ * thread is busy and later tasks wait in its queue.
+ *
+ * This keeps statistics on the queueing behavior of the thread.
+ */
+class sim_thread
+{
+	/** A task in the queue */
+	struct task {
+		/** The function to run */
+		func_wrapper f;
+		/** The simulated cost, or negative to use the cost model */
+		sim_clock::duration cost;
+		/** When the task arrived in the queue */
+		sim_clock::time_point arrival;
+	};
+
+	/** The simulation */
+	sim_executor& sim_;
+	/** The tasks sent to the thread that have yet to arrive, by time */
+	std::deque<task> inFlight_;
+	/** The queued tasks */
+	std::deque<task> que_;
+	/** Whether the thread is running a task */
+	bool busy_;
+	/** The cost model for tasks without an explicit cost */
+	cost_model cost_;
+	/** The number of tasks completed */
+	uint64_t nCompleted_;
+	/** The longest the queue has been */
+	size_t maxQueue_;
+	/** The total time spent running tasks */
+	sim_clock::duration busyTime_;
+	/** The total time that tasks waited in the queue */
+	sim_clock::duration waitTime_;
+	/** The longest time a task waited in the queue */
+	sim_clock::duration maxWait_;
+
+	friend class sim_executor;
+
+	/** Sends a task to the thread */
+	void send(sim_clock::duration cost, func_wrapper f);
+	/** Moves the next task to arrive into the queue, and starts it if idle */
+	void arrive();
+	/** Starts the next task, if any */
+	void dispatch();
+
+	// Non-copyable
+	sim_thread(const sim_thread&) =delete;
+	sim_thread& operator=(const sim_thread&) =delete;
+
+public:
+	/**
+	 * Creates a simulated thread.
+	 * Use sim_executor::add_thread() instead.
+	 * @param sim The simulation.
+	 * @param cost The cost model for the tasks.
+	 */
+	sim_thread(sim_executor& sim, cost_model cost);
+	/**
+	 * Gets the simulation that runs the thread.
+	 * @return The simulation that runs the thread.
+	 */
+	sim_executor& executor() { return sim_; }
+	/**
+	 * Sets the cost model for the tasks without an explicit cost.
+	 * @param cost The cost model.
+	 */
+	void set_cost_model(cost_model cost) { cost_ = std::move(cost); }
+	/**
+	 * Sends a task to the thread, with its cost taken from the cost model.
+	 * If this is called from a task, the new one arrives when the sending
+	 * task completes.
+	 * @param f The function to run.
+	 */
+	template <class Func>
+	void post(Func f) { send(sim_clock::duration{-1}, std::move(f)); }
+	/**
+	 * Sends a task to the thread with an explicit cost.
+	 * If this is called from a task, the new one arrives when the sending
+	 * task completes.
+	 * @param cost The simulated time to run the task.
+	 * @param f The function to run.
+	 */
+	template <class Func>
+	void post(sim_clock::duration cost, Func f) { send(cost, std::move(f)); }
+	/**
+	 * Gets the number of tasks waiting in the queue.
+	 * @return The number of tasks waiting in the queue.
+	 */
+	size_t queue_size() const { return que_.size(); }
+	/**
+	 * Determines if the thread is running a task or has any queued or on
+	 * the way.
+	 * @return @em true if the thread has nothing to do, @em false if not.
+	 */
+	bool idle() const { return !busy_ && que_.empty() && inFlight_.empty(); }
+	/**
+	 * Gets the number of tasks completed.
+	 * @return The number of tasks completed.
+	 */
+	uint64_t num_completed() const { return nCompleted_; }
+	/**
+	 * Gets the longest that the queue has been.
+	 * @return The longest that the queue has been.
+	 */
+	size_t max_queue_size() const { return maxQueue_; }
+	/**
+	 * Gets the total simulated time spent running tasks.
+	 * @return The total simulated time spent running tasks.
+	 */
+	sim_clock::duration busy_time() const { return busyTime_; }
+	/**
+	 * Gets the total time that the completed tasks waited in the queue.
+	 * @return The total time that the tasks waited in the queue.
+	 */
+	sim_clock::duration total_wait() const { return waitTime_; }
+	/**
+	 * Gets the longest time that a task waited in the queue.
+	 * @return The longest time that a task waited in the queue.
+	 */
+	sim_clock::duration max_wait() const { return maxWait_; }
+	/**
+	 * Gets the average time that the tasks waited in the queue.
+	 * @return The average time that the tasks waited in the queue.
+	 */
+	sim_clock::duration mean_wait() const {
+		return nCompleted_ ? waitTime_ / sim_clock::rep(nCompleted_)
+						   : sim_clock::duration{0};
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A deterministic, single-threaded executor for simulating actors.
+ *
+ * This is a discrete event simulation of a set of work threads. Nothing
+ * runs concurrently, and nothing depends on the wall clock. Instead there
+ * is a virtual clock that jumps from one event to the next: tasks arriving
+ * at the simulated threads, tasks completing after their simulated cost,
+ * and timers expiring. So, a large actor system can be simulated much
+ * faster than it would actually run, and each run with the same seed
+ * gives exactly the same results.
+ *
+ * Events at the same virtual time are ordered by the interleaving policy:
+ * in the order they were scheduled, or in a random order from the seed.
+ * Running with a number of seeds explores different interleavings.
+ */
+class sim_executor
+{
+public:
+	/** A point in virtual time */
+	using time_point = sim_clock::time_point;
+	/** A span of virtual time */
+	using duration = sim_clock::duration;
+	/** The identifier for a timer */
+	using timer_id = uint64_t;
+
+private:
+	/** An event */
+	struct event {
+		/** When the event happens */
+		time_point t;
+		/** Orders events at the same time */
+		uint64_t key;
+		/** Orders events with the same key */
+		uint64_t seq;
+		/** The action for the event */
+		func_wrapper f;
+	};
+	/** Puts the earliest event at the top of the heap */
+	struct later {
+		bool operator()(const event& a, const event& b) const {
+			if (a.t != b.t) return a.t > b.t;
+			if (a.key != b.key) return a.key > b.key;
+			return a.seq > b.seq;
+		}
+	};
+
+	/** The pending events, as a heap */
+	std::vector<event> events_;
+	/** The current virtual time */
+	time_point now_;
+	/** The count of events scheduled */
+	uint64_t seq_;
+	/** The ordering of simultaneous events */
+	interleave policy_;
+	/** The random number generator, for ordering and costs */
+	std::mt19937_64 rng_;
+	/** The simulated threads */
+	std::vector<std::unique_ptr<sim_thread>> thrs_;
+	/** The next thread to assign to an actor */
+	size_t nextThr_;
+	/** The time at which the running task completes, if any */
+	const time_point* taskEnd_;
+	/** The last timer ID handed out */
+	timer_id lastTimer_;
+	/** The timers that are running */
+	std::unordered_set<timer_id> timers_;
+	/** The number of events processed */
+	uint64_t nEvents_;
+
+	friend class sim_thread;
+
+	/**
+	 * Gets the time at which something sent now arrives.
+	 * If it is sent from a task, that's when the task completes.
+	 */
+	time_point send_time() const { return taskEnd_ ? *taskEnd_ : now_; }
+	/** Schedules an event */
+	void schedule(time_point t, func_wrapper f);
+	/** Runs a periodic timer and reschedules it */
+	void periodic(timer_id id, duration interval,
+				  std::shared_ptr<std::function<void()>> f);
+
+	// Non-copyable
+	sim_executor(const sim_executor&) =delete;
+	sim_executor& operator=(const sim_executor&) =delete;
+
+public:
+	/**
+	 * Creates a simulation.
+	 * @param seed The seed for the random number generator.
+	 * @param policy How to order events that happen at the same time.
+	 */
+	explicit sim_executor(uint64_t seed=0, interleave policy=interleave::random);
+	/**
+	 * Adds a simulated thread.
+	 * @param cost The cost model for the thread's tasks.
+	 * @return A reference to the new thread.
+	 */
+	sim_thread& add_thread(cost_model cost=fixed_cost(duration{0}));
+	/**
+	 * Gets the number of simulated threads.
+	 * @return The number of simulated threads.
+	 */
+	size_t size() const { return thrs_.size(); }
+	/**
+	 * Gets one of the simulated threads.
+	 * @param i The index of the thread.
+	 * @return A reference to the thread.
+	 */
+	sim_thread& operator[](size_t i) { return *thrs_[i]; }
+	/**
+	 * Gets the next thread, round-robin, for assigning an actor.
+	 * There must be at least one thread.
+	 * @return A reference to the thread.
+	 */
+	sim_thread& next_thread() { return *thrs_[nextThr_++ % thrs_.size()]; }
+	/**
+	 * Gets the current virtual time.
+	 * @return The current virtual time.
+	 */
+	time_point now() const { return now_; }
+	/**
+	 * Gets the time elapsed since the start of the simulation.
+	 * @return The time elapsed since the start of the simulation.
+	 */
+	duration elapsed() const { return now_.time_since_epoch(); }
+	/**
+	 * Gets the random number generator for the simulation.
+	 * Using this for any randomness in the simulated actors keeps the
+	 * runs reproducible.
+	 * @return The random number generator for the simulation.
+	 */
+	std::mt19937_64& rng() { return rng_; }
+	/**
+	 * Gets the number of events processed so far.
+	 * @return The number of events processed so far.
+	 */
+	uint64_t num_events() const { return nEvents_; }
+	/**
+	 * Schedules a function to run at a specific virtual time.
+	 * @param t The time to run the function. If it's in the past, the
+	 *  		function runs at the current time.
+	 * @param f The function.
+	 */
+	template <class Func>
+	void at(time_point t, Func f) { schedule(t, std::move(f)); }
+	/**
+	 * Starts a one-shot timer.
+	 * @param delay The time from now to run the function.
+	 * @param f The function.
+	 * @return The ID for the timer.
+	 */
+	template <class Func>
+	timer_id after(duration delay, Func f) {
+		auto id = ++lastTimer_;
+		timers_.insert(id);
+		schedule(now_ + delay, [this, id, f=std::move(f)]() mutable {
+			if (timers_.erase(id) != 0)
+				f();
+		});
+		return id;
+	}
+	/**
+	 * Starts a periodic timer.
+	 * @param interval The time between calls to the function. The first
+	 *  			   call is one interval from now.
+	 * @param f The function.
+	 * @return The ID for the timer.
+	 */
+	timer_id every(duration interval, std::function<void()> f);
+	/**
+	 * Cancels a timer.
+	 * @param id The ID of the timer.
+	 */
+	void cancel(timer_id id) { timers_.erase(id); }
+	/**
+	 * Processes the next event.
+	 * @return @em true if an event was processed, @em false if there are
+	 *  	   no more events.
+	 */
+	bool step();
+	/**
+	 * Runs the simulation until there are no more events.
+	 * Note that this never returns if there is a periodic timer.
+	 * @return The number of events processed.
+	 */
+	uint64_t run();
+	/**
+	 * Runs the simulation up to a virtual time.
+	 * The clock is left at that time.
+	 * @param t The time at which to stop.
+	 * @return The number of events processed.
+	 */
+	uint64_t run_until(time_point t);
+	/**
+	 * Runs the simulation for a span of virtual time.
+	 * @param d The amount of time to run.
+	 * @return The number of events processed.
+	 */
+	uint64_t run_for(duration d) { return run_until(now_ + d); }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Base class for a simulated actor.
+ *
+ * This has the same asynchronous messaging interface as @ref actor, with
+ * the messages going to a simulated thread. An actor class written as a
+ * template on its base class can run either for real or in a simulation.
+ *
+ * @par
+ * Since everything runs in a single thread, there is no blocking call().
+ * Replies should be sent back as messages.
+ */
+class sim_actor
+{
+	/** The actor's thread */
+	sim_thread& thr_;
+
+protected:
+	/**
+	 * Gets the simulated thread that runs the actor.
+	 * @return The simulated thread that runs the actor.
+	 */
+	sim_thread& get_thread() const { return thr_; }
+	/**
+	 * Gets the simulation.
+	 * @return The simulation.
+	 */
+	sim_executor& executor() const { return thr_.executor(); }
+	/**
+	 * Gets the current virtual time.
+	 * @return The current virtual time.
+	 */
+	sim_clock::time_point now() const { return thr_.executor().now(); }
+	/**
+	 * Sends a task to run in the actor thread, with its cost taken from
+	 * the thread's cost model.
+	 * @param f The function object for the thread to execute
+	 */
+	template <class Func>
+	void cast(Func f) { thr_.post(std::move(f)); }
+	/**
+	 * Sends a task to run in the actor thread with an explicit cost.
+	 * @param cost The simulated time to run the task.
+	 * @param f The function object for the thread to execute
+	 */
+	template <class Func>
+	void cast(sim_clock::duration cost, Func f) {
+		thr_.post(cost, std::move(f));
+	}
+
+public:
+	/**
+	 * Creates an actor on the next thread of a simulation.
+	 * @param sim The simulation.
+	 */
+	explicit sim_actor(sim_executor& sim) : thr_(sim.next_thread()) {}
+	/**
+	 * Creates an actor on a specific simulated thread.
+	 * @param thr The thread for the actor.
+	 */
+	explicit sim_actor(sim_thread& thr) : thr_(thr) {}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_simulation_h
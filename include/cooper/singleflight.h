@@ -0,0 +1,254 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file singleflight.h
+/// Implementation of the class 'singleflight'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef __cooper_singleflight_h
+#define __cooper_singleflight_h
+
+#include "cooper/work_thread.h"
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <future>
+#include <atomic>
+#include <mutex>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Collapses concurrent identical requests into a single execution.
+ *
+ * This is for an actor that computes results by key, like a cache that
+ * loads a missing entry from a slow backing store. When a popular key
+ * misses, a crowd of clients can all ask for it at once, and the actor
+ * ends up doing the same work over and over. With this, only the first
+ * request for a key is queued to the actor's thread. Any others for the
+ * same key that arrive while it's still pending, or running, attach to
+ * it, and all of them get the one shared result, or the exception it
+ * threw.
+ *
+ * A request for a key that arrives after the result was produced starts
+ * a new execution, so this never serves stale results. It's not a cache.
+ *
+ * @par
+ * An actor would normally keep one of these as a member, for its own
+ * thread, and use it in its public methods:
+ * @code
+ * class store : public actor
+ * {
+ *     singleflight<std::string, std::string> loads_;
+ *     std::string load(const std::string& key);
+ *
+ * public:
+ *     store() : loads_(get_thread()) {}
+ *     std::string get(const std::string& key) {
+ *         return loads_.call(key, [this, key] { return load(key); });
+ *     }
+ * };
+ * @endcode
+ *
+ * @param Key The type of the key that identifies identical requests.
+ * @param T The type of the result. This can be void.
+ * @param Hash The hash function for the key.
+ */
+template <typename Key, typename T, class Hash=std::hash<Key>>
+class singleflight
+{
+	/** A pending request, which can be identified by its sequence number */
+	struct flight {
+		uint64_t seq;
+		std::shared_future<T> fut;
+	};
+
+	/**
+	 * The state that is shared with the queued tasks, so they can clean up
+	 * even if they are discarded after this object is gone.
+	 */
+	struct state {
+		work_thread& thr;
+		std::mutex lock;
+		std::unordered_map<Key, flight, Hash> flights;
+		uint64_t seq = 0;
+		std::atomic<size_t> nExecuted{0};
+		std::atomic<size_t> nShared{0};
+
+		explicit state(work_thread& thr) : thr(thr) {}
+
+		// Removes a request from the map, if it's still the one there.
+		void land(const Key& key, uint64_t seq) {
+			std::lock_guard<std::mutex> g(lock);
+			auto p = flights.find(key);
+			if (p != flights.end() && p->second.seq == seq)
+				flights.erase(p);
+		}
+	};
+
+	/**
+	 * Removes a request from the map when its task is destroyed, whether
+	 * it ran or was discarded.
+	 */
+	struct lander {
+		std::shared_ptr<state> st;
+		Key key;
+		uint64_t seq;
+
+		lander(std::shared_ptr<state> st, Key key, uint64_t seq)
+			: st(std::move(st)), key(std::move(key)), seq(seq) {}
+		lander(lander&& other)
+			: st(std::move(other.st)), key(std::move(other.key)), seq(other.seq) {}
+		~lander() {
+			if (st)
+				st->land(key, seq);
+		}
+	};
+
+	/** The shared state */
+	std::shared_ptr<state> st_;
+
+	// Non-copyable
+	singleflight(const singleflight&) =delete;
+	singleflight& operator=(const singleflight&) =delete;
+
+public:
+	/**
+	 * Creates an object to run requests on a work thread.
+	 * @param thr The work thread for the requests. Normally this is the
+	 *  		  thread of the actor that owns the object.
+	 */
+	explicit singleflight(work_thread& thr)
+		: st_(std::make_shared<state>(thr)) {}
+	/**
+	 * Submits a request, or joins the one already pending for the key.
+	 * If a request for the key is pending, the function is dropped, and
+	 * this returns the future for the earlier one. Otherwise the function
+	 * is queued to the work thread.
+	 * @param key The key that identifies the request.
+	 * @param f The function object to compute the result.
+	 * @return A future for the shared result.
+	 * @throws queue_closed if the work thread was closed.
+	 */
+	template <class Func>
+	std::shared_future<T> submit(const Key& key, Func f) {
+		std::unique_lock<std::mutex> g(st_->lock);
+		auto p = st_->flights.find(key);
+		if (p != st_->flights.end()) {
+			++st_->nShared;
+			return p->second.fut;
+		}
+
+		auto prom = std::make_shared<std::promise<T>>();
+		std::shared_future<T> fut = prom->get_future().share();
+		uint64_t seq = ++st_->seq;
+		st_->flights.emplace(key, flight{ seq, fut });
+		g.unlock();
+
+		// The request is removed from the map before the result is set,
+		// so that anyone who sees the result and asks again gets a new one.
+
+		lander ldr(st_, key, seq);
+		try {
+			st_->thr.post([ldr=std::move(ldr), prom, f=std::move(f)]() mutable {
+				++ldr.st->nExecuted;
+				try {
+					if constexpr (std::is_void_v<T>) {
+						f();
+						ldr.st->land(ldr.key, ldr.seq);
+						prom->set_value();
+					}
+					else {
+						T val = f();
+						ldr.st->land(ldr.key, ldr.seq);
+						prom->set_value(std::move(val));
+					}
+				}
+				catch (...) {
+					ldr.st->land(ldr.key, ldr.seq);
+					prom->set_exception(std::current_exception());
+				}
+			});
+		}
+		catch (...) {
+			st_->land(key, seq);
+			throw;
+		}
+		return fut;
+	}
+	/**
+	 * Blocking call for a request, which is shared with any others for
+	 * the same key that are pending.
+	 * @param key The key that identifies the request.
+	 * @param f The function object to compute the result.
+	 * @return The result.
+	 * @throws Any exception thrown by the function.
+	 */
+	template <class Func>
+	T call(const Key& key, Func f) {
+		return detail::get_result(submit(key, std::move(f)));
+	}
+	/**
+	 * Gets the number of requests that are pending.
+	 * @return The number of requests that are pending.
+	 */
+	size_t in_flight() const {
+		std::lock_guard<std::mutex> g(st_->lock);
+		return st_->flights.size();
+	}
+	/**
+	 * Gets the number of requests that were actually executed.
+	 * @return The number of requests that were actually executed.
+	 */
+	size_t num_executed() const { return st_->nExecuted; }
+	/**
+	 * Gets the number of requests that joined one that was pending,
+	 * rather than being executed.
+	 * @return The number of requests that shared another's result.
+	 */
+	size_t num_shared() const { return st_->nShared; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_singleflight_h
@@ -0,0 +1,170 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file spsc_queue.h
+/// Implementation of the class 'spsc_queue'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_spsc_queue_h
+#define __cooper_spsc_queue_h
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A bounded, lock-free queue for a single producer and single consumer.
+ *
+ * This is a fixed ring of slots with a head index, written only by the
+ * consumer, and a tail index, written only by the producer. Each side
+ * keeps a cached copy of the other's index, and only reloads it when the
+ * queue looks full or empty, so in the steady state a push or pop touches
+ * only its own cache line and the slot.
+ *
+ * Exactly one thread may push, and exactly one thread may pop, at a time.
+ * It doesn't block; when full or empty the operations just fail.
+ *
+ * @param T The type of items in the queue. This must be default
+ *  		constructible and move-assignable.
+ */
+template <typename T>
+class spsc_queue
+{
+public:
+	/** The type of items in the queue */
+	using value_type = T;
+	/** The type used to specify the number of items in the queue */
+	using size_type = size_t;
+
+private:
+	/** The size of a cache line, to keep the two sides apart */
+	static constexpr size_t CACHE_LINE = 64;
+
+	/** The slots. The size is a power of two. */
+	std::unique_ptr<T[]> buf_;
+	/** Mask to turn an index into a slot */
+	size_type mask_;
+
+	/** The next slot to pop. Written by the consumer. */
+	alignas(CACHE_LINE) std::atomic<size_type> head_;
+	/** The consumer's copy of the tail */
+	size_type tailCache_;
+
+	/** The next slot to push. Written by the producer. */
+	alignas(CACHE_LINE) std::atomic<size_type> tail_;
+	/** The producer's copy of the head */
+	size_type headCache_;
+
+	// Non-copyable
+	spsc_queue(const spsc_queue&) =delete;
+	spsc_queue& operator=(const spsc_queue&) =delete;
+
+public:
+	/**
+	 * Creates a queue.
+	 * @param cap The capacity of the queue. This is rounded up to a power
+	 *  		  of two.
+	 */
+	explicit spsc_queue(size_type cap) : head_(0), tailCache_(0), tail_(0), headCache_(0) {
+		size_type n = 2;
+		while (n < cap)
+			n <<= 1;
+		buf_.reset(new T[n]);
+		mask_ = n - 1;
+	}
+	/**
+	 * Gets the capacity of the queue.
+	 * @return The most items that the queue can hold.
+	 */
+	size_type capacity() const { return mask_ + 1; }
+	/**
+	 * Determines if the queue is empty.
+	 * This is exact when called by the consumer, and a snapshot otherwise.
+	 * @return @em true if the queue is empty, @em false if not.
+	 */
+	bool empty() const {
+		return head_.load(std::memory_order_relaxed)
+			== tail_.load(std::memory_order_acquire);
+	}
+	/**
+	 * Attempts to push an item onto the back of the queue.
+	 * This must only be called by the producer.
+	 * @param val The item to push. It's only moved from on success.
+	 * @return @em true if the item was pushed, @em false if the queue is
+	 *  	   full.
+	 */
+	bool try_push(T&& val) {
+		size_type tail = tail_.load(std::memory_order_relaxed);
+		if (tail - headCache_ > mask_) {
+			headCache_ = head_.load(std::memory_order_acquire);
+			if (tail - headCache_ > mask_)
+				return false;
+		}
+		buf_[tail & mask_] = std::move(val);
+		tail_.store(tail+1, std::memory_order_release);
+		return true;
+	}
+	/**
+	 * Attempts to pop an item from the front of the queue.
+	 * This must only be called by the consumer.
+	 * @param val Pointer to a variable to get the item.
+	 * @return @em true if an item was popped, @em false if the queue is
+	 *  	   empty.
+	 */
+	bool try_pop(T* val) {
+		size_type head = head_.load(std::memory_order_relaxed);
+		if (head == tailCache_) {
+			tailCache_ = tail_.load(std::memory_order_acquire);
+			if (head == tailCache_)
+				return false;
+		}
+		*val = std::move(buf_[head & mask_]);
+		head_.store(head+1, std::memory_order_release);
+		return true;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_spsc_queue_h
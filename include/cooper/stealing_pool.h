@@ -0,0 +1,310 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file stealing_pool.h
+/// Implementation of the class 'stealing_pool'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_stealing_pool_h
+#define __cooper_stealing_pool_h
+
+#include "cooper/topology.h"
+#include "cooper/thread_queue.h"
+#include "cooper/ring_buffer.h"
+#include "cooper/func_wrapper.h"
+#include "cooper/exception.h"
+#include <condition_variable>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <mutex>
+
+#if !defined(COOPER_SINGLE_THREADED)
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * How far a stolen task traveled in the memory hierarchy.
+ */
+enum class steal_level
+{
+	/** From a worker in the same core complex */
+	complex,
+	/** From a worker in another complex on the same NUMA node */
+	node,
+	/** From a worker, or an injection queue, on another NUMA node */
+	remote
+};
+
+/**
+ * Parameters for a work stealing pool.
+ */
+struct stealing_options
+{
+	/** Whether to pin each worker to its CPU */
+	bool pin = true;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A pool of worker threads that balance the load by stealing tasks, in a
+ * way that respects the memory hierarchy.
+ *
+ * There's a worker for each CPU in a @ref cpu_topology. A task posted by
+ * a worker goes onto the worker's own deque, and it takes the most recent
+ * one back first, while its data is still in the cache. Tasks posted from
+ * outside the pool go into an injection queue for one of the NUMA nodes,
+ * taken in turn, or the one picked by post_to_node().
+ *
+ * A worker that runs dry looks for work close to home first: its node's
+ * injection queue, then the oldest tasks of the other workers in its core
+ * complex, then those in the other complexes on its node, and only then
+ * the workers and injection queues on the other nodes. So on a machine
+ * with several sockets, the work only crosses between them when a whole
+ * node is idle. The steals at each level are counted, to see how well
+ * that's working.
+ *
+ * @par
+ * Unlike a @ref work_thread, the tasks don't run in any particular order,
+ * or on any particular thread, so this is for independent jobs, not
+ * actors. Idle workers spin briefly and then sleep until there's work.
+ * Destroying the pool runs all the tasks that were posted, then stops the
+ * workers.
+ */
+class stealing_pool
+{
+	/** A worker thread and its deque of tasks */
+	struct alignas(64) worker {
+		/** Lock for the deque */
+		std::mutex lock;
+		/** The tasks. The owner works at the back, thieves at the front. */
+		std::deque<func_wrapper> tasks;
+		/** The number of tasks in the deque, to skip empty ones */
+		std::atomic<size_t> size { 0 };
+		/** Where the worker runs */
+		cpu_info cpu;
+		/** The workers to steal from, nearest first */
+		std::vector<size_t> victims;
+		/** The end of each level in the victim list */
+		size_t levelEnd[3] = { 0, 0, 0 };
+		/** The other nodes, nearest first */
+		std::vector<size_t> remoteNodes;
+		/** The number of tasks taken from its own deque */
+		std::atomic<uint64_t> nLocal { 0 };
+		/** The number of tasks taken from its node's injection queue */
+		std::atomic<uint64_t> nInjected { 0 };
+		/** The number of tasks stolen, by level */
+		std::atomic<uint64_t> nSteal[3] = { {0}, {0}, {0} };
+		/** The thread */
+		std::thread thr;
+	};
+
+	/** The type of the per-node injection queues */
+	using queue_type = thread_queue<func_wrapper, ring_buffer<func_wrapper>>;
+
+	/** The topology */
+	cpu_topology topo_;
+	/** The workers */
+	std::unique_ptr<worker[]> workers_;
+	/** The injection queues, by node */
+	std::unique_ptr<queue_type[]> inject_;
+	/** The next node for tasks from outside the pool */
+	std::atomic<size_t> nextNode_;
+	/** The number of tasks queued but not yet taken */
+	std::atomic<int64_t> nQueued_;
+	/** The number of tasks posted but not yet completed */
+	std::atomic<size_t> nPending_;
+	/** The number of workers that are asleep, or about to be */
+	std::atomic<size_t> nSleeping_;
+	/** Whether the pool is shutting down */
+	std::atomic<bool> stop_;
+	/** Lock for sleeping and waiting */
+	std::mutex idleLock_;
+	/** Signaled when there's work for a sleeping worker */
+	std::condition_variable idleCond_;
+	/** Signaled when all the pending tasks complete */
+	std::condition_variable doneCond_;
+
+	/** Gets the pool and worker index running on the calling thread */
+	static std::pair<stealing_pool*, size_t>& current() {
+		thread_local std::pair<stealing_pool*, size_t> cur { nullptr, 0 };
+		return cur;
+	}
+
+	/**
+	 * Queues a task.
+	 * @param task The task.
+	 * @param node The node for the injection queue.
+	 * @param local Whether to put it on the calling worker's own deque
+	 *  			instead.
+	 */
+	void enqueue(func_wrapper task, size_t node, bool local);
+	/** Wakes a sleeping worker, if there is one */
+	void wake();
+	/** Builds the victim list for a worker */
+	void plan_steals(size_t i);
+	/** Takes a task from the back of a worker's own deque */
+	bool pop(size_t i, func_wrapper* task);
+	/** Takes a task from the front of another worker's deque */
+	bool steal(size_t victim, func_wrapper* task);
+	/** Finds a task for a worker, nearest first */
+	bool find_task(size_t i, func_wrapper* task);
+	/** The worker thread function */
+	void worker_func(size_t i, bool pin);
+
+	// Non-copyable
+	stealing_pool(const stealing_pool&) =delete;
+	stealing_pool& operator=(const stealing_pool&) =delete;
+
+public:
+	/**
+	 * Creates a pool with a worker for each CPU in the system.
+	 * @param opts The parameters.
+	 */
+	explicit stealing_pool(const stealing_options& opts=stealing_options{})
+		: stealing_pool(cpu_topology::detect(), opts) {}
+	/**
+	 * Creates a pool with a worker for each CPU in a topology.
+	 * @param topo The CPUs for the workers.
+	 * @param opts The parameters.
+	 */
+	explicit stealing_pool(const cpu_topology& topo,
+						   const stealing_options& opts=stealing_options{});
+	/**
+	 * Runs all the tasks that were posted, then stops the workers.
+	 */
+	~stealing_pool();
+	/**
+	 * Gets the number of workers.
+	 * @return The number of workers.
+	 */
+	size_t size() const { return topo_.size(); }
+	/**
+	 * Gets the topology of the workers.
+	 * @return The topology of the workers.
+	 */
+	const cpu_topology& topology() const { return topo_; }
+	/**
+	 * Gets the order in which a worker looks for tasks to steal.
+	 * @param i The index of the worker.
+	 * @return The indexes of the other workers, nearest first.
+	 */
+	const std::vector<size_t>& steal_order(size_t i) const {
+		return workers_[i].victims;
+	}
+	/**
+	 * Posts a task to the pool.
+	 * From a worker, the task goes onto its own deque. Otherwise it goes
+	 * to the injection queue of the next node in turn.
+	 * @param f The function object to execute.
+	 * @throws queue_closed if the pool is shutting down.
+	 */
+	template <class Func>
+	void post(Func f) {
+		if (current().first == this)
+			enqueue(std::move(f), 0, true);
+		else
+			enqueue(std::move(f), nextNode_++ % topo_.num_nodes(), false);
+	}
+	/**
+	 * Posts a task to the injection queue of a specific NUMA node.
+	 * @param node The node.
+	 * @param f The function object to execute.
+	 * @throws queue_closed if the pool is shutting down.
+	 */
+	template <class Func>
+	void post_to_node(size_t node, Func f) {
+		enqueue(std::move(f), node % topo_.num_nodes(), false);
+	}
+	/**
+	 * Submits a task to the pool.
+	 * @param f The function object to execute.
+	 * @return A future for the result of the task.
+	 * @throws queue_closed if the pool is shutting down.
+	 */
+	template <class Func>
+	std::future<typename std::invoke_result_t<Func>> submit(Func f) {
+		using result_type = typename std::invoke_result_t<Func>;
+		std::packaged_task<result_type()> task(std::move(f));
+		auto fut = task.get_future();
+		post(std::move(task));
+		return fut;
+	}
+	/**
+	 * Waits until all the tasks posted so far, and any that they post in
+	 * turn, have completed.
+	 * This must not be called from a worker.
+	 */
+	void wait();
+	/**
+	 * Gets the number of tasks posted but not yet completed.
+	 * @return The number of tasks outstanding.
+	 */
+	size_t num_pending() const { return nPending_; }
+	/**
+	 * Gets the number of tasks that workers took from their own deques.
+	 * @return The number of local tasks.
+	 */
+	uint64_t num_local() const;
+	/**
+	 * Gets the number of tasks that workers took from the injection queue
+	 * of their own node.
+	 * @return The number of injected tasks taken on their own node.
+	 */
+	uint64_t num_injected() const;
+	/**
+	 * Gets the number of tasks stolen at a level of the hierarchy.
+	 * @param lvl The level.
+	 * @return The number of tasks stolen at that level.
+	 */
+	uint64_t num_steals(steal_level lvl) const;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif
+
+#endif		// __cooper_stealing_pool_h
@@ -0,0 +1,449 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file stream.h
+/// Implementation of the class 'stream'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_stream_h
+#define __cooper_stream_h
+
+#include "cooper/work_thread.h"
+#include "cooper/sync.h"
+#include <functional>
+#include <algorithm>
+#include <optional>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <deque>
+#include <mutex>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Parameters for a streaming reply.
+ */
+struct stream_options
+{
+	/**
+	 * The number of items that the producer can get ahead of the
+	 * consumer. This bounds the memory used by the stream.
+	 */
+	size_t window = 64;
+	/**
+	 * The most items the producer generates in one go before it lets the
+	 * work thread handle other messages.
+	 */
+	size_t batch = 16;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A stream of items produced incrementally in a work thread.
+ *
+ * This is the client side of a streaming reply, created with
+ * make_stream(), or actor::call_stream(). Rather than build a large result
+ * all at once, the producer is a generator, a function that returns the
+ * next item each time that it's called, or std::nullopt when it's done.
+ * It runs in the work thread, a batch of items at a time, and is re-queued
+ * between batches, so the thread handles its other messages in between.
+ *
+ * The flow control is by credit. The producer can get at most a window of
+ * items ahead of the consumer, and then it parks. As the consumer takes
+ * items, the credit comes back, and once half the window is free, the
+ * producer is queued again. So a slow consumer never makes the producer
+ * buffer the whole result.
+ *
+ * @par
+ * Since other messages run between batches, the generator must not hold
+ * anything that they could invalidate, like an iterator into a container
+ * that they modify. It can keep its position as a key, and look up the
+ * next one on each call, instead.
+ *
+ * @par
+ * If the generator throws, the consumer gets the exception after it takes
+ * the items produced before it. Destroying the stream, or calling
+ * cancel(), stops the producer at its next item.
+ *
+ * @param T The type of items in the stream.
+ */
+template <typename T>
+class stream
+{
+	/** The state shared by the producer and consumer */
+	struct state : std::enable_shared_from_this<state> {
+		work_thread& thr;
+		std::function<std::optional<T>()> gen;
+		stream_options opts;
+
+		sync::mutex lock;
+		sync::condition_variable cond;
+		std::deque<T> buf;
+		size_t credit;
+		bool parked = false;
+		bool done = false;
+		bool cancelled = false;
+		std::exception_ptr err;
+
+		using guard = std::lock_guard<sync::mutex>;
+		using unique_guard = std::unique_lock<sync::mutex>;
+
+		state(work_thread& thr, std::function<std::optional<T>()> gen,
+			  const stream_options& opts)
+			: thr(thr), gen(std::move(gen)), opts(opts), credit(opts.window) {}
+
+		// Move-only guard for a queued batch of the producer. If the batch
+		// is dropped without running, like when the work thread's queue
+		// is discarded, it ends the stream with a queue_closed error.
+		struct batch {
+			std::shared_ptr<state> st;
+
+			explicit batch(std::shared_ptr<state> st) : st(std::move(st)) {}
+			batch(batch&& other) : st(std::move(other.st)) {}
+			~batch() {
+				if (st)
+					st->finish(std::make_exception_ptr(queue_closed()));
+			}
+		};
+
+		// Queues a batch of the producer to the work thread. If it can't
+		// be queued, the guard is destroyed, and ends the stream.
+		void post() {
+			try {
+				thr.post([b=batch(this->shared_from_this())]() mutable {
+					auto st = std::move(b.st);
+					st->produce();
+				});
+			}
+			catch (...) {}
+		}
+
+		// Marks the end of the stream, and wakes the consumer
+		void finish(std::exception_ptr e=nullptr) {
+			guard g(lock);
+			done = true;
+			err = e;
+			gen = nullptr;
+			cond.notify_all();
+		}
+
+		// Runs a batch of the producer in the work thread
+		void produce() {
+			for (size_t n=0; n<opts.batch; ++n) {
+				{
+					guard g(lock);
+					if (cancelled) {
+						done = true;
+						gen = nullptr;
+						return;
+					}
+					if (credit == 0) {
+						parked = true;
+						return;
+					}
+					--credit;
+				}
+
+				std::optional<T> item;
+				try {
+					item = gen();
+				}
+				catch (...) {
+					finish(std::current_exception());
+					return;
+				}
+
+				if (!item) {
+					finish();
+					return;
+				}
+
+				guard g(lock);
+				buf.push_back(std::move(*item));
+				cond.notify_all();
+			}
+
+			{
+				guard g(lock);
+				if (credit == 0 && !cancelled) {
+					parked = true;
+					return;
+				}
+			}
+			post();
+		}
+
+		// Takes an item from the buffer, which must be locked and not
+		// empty, and returns the credit. This reports whether the
+		// producer needs to be woken.
+		bool take(T* val) {
+			*val = std::move(buf.front());
+			buf.pop_front();
+			++credit;
+			if (parked && credit >= (opts.window+1)/2) {
+				parked = false;
+				return true;
+			}
+			return false;
+		}
+	};
+
+	/** The shared state */
+	std::shared_ptr<state> st_;
+
+	template <class Gen>
+	friend auto make_stream(work_thread& thr, Gen gen, const stream_options& opts);
+
+	/**
+	 * Creates a stream and starts the producer.
+	 */
+	stream(work_thread& thr, std::function<std::optional<T>()> gen,
+		   const stream_options& opts) {
+		auto o = opts;
+		o.window = std::max<size_t>(o.window, 1);
+		o.batch = std::max<size_t>(std::min(o.batch, o.window), 1);
+		st_ = std::make_shared<state>(thr, std::move(gen), o);
+		st_->post();
+	}
+
+public:
+	/**
+	 * An input iterator over the items in a stream.
+	 * This blocks on increment until the next item is available.
+	 */
+	class iterator
+	{
+		stream* strm_;
+		std::optional<T> val_;
+
+		friend class stream;
+
+		explicit iterator(stream* strm) : strm_(strm) {
+			if (strm_)
+				++(*this);
+		}
+
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T*;
+		using reference = T&;
+
+		iterator() : strm_(nullptr) {}
+
+		T& operator*() { return *val_; }
+		T* operator->() { return &*val_; }
+
+		iterator& operator++() {
+			val_ = strm_->next();
+			if (!val_)
+				strm_ = nullptr;
+			return *this;
+		}
+
+		bool operator==(const iterator& rhs) const { return strm_ == rhs.strm_; }
+		bool operator!=(const iterator& rhs) const { return strm_ != rhs.strm_; }
+	};
+
+	/**
+	 * Creates an empty stream, which has no items.
+	 */
+	stream() =default;
+	/**
+	 * Move constructor.
+	 */
+	stream(stream&&) =default;
+	/**
+	 * Move assignment. This cancels any stream that this one had.
+	 */
+	stream& operator=(stream&& rhs) {
+		if (&rhs != this) {
+			cancel();
+			st_ = std::move(rhs.st_);
+		}
+		return *this;
+	}
+	/**
+	 * Destroys the stream, stopping the producer if it hasn't finished.
+	 */
+	~stream() { cancel(); }
+	/**
+	 * Gets the next item from the stream, blocking until it's available.
+	 * In the single-threaded build, this runs the event loop until it is.
+	 * @param val Pointer to a variable to get the item.
+	 * @return @em true if an item was read, @em false if the stream ended.
+	 * @throws Any exception thrown by the producer, once the items produced
+	 *  	   before it are read.
+	 */
+	bool next(T* val) {
+		if (!st_)
+			return false;
+
+		auto& st = *st_;
+#if defined(COOPER_SINGLE_THREADED)
+		event_loop::instance().wait([&st] { return !st.buf.empty() || st.done; });
+#endif
+
+		typename state::unique_guard g(st.lock);
+		st.cond.wait(g, [&st] { return !st.buf.empty() || st.done; });
+
+		if (st.buf.empty()) {
+			if (st.err)
+				std::rethrow_exception(st.err);
+			return false;
+		}
+
+		bool wake = st.take(val);
+		g.unlock();
+		if (wake)
+			st.post();
+		return true;
+	}
+	/**
+	 * Gets the next item from the stream, blocking until it's available.
+	 * @return The next item, or std::nullopt if the stream ended.
+	 * @throws Any exception thrown by the producer, once the items produced
+	 *  	   before it are read.
+	 */
+	std::optional<T> next() {
+		T val;
+		if (next(&val))
+			return val;
+		return std::nullopt;
+	}
+	/**
+	 * Gets the next item from the stream if one is available, without
+	 * blocking.
+	 * @param val Pointer to a variable to get the item.
+	 * @return @em true if an item was read, @em false if not.
+	 */
+	bool try_next(T* val) {
+		if (!st_)
+			return false;
+
+		typename state::unique_guard g(st_->lock);
+		if (st_->buf.empty())
+			return false;
+
+		bool wake = st_->take(val);
+		g.unlock();
+		if (wake)
+			st_->post();
+		return true;
+	}
+	/**
+	 * Determines if the stream ended, and all its items were read.
+	 * @return @em true if there are no more items, @em false if there
+	 *  	   might be.
+	 */
+	bool done() const {
+		if (!st_)
+			return true;
+		typename state::guard g(st_->lock);
+		return st_->done && st_->buf.empty();
+	}
+	/**
+	 * Gets the number of items that were produced, but not yet read.
+	 * @return The number of items in the buffer.
+	 */
+	size_t buffered() const {
+		if (!st_)
+			return 0;
+		typename state::guard g(st_->lock);
+		return st_->buf.size();
+	}
+	/**
+	 * Stops the producer and drops any items that were not read.
+	 * The generator is released in the work thread, after any batch that
+	 * it's running.
+	 */
+	void cancel() {
+		if (!st_)
+			return;
+
+		typename state::unique_guard g(st_->lock);
+		st_->cancelled = true;
+		st_->buf.clear();
+		bool wake = st_->parked;
+		st_->parked = false;
+		g.unlock();
+
+		if (wake)
+			st_->post();
+		st_.reset();
+	}
+	/**
+	 * Gets an iterator to the next item in the stream.
+	 * @return An iterator to the next item in the stream.
+	 */
+	iterator begin() { return iterator(this); }
+	/**
+	 * Gets the end iterator.
+	 * @return The end iterator.
+	 */
+	iterator end() { return iterator(); }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Starts a streaming reply from a generator on a work thread.
+ * @param thr The work thread to run the generator.
+ * @param gen The generator. It's called repeatedly in the work thread, and
+ *  		  returns a std::optional with the next item, or std::nullopt
+ *  		  at the end of the stream. It must be copyable.
+ * @param opts The flow control parameters.
+ * @return The stream to read the items.
+ */
+template <class Gen>
+auto make_stream(work_thread& thr, Gen gen,
+				 const stream_options& opts=stream_options{}) {
+	using value_type = typename std::invoke_result_t<Gen&>::value_type;
+	return stream<value_type>(thr, std::move(gen), opts);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_stream_h
@@ -0,0 +1,209 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file sync.h
+/// Synchronization primitives that compile away in the single-threaded build
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef __cooper_sync_h
+#define __cooper_sync_h
+
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <utility>
+#include "cooper/exception.h"
+
+namespace cooper {
+
+/**
+ * The synchronization primitives used by the core of the library.
+ *
+ * In a normal build these are just the ones from the standard library.
+ * When the library is built with COOPER_SINGLE_THREADED defined, all the
+ * work threads and timers share a single event loop in the application's
+ * main thread, so there's nothing to synchronize. Then these are
+ * replaced with types that have the same interface, but do nothing, and
+ * the containers that use them compile down to unsynchronized ones.
+ */
+namespace sync {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A mutex that does nothing.
+ * This can be used to parameterize a container that is only ever used by
+ * a single thread, like a thread-local cache.
+ */
+class null_mutex
+{
+public:
+	void lock() {}
+	bool try_lock() { return true; }
+	void unlock() {}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+#if !defined(COOPER_SINGLE_THREADED)
+
+/** The mutex type */
+using mutex = std::mutex;
+/** The condition variable type */
+using condition_variable = std::condition_variable;
+/** The atomic type */
+template <typename T>
+using atomic = std::atomic<T>;
+
+#else
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A condition variable for a program with a single thread.
+ *
+ * With only one thread, nothing can change the predicate while the caller
+ * waits. So a wait either succeeds immediately, or it can never succeed.
+ * The untimed waits throw a @ref would_block exception, and the timed
+ * ones time out immediately.
+ */
+class null_condition_variable
+{
+public:
+	void notify_one() {}
+	void notify_all() {}
+
+	template <class Lock, class Predicate>
+	void wait(Lock&, Predicate pred) {
+		if (!pred())
+			throw would_block();
+	}
+	template <class Lock, typename Rep, class Period, class Predicate>
+	bool wait_for(Lock&, const std::chrono::duration<Rep, Period>&,
+				  Predicate pred) {
+		return pred();
+	}
+	template <class Lock, class Clock, class Duration, class Predicate>
+	bool wait_until(Lock&, const std::chrono::time_point<Clock,Duration>&,
+					Predicate pred) {
+		return pred();
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A plain value with the interface of std::atomic.
+ * The memory order arguments are accepted and ignored.
+ */
+template <typename T>
+class plain_atomic
+{
+	T val_;
+
+public:
+	plain_atomic() =default;
+	constexpr plain_atomic(T val) : val_(val) {}
+
+	plain_atomic(const plain_atomic&) =delete;
+	plain_atomic& operator=(const plain_atomic&) =delete;
+
+	T load(std::memory_order =std::memory_order_seq_cst) const { return val_; }
+	void store(T val, std::memory_order =std::memory_order_seq_cst) { val_ = val; }
+
+	operator T() const { return val_; }
+	T operator=(T val) { return val_ = val; }
+
+	T exchange(T val, std::memory_order =std::memory_order_seq_cst) {
+		std::swap(val, val_);
+		return val;
+	}
+	bool compare_exchange_strong(T& expected, T desired,
+								 std::memory_order =std::memory_order_seq_cst,
+								 std::memory_order =std::memory_order_seq_cst) {
+		if (val_ == expected) {
+			val_ = desired;
+			return true;
+		}
+		expected = val_;
+		return false;
+	}
+	bool compare_exchange_weak(T& expected, T desired,
+							   std::memory_order ord1 =std::memory_order_seq_cst,
+							   std::memory_order ord2 =std::memory_order_seq_cst) {
+		return compare_exchange_strong(expected, desired, ord1, ord2);
+	}
+
+	T fetch_add(T n, std::memory_order =std::memory_order_seq_cst) {
+		T prev = val_;
+		val_ += n;
+		return prev;
+	}
+	T fetch_sub(T n, std::memory_order =std::memory_order_seq_cst) {
+		T prev = val_;
+		val_ -= n;
+		return prev;
+	}
+
+	T operator++() { return ++val_; }
+	T operator++(int) { return val_++; }
+	T operator--() { return --val_; }
+	T operator--(int) { return val_--; }
+	T operator+=(T n) { return val_ += n; }
+	T operator-=(T n) { return val_ -= n; }
+};
+
+/** The mutex type */
+using mutex = null_mutex;
+/** The condition variable type */
+using condition_variable = null_condition_variable;
+/** The atomic type */
+template <typename T>
+using atomic = plain_atomic<T>;
+
+#endif
+
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_sync_h
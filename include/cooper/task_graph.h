@@ -0,0 +1,320 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file task_graph.h
+/// Implementation of the class 'task_graph'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+
+#ifndef __cooper_task_graph_h
+#define __cooper_task_graph_h
+
+#include "cooper/work_thread.h"
+#include "cooper/sync.h"
+#include <functional>
+#include <initializer_list>
+#include <exception>
+#include <deque>
+#include <vector>
+#include <utility>
+#include <limits>
+#include <mutex>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A graph of dependent tasks that runs on a collection of work threads.
+ *
+ * Each node in the graph is a function and the set of nodes that it
+ * depends on. When the graph runs, each node is queued to a work thread
+ * as soon as the last of its dependencies completes, so independent
+ * branches run in parallel, without the caller having to chain futures by
+ * hand.
+ *
+ * A node's dependencies must already be in the graph when it's added, so
+ * the graph can't have any cycles. Data is passed between the nodes
+ * through state that the caller owns, like variables captured by
+ * reference. The graph guarantees that a node's writes are visible to the
+ * nodes that depend on it.
+ *
+ * @par
+ * By default a node runs on the thread of the dependency that completed
+ * last, since that's the one that made it ready, and which most likely
+ * has its input data in cache. Nodes with no dependencies are spread
+ * across the threads. This can be overridden by pinning a node to a
+ * specific thread with run_on(), or by asking for it to run on the same
+ * thread as a particular one of its inputs with run_near().
+ *
+ * @par
+ * A graph can be run any number of times. All the bookkeeping is built
+ * when the nodes are added, so a run only resets some counters. It can't
+ * be changed while it's running, and it can only run once at a time.
+ *
+ * @par
+ * If a node throws an exception, the nodes that have not yet started are
+ * skipped, and the first exception is thrown from wait(). A node that
+ * can't be queued, or is discarded from its thread's queue, fails the run
+ * with a @ref queue_closed error.
+ */
+class task_graph
+{
+public:
+	/** The type that identifies a node */
+	using node_id = size_t;
+	/** A value that means "no node" */
+	static constexpr node_id npos = std::numeric_limits<node_id>::max();
+
+private:
+	/** A node in the graph */
+	struct node {
+		/** The function to run */
+		std::function<void()> func;
+		/** The nodes that depend on this one */
+		std::vector<node_id> succ;
+		/** The number of nodes that this one depends on */
+		size_t nDep = 0;
+		/** The number of dependencies still to complete in this run */
+		sync::atomic<size_t> nPending{0};
+		/** The thread to run on, if pinned */
+		size_t thrIdx = npos;
+		/** The dependency to run near, if any */
+		node_id near = npos;
+		/** The thread on which the node ran */
+		size_t ranOn = npos;
+
+		explicit node(std::function<void()> f) : func(std::move(f)) {}
+	};
+
+	/** The nodes, which stay in place as more are added */
+	std::deque<node> nodes_;
+	/** The nodes with no dependencies */
+	std::vector<node_id> roots_;
+	/** The work threads for the current run */
+	work_threads* thrs_;
+	/** The number of nodes still to complete in this run */
+	sync::atomic<size_t> nRemaining_;
+	/** Whether a node failed in this run */
+	sync::atomic<bool> failed_;
+	/** Lock for the completion state */
+	sync::mutex lock_;
+	/** Signaled when a run completes */
+	sync::condition_variable doneCond_;
+	/** Whether a run is in progress */
+	bool running_;
+	/** The first exception from the run */
+	std::exception_ptr err_;
+
+	/** Simple, scope-based lock guard */
+	using guard = std::lock_guard<sync::mutex>;
+	/** General purpose guard */
+	using unique_guard = std::unique_lock<sync::mutex>;
+
+	/**
+	 * Move-only guard for a queued node.
+	 * If the node is dropped without running, such as when its thread's
+	 * queue is discarded, this fails the run and completes the node, so
+	 * that the run can still finish.
+	 */
+	struct node_guard {
+		task_graph* graph;
+		node_id id;
+		size_t thrIdx;
+
+		node_guard(task_graph* graph, node_id id, size_t thrIdx)
+			: graph(graph), id(id), thrIdx(thrIdx) {}
+		node_guard(node_guard&& other)
+			: graph(other.graph), id(other.id), thrIdx(other.thrIdx) {
+			other.graph = nullptr;
+		}
+		~node_guard() {
+			if (graph)
+				graph->drop(id, thrIdx);
+		}
+	};
+
+	/**
+	 * The nodes that a thread is completing for a graph.
+	 * Completing a node can drop the nodes that depend on it, which then
+	 * have to be completed as well. They're added to this list rather
+	 * than completed recursively, so that a long chain of them can't
+	 * overflow the stack.
+	 */
+	struct completion {
+		task_graph* graph;
+		std::vector<std::pair<node_id, size_t>> nodes;
+	};
+
+	/** Gets the completion in progress in the current thread, if any */
+	static completion*& current_completion();
+
+	/** Checks that a node ID is valid */
+	void check(node_id id) const;
+	/** Checks that the graph isn't running */
+	void check_idle();
+	/** Records the first exception and marks the run as failed */
+	void fail(std::exception_ptr err);
+	/**
+	 * Queues a node that is ready to run.
+	 * @param id The node.
+	 * @param prodIdx The thread of the dependency that made it ready, if
+	 *  			  any.
+	 */
+	void schedule(node_id id, size_t prodIdx);
+	/** Runs a node in a work thread, then completes it */
+	void run_node(node_id id, size_t thrIdx);
+	/** Fails the run, and completes a node that was dropped unrun */
+	void drop(node_id id, size_t thrIdx);
+	/**
+	 * Completes a node, scheduling the successors that are now ready,
+	 * and signaling the end of the run after the last node.
+	 * @param id The node.
+	 * @param thrIdx The thread on which the node ran.
+	 */
+	void complete(node_id id, size_t thrIdx);
+
+	// Non-copyable
+	task_graph(const task_graph&) =delete;
+	task_graph& operator=(const task_graph&) =delete;
+
+public:
+	/**
+	 * Creates an empty graph.
+	 */
+	task_graph() : thrs_(nullptr), nRemaining_(0), failed_(false), running_(false) {}
+	/**
+	 * Waits for any run that is in progress.
+	 */
+	~task_graph();
+	/**
+	 * Adds a node to the graph.
+	 * @param f The function for the node.
+	 * @param deps The nodes that must complete before this one runs.
+	 * @return The ID of the new node.
+	 * @throws std::out_of_range if a dependency is not in the graph.
+	 * @throws std::logic_error if the graph is running.
+	 */
+	node_id add(std::function<void()> f, std::initializer_list<node_id> deps={}) {
+		return add(std::move(f), deps.begin(), deps.end());
+	}
+	/**
+	 * Adds a node to the graph.
+	 * @param f The function for the node.
+	 * @param deps The nodes that must complete before this one runs.
+	 * @return The ID of the new node.
+	 * @throws std::out_of_range if a dependency is not in the graph.
+	 * @throws std::logic_error if the graph is running.
+	 */
+	node_id add(std::function<void()> f, const std::vector<node_id>& deps) {
+		return add(std::move(f), deps.data(), deps.data()+deps.size());
+	}
+	/**
+	 * Adds a node to the graph.
+	 * @param f The function for the node.
+	 * @param first Pointer to the first of the node's dependencies.
+	 * @param last Pointer past the last of the node's dependencies.
+	 * @return The ID of the new node.
+	 * @throws std::out_of_range if a dependency is not in the graph.
+	 * @throws std::logic_error if the graph is running.
+	 */
+	node_id add(std::function<void()> f, const node_id* first, const node_id* last);
+	/**
+	 * Pins a node to a specific thread.
+	 * @param id The node.
+	 * @param thrIdx The index of the thread in the collection that runs
+	 *  			 the graph. It wraps around if the collection is smaller.
+	 * @return A reference to this graph.
+	 */
+	task_graph& run_on(node_id id, size_t thrIdx);
+	/**
+	 * Asks for a node to run on the same thread as one of its
+	 * dependencies, regardless of which completes last.
+	 * @param id The node.
+	 * @param dep The dependency. This must be one of the node's
+	 *  		  dependencies.
+	 * @return A reference to this graph.
+	 * @throws std::invalid_argument if it's not a dependency of the node.
+	 */
+	task_graph& run_near(node_id id, node_id dep);
+	/**
+	 * Gets the number of nodes in the graph.
+	 * @return The number of nodes in the graph.
+	 */
+	size_t size() const { return nodes_.size(); }
+	/**
+	 * Gets the thread on which a node ran in the last run.
+	 * @param id The node.
+	 * @return The index of the thread on which the node last ran, or
+	 *  	   @ref npos if it hasn't run.
+	 */
+	size_t ran_on(node_id id) const;
+	/**
+	 * Starts a run of the graph, and returns immediately.
+	 * @param thrs The work threads to run the nodes.
+	 * @throws std::logic_error if the graph is already running.
+	 */
+	void start(work_threads& thrs);
+	/**
+	 * Waits for the current run to complete.
+	 * In the single-threaded build, this runs the event loop until it's
+	 * done.
+	 * @throws The first exception thrown by any of the nodes.
+	 */
+	void wait();
+	/**
+	 * Determines if a run is in progress.
+	 * @return @em true if a run is in progress, @em false if not.
+	 */
+	bool running();
+	/**
+	 * Runs the graph and waits for it to complete.
+	 * @param thrs The work threads to run the nodes.
+	 * @throws The first exception thrown by any of the nodes.
+	 */
+	void run(work_threads& thrs) {
+		start(thrs);
+		wait();
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_task_graph_h
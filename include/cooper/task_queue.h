@@ -48,6 +48,8 @@
 #include <limits>
 #include <deque>
 #include <queue>
+#include "cooper/sync.h"
+#include "cooper/mpmc_ring.h"
 
 namespace cooper {
 
@@ -92,6 +94,19 @@ namespace cooper {
  * shared pointers, as the "dead" part of the queue will not hold onto a
  * reference count after the item has been removed from the queue.
  *
+ * @par
+ * The queue can be closed to signal that no more items will be added to
+ * it. Any producers that are blocked waiting for room and any consumers
+ * blocked waiting for items are woken immediately. After that, new items
+ * are refused, but consumers can continue to drain the items that were
+ * already in the queue. Once it is empty, the blocking get() calls throw
+ * a @ref queue_closed exception, and the others return a failure.
+ *
+ * @par
+ * For heavily contended queues, a lock-free variant can be selected by
+ * using an @ref mpmc_ring as the container, like
+ * <tt>task_queue<T, mpmc_ring<T>></tt>. See the specialization below.
+ *
  * @param T The type of the items to be held in the queue.
  * @param Container The type of the underlying container to use. It must
  * support back(), front(), push_back(), pop_front().
@@ -112,24 +127,26 @@ public:
 
 private:
 	/** Object lock */
-	mutable std::mutex lock_;
+	mutable sync::mutex lock_;
 	/** Condition get signaled when item added to empty queue */
-	std::condition_variable notEmptyCond_;
+	sync::condition_variable notEmptyCond_;
 	/** Condition gets signaled when item removed from full queue */
-	std::condition_variable notFullCond_;
+	sync::condition_variable notFullCond_;
 	/** Condition gets signaled when all tasks completed */
-	std::condition_variable tasksDoneCond_;
+	sync::condition_variable tasksDoneCond_;
 	/** The capacity of the queue */
 	size_type cap_;
 	/** The number of outstanding tasks */
 	size_type nTask_;
+	/** Whether the queue was closed */
+	bool closed_;
 	/** The actual STL container to hold data */
 	std::queue<T,Container> que_;
 
 	/** Simple, scope-based lock guard */
-	using guard = std::lock_guard<std::mutex>;
+	using guard = std::lock_guard<sync::mutex>;
 	/** General purpose guard */
-	using unique_guard = std::unique_lock<std::mutex>;
+	using unique_guard = std::unique_lock<sync::mutex>;
 
 	/**
 	 * Places an item into the queue.
@@ -171,12 +188,12 @@ public:
 	 * Creates a task queue with the largest capacity supported by the
 	 * system.
 	 */
-	task_queue() : cap_{MAX_CAPACITY}, nTask_{0} {}
+	task_queue() : cap_{MAX_CAPACITY}, nTask_{0}, closed_{false} {}
 	/**
 	 * Creates a task queue with the specified maximum capacity.
 	 * @param cap The maximum number of items the queue can hold.
 	 */
-	explicit task_queue(size_t cap) : cap_{cap}, nTask_{0} {}
+	explicit task_queue(size_t cap) : cap_{cap}, nTask_{0}, closed_{false} {}
 	/**
 	 * Determine if the queue is empty.
 	 * @return @em true if there are no elements in the queue, @em false if
@@ -220,29 +237,72 @@ public:
 		guard g(lock_);
 		return nTask_;
 	}
+	/**
+	 * Closes the queue.
+	 * After this, no more items can be put into the queue, and any threads
+	 * blocked waiting to put or get items are woken immediately. Items
+	 * that are already in the queue can still be removed.
+	 */
+	void close() {
+		unique_guard g(lock_);
+		closed_ = true;
+		g.unlock();
+		notFullCond_.notify_all();
+		notEmptyCond_.notify_all();
+	}
+	/**
+	 * Determines if the queue was closed.
+	 * @return @em true if the queue was closed, @em false if not.
+	 */
+	bool closed() const {
+		guard g(lock_);
+		return closed_;
+	}
+	/**
+	 * Removes and discards all of the items in the queue.
+	 * The discarded items are no longer counted as outstanding tasks. The
+	 * items are destroyed after the lock is released.
+	 * @return The number of items that were discarded.
+	 */
+	size_type clear() {
+		std::queue<T,Container> que;
+		unique_guard g(lock_);
+		std::swap(que, que_);
+		auto n = que.size();
+		nTask_ -= n;
+		bool done = (n != 0 && nTask_ == 0);
+		g.unlock();
+		notFullCond_.notify_all();
+		if (done)
+			tasksDoneCond_.notify_all();
+		return n;
+	}
 	/**
 	 * Put an item into the queue.
 	 * If the queue is full, this will block the caller until items are
 	 * removed bringing the size less than the capacity.
 	 * @param val The value to add to the queue.
+	 * @throws queue_closed if the queue is closed.
 	 */
 	void put(value_type val) {
 		unique_guard g(lock_);
-		size_type n = que_.size();
-		if (n >= cap_)
-			notFullCond_.wait(g, [=]{return que_.size() < cap_;});
-		queue_item(g, n, std::move(val));
+		if (que_.size() >= cap_ && !closed_)
+			notFullCond_.wait(g, [=]{return que_.size() < cap_ || closed_;});
+		if (closed_)
+			throw queue_closed();
+		queue_item(g, que_.size(), std::move(val));
 	}
 	/**
 	 * Non-blocking attempt to place an item into the queue.
 	 * @param val The value to add to the queue.
 	 * @return @em true if the item was added to the queue, @em false if the
-	 *  	   item was not added because the queue is currently full.
+	 *  	   item was not added because the queue is currently full or
+	 *  	   closed.
 	 */
 	bool try_put(value_type val) {
 		unique_guard g(lock_);
 		size_type n = que_.size();
-		if (n >= cap_)
+		if (n >= cap_ || closed_)
 			return false;
 		queue_item(g, n, std::move(val));
 		return true;
@@ -254,15 +314,16 @@ public:
 	 * @param val The value to add to the queue.
 	 * @param relTime The amount of time to wait until timing out.
 	 * @return @em true if the value was added to the queue, @em false if a
-	 *  	   timeout occurred.
+	 *  	   timeout occurred or the queue is closed.
 	 */
 	template <typename Rep, class Period>
 	bool try_put_for(value_type val, const std::chrono::duration<Rep, Period>& relTime) {
 		unique_guard g(lock_);
-		size_type n = que_.size();
-		if (n >= cap_ && !notFullCond_.wait_for(g, relTime, [=]{return que_.size() < cap_;}))
+		if (que_.size() >= cap_ && !notFullCond_.wait_for(g, relTime, [=]{return que_.size() < cap_ || closed_;}))
 			return false;
-		queue_item(g, n, std::move(val));
+		if (closed_)
+			return false;
+		queue_item(g, que_.size(), std::move(val));
 		return true;
 	}
 	/**
@@ -273,15 +334,16 @@ public:
 	 * @param val The value to add to the queue.
 	 * @param absTime The absolute time to wait to before timing out.
 	 * @return @em true if the value was added to the queue, @em false if a
-	 *  	   timeout occurred.
+	 *  	   timeout occurred or the queue is closed.
 	 */
 	template <class Clock, class Duration>
 	bool try_put_until(value_type val, const std::chrono::time_point<Clock,Duration>& absTime) {
 		unique_guard g(lock_);
-		size_type n = que_.size();
-		if (n >= cap_ && !notFullCond_.wait_until(g, absTime, [=]{return que_.size() < cap_;}))
+		if (que_.size() >= cap_ && !notFullCond_.wait_until(g, absTime, [=]{return que_.size() < cap_ || closed_;}))
 			return false;
-		queue_item(g, n, std::move(val));
+		if (closed_)
+			return false;
+		queue_item(g, que_.size(), std::move(val));
 		return true;
 	}
 	/**
@@ -289,26 +351,30 @@ public:
 	 * If the queue is empty, this will block indefinitely until a value is
 	 * added to the queue by another thread,
 	 * @param val Pointer to a variable to receive the value.
+	 * @throws queue_closed if the queue is closed and empty.
 	 */
 	void get(value_type* val) {
 		unique_guard g(lock_);
-		auto n = que_.size();
-		if (n == 0)
-			notEmptyCond_.wait(g, [=]{return !que_.empty();});
-		*val = dequeue_item(g, n);
+		if (que_.empty() && !closed_)
+			notEmptyCond_.wait(g, [=]{return !que_.empty() || closed_;});
+		if (que_.empty())
+			throw queue_closed();
+		*val = dequeue_item(g, que_.size());
 	}
 	/**
 	 * Retrieve a value from the queue.
 	 * If the queue is empty, this will block indefinitely until a value is
 	 * added to the queue by another thread,
 	 * @return The value removed from the queue
+	 * @throws queue_closed if the queue is closed and empty.
 	 */
 	value_type get() {
 		unique_guard g(lock_);
-		auto n = que_.size();
-		if (n == 0)
-			notEmptyCond_.wait(g, [=]{return !que_.empty();});
-		return dequeue_item(g, n);
+		if (que_.empty() && !closed_)
+			notEmptyCond_.wait(g, [=]{return !que_.empty() || closed_;});
+		if (que_.empty())
+			throw queue_closed();
+		return dequeue_item(g, que_.size());
 	}
 	/**
 	 * Attempts to remove a value from the queue without blocking.
@@ -334,15 +400,16 @@ public:
 	 * @param val Pointer to a variable to receive the value.
 	 * @param relTime The amount of time to wait until timing out.
 	 * @return @em true if the value was removed the queue, @em false if a
-	 *  	   timeout occurred.
+	 *  	   timeout occurred, or the queue is closed and empty.
 	 */
 	template <typename Rep, class Period>
 	bool try_get_for(value_type* val, const std::chrono::duration<Rep, Period>& relTime) {
 		unique_guard g(lock_);
-		auto n = que_.size();
-		if (n == 0 && !notEmptyCond_.wait_for(g, relTime, [=]{return !que_.empty();}))
+		if (que_.empty() && !notEmptyCond_.wait_for(g, relTime, [=]{return !que_.empty() || closed_;}))
 			return false;
-		*val = dequeue_item(g, n);
+		if (que_.empty())
+			return false;
+		*val = dequeue_item(g, que_.size());
 		return true;
 	}
 	/**
@@ -353,15 +420,16 @@ public:
 	 * @param val Pointer to a variable to receive the value.
 	 * @param absTime The absolute time to wait to before timing out.
 	 * @return @em true if the value was removed from the queue, @em false
-	 *  	   if a timeout occurred.
+	 *  	   if a timeout occurred, or the queue is closed and empty.
 	 */
 	template <class Clock, class Duration>
 	bool try_get_until(value_type* val, const std::chrono::time_point<Clock,Duration>& absTime) {
 		unique_guard g(lock_);
-		auto n = que_.size();
-		if (n == 0 && !notEmptyCond_.wait_until(g, absTime, [=]{return !que_.empty();}))
+		if (que_.empty() && !notEmptyCond_.wait_until(g, absTime, [=]{return !que_.empty() || closed_;}))
 			return false;
-		*val = dequeue_item(g, n);
+		if (que_.empty())
+			return false;
+		*val = dequeue_item(g, que_.size());
 		return true;
 	}
 	/**
@@ -389,10 +457,412 @@ public:
 		if (nTask_ != 0)
 			tasksDoneCond_.wait(g, [=]{return nTask_ == 0;});
 	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A lock-free task queue, using a bounded ring buffer.
+ *
+ * This has the same interface and semantics as the general task_queue,
+ * but items move through an @ref mpmc_ring without taking a lock, so
+ * any number of producers and consumers don't serialize on a single mutex.
+ * The outstanding task count is kept in an atomic.
+ *
+ * The mutex and condition variables are only used to put a thread to
+ * sleep when it has to block, on an empty queue in get(), a full one in
+ * put(), or in wait(). A thread registers itself as a waiter before it
+ * checks the queue one last time under the lock, and the other side only
+ * touches the lock to wake it when it sees a registered waiter. So when
+ * nobody is blocked, the lock is never touched at all.
+ *
+ * @par
+ * The capacity is fixed when the queue is created, and is rounded up to a
+ * power of two. It can't be changed later.
+ *
+ * @par
+ * A put() that races with close() might still get its item in just after
+ * the queue is closed. Consumers can drain it normally.
+ *
+ * @param T The type of the items to be held in the queue. This must be
+ *  		default constructible and move-assignable.
+ */
+template <typename T>
+class task_queue<T, mpmc_ring<T>>
+{
+public:
+	/** The underlying container type to use for the queue. */
+	using container_type = mpmc_ring<T>;
+	/** The type of items to be held in the queue. */
+	using value_type = T;
+	/** The type used to specify number of items in the container. */
+	using size_type = typename container_type::size_type;
+
+	/** The default capacity of the queue. */
+	static constexpr size_type DFLT_CAPACITY = 1024;
+
+private:
+	/** Lock for sleeping and waking threads */
+	mutable sync::mutex lock_;
+	/** Condition get signaled when an item is added to the queue */
+	sync::condition_variable notEmptyCond_;
+	/** Condition gets signaled when an item is removed from the queue */
+	sync::condition_variable notFullCond_;
+	/** Condition gets signaled when all tasks completed */
+	sync::condition_variable tasksDoneCond_;
+	/** The number of threads blocked waiting for items */
+	sync::atomic<size_type> nGetWaiters_;
+	/** The number of threads blocked waiting for room */
+	sync::atomic<size_type> nPutWaiters_;
+	/** The number of outstanding tasks */
+	sync::atomic<size_type> nTask_;
+	/** Whether the queue was closed */
+	sync::atomic<bool> closed_;
+	/** The items */
+	container_type que_;
+
+	/** Simple, scope-based lock guard */
+	using guard = std::lock_guard<sync::mutex>;
+	/** General purpose guard */
+	using unique_guard = std::unique_lock<sync::mutex>;
+
+	/**
+	 * Wakes one thread waiting on the condition, if there are any.
+	 * This must be called without the lock, after the change that the
+	 * waiter is looking for was made. The fence pairs with the one in
+	 * a waiter after it registers, so that either we see the waiter, or
+	 * it sees our change.
+	 */
+	void wake_one(sync::atomic<size_type>& nWaiters, sync::condition_variable& cond) {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (nWaiters.load(std::memory_order_relaxed) != 0) {
+			{ guard g(lock_); }
+			cond.notify_one();
+		}
+	}
+	/**
+	 * Decrements the number of outstanding tasks, if any.
+	 * This wakes anyone waiting when the count gets to zero.
+	 * @param n The number of tasks to remove.
+	 */
+	void tasks_done(size_type n) {
+		auto prev = nTask_.load();
+		do {
+			if (prev == 0)
+				return;
+		}
+		while (!nTask_.compare_exchange_weak(prev, (n > prev) ? 0 : (prev - n)));
 
-	// TODO: Add a shutdown() method to prevent any new items from being
-	//		added to the queue.
+		if (n >= prev) {
+			{ guard g(lock_); }
+			tasksDoneCond_.notify_all();
+		}
+	}
+	/**
+	 * Tries to push an item, counting it as an outstanding task.
+	 * @param val The value to add to the queue. It's only moved from if it
+	 *  		  was added.
+	 * @return @em true if the item was added, @em false if the queue is
+	 *  	   full.
+	 */
+	bool push_item(value_type& val) {
+		// Count the task first, so that it can't be done before it's counted
+		++nTask_;
+		if (!que_.try_push(std::move(val))) {
+			tasks_done(1);
+			return false;
+		}
+		return true;
+	}
+	/**
+	 * Registers as a waiter, then waits on the condition until the
+	 * predicate is true, or the timeout expires.
+	 * The caller must hold the lock.
+	 */
+	template <class Wait>
+	bool wait_as(sync::atomic<size_type>& nWaiters, Wait fn) {
+		++nWaiters;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		bool ok;
+		try {
+			ok = fn();
+		}
+		catch (...) {
+			--nWaiters;
+			throw;
+		}
+		--nWaiters;
+		return ok;
+	}
+	/**
+	 * Puts an item in the queue, blocking for room for up to the specified
+	 * time.
+	 * @param val The value to add to the queue.
+	 * @param absTime The time to give up, or @em nullptr to wait forever.
+	 * @return @em true if the value was added, @em false on a timeout or
+	 *  	   if the queue is closed.
+	 */
+	template <class Clock, class Duration>
+	bool put_until(value_type& val, const std::chrono::time_point<Clock,Duration>* absTime) {
+		if (closed_)
+			return false;
+
+		if (!push_item(val)) {
+			bool added = false;
+			auto pred = [&] {
+				return closed_ || (added = push_item(val));
+			};
+
+			unique_guard g(lock_);
+			bool ok = wait_as(nPutWaiters_, [&] {
+				if (!absTime) {
+					notFullCond_.wait(g, pred);
+					return true;
+				}
+				return notFullCond_.wait_until(g, *absTime, pred);
+			});
+			g.unlock();
+
+			if (!ok || !added)
+				return false;
+		}
+		wake_one(nGetWaiters_, notEmptyCond_);
+		return true;
+	}
+	/**
+	 * Gets an item from the queue, blocking for one for up to the
+	 * specified time.
+	 * @param val Pointer to a variable to receive the value.
+	 * @param absTime The time to give up, or @em nullptr to wait forever.
+	 * @return @em true if a value was removed, @em false on a timeout or
+	 *  	   if the queue is closed and empty.
+	 */
+	template <class Clock, class Duration>
+	bool get_until(value_type* val, const std::chrono::time_point<Clock,Duration>* absTime) {
+		if (!que_.try_pop(val)) {
+			bool got = false;
+			auto pred = [&] {
+				return (got = que_.try_pop(val)) || closed_;
+			};
+
+			unique_guard g(lock_);
+			bool ok = wait_as(nGetWaiters_, [&] {
+				if (!absTime) {
+					notEmptyCond_.wait(g, pred);
+					return true;
+				}
+				return notEmptyCond_.wait_until(g, *absTime, pred);
+			});
+			g.unlock();
 
+			if (!ok || !got)
+				return false;
+		}
+		wake_one(nPutWaiters_, notFullCond_);
+		return true;
+	}
+
+	/** The time point type used to block without a timeout */
+	using no_timeout = std::chrono::steady_clock::time_point;
+
+	// Non-copyable
+	task_queue(const task_queue&) =delete;
+	task_queue& operator=(const task_queue&) =delete;
+
+public:
+	/**
+	 * Creates a task queue with the default capacity.
+	 */
+	task_queue() : task_queue(DFLT_CAPACITY) {}
+	/**
+	 * Creates a task queue with the specified capacity.
+	 * @param cap The maximum number of items the queue can hold. This is
+	 *  		  rounded up to a power of two.
+	 */
+	explicit task_queue(size_t cap)
+		: nGetWaiters_{0}, nPutWaiters_{0}, nTask_{0}, closed_{false}, que_{cap} {}
+	/**
+	 * Determine if the queue is empty.
+	 * With other threads using the queue, this is only a snapshot.
+	 * @return @em true if there are no elements in the queue, @em false if
+	 *  	   there are any items in the queue.
+	 */
+	bool empty() const { return que_.empty(); }
+	/**
+	 * Gets the capacity of the queue.
+	 * @return The maximum number of elements before the queue is full.
+	 */
+	size_type capacity() const { return que_.capacity(); }
+	/**
+	 * Gets the number of items in the queue.
+	 * With other threads using the queue, this is only a snapshot.
+	 * @return The number of items in the queue.
+	 */
+	size_type size() const { return que_.size(); }
+	/**
+	 * Gets the number of outstanding tasks.
+	 * @return The number of outstanding tasks.
+	 */
+	size_type num_tasks() const { return nTask_; }
+	/**
+	 * Closes the queue.
+	 * After this, no more items can be put into the queue, and any threads
+	 * blocked waiting to put or get items are woken immediately. Items
+	 * that are already in the queue can still be removed.
+	 */
+	void close() {
+		closed_ = true;
+		{ guard g(lock_); }
+		notFullCond_.notify_all();
+		notEmptyCond_.notify_all();
+	}
+	/**
+	 * Determines if the queue was closed.
+	 * @return @em true if the queue was closed, @em false if not.
+	 */
+	bool closed() const { return closed_; }
+	/**
+	 * Removes and discards all of the items in the queue.
+	 * The discarded items are no longer counted as outstanding tasks.
+	 * @return The number of items that were discarded.
+	 */
+	size_type clear() {
+		size_type n = 0;
+		value_type val;
+		while (que_.try_pop(&val)) {
+			val = value_type{};
+			++n;
+		}
+		if (n != 0) {
+			tasks_done(n);
+			{ guard g(lock_); }
+			notFullCond_.notify_all();
+		}
+		return n;
+	}
+	/**
+	 * Put an item into the queue.
+	 * If the queue is full, this will block the caller until items are
+	 * removed bringing the size less than the capacity.
+	 * @param val The value to add to the queue.
+	 * @throws queue_closed if the queue is closed.
+	 */
+	void put(value_type val) {
+		if (!put_until(val, static_cast<const no_timeout*>(nullptr)))
+			throw queue_closed();
+	}
+	/**
+	 * Non-blocking attempt to place an item into the queue.
+	 * @param val The value to add to the queue.
+	 * @return @em true if the item was added to the queue, @em false if the
+	 *  	   item was not added because the queue is currently full or
+	 *  	   closed.
+	 */
+	bool try_put(value_type val) {
+		if (closed_ || !push_item(val))
+			return false;
+		wake_one(nGetWaiters_, notEmptyCond_);
+		return true;
+	}
+	/**
+	 * Attempt to place an item in the queue with a bounded wait.
+	 * @param val The value to add to the queue.
+	 * @param relTime The amount of time to wait until timing out.
+	 * @return @em true if the value was added to the queue, @em false if a
+	 *  	   timeout occurred or the queue is closed.
+	 */
+	template <typename Rep, class Period>
+	bool try_put_for(value_type val, const std::chrono::duration<Rep, Period>& relTime) {
+		auto absTime = std::chrono::steady_clock::now() + relTime;
+		return put_until(val, &absTime);
+	}
+	/**
+	 * Attempt to place an item in the queue with a bounded wait to an
+	 * absolute time point.
+	 * @param val The value to add to the queue.
+	 * @param absTime The absolute time to wait to before timing out.
+	 * @return @em true if the value was added to the queue, @em false if a
+	 *  	   timeout occurred or the queue is closed.
+	 */
+	template <class Clock, class Duration>
+	bool try_put_until(value_type val, const std::chrono::time_point<Clock,Duration>& absTime) {
+		return put_until(val, &absTime);
+	}
+	/**
+	 * Retrieve a value from the queue.
+	 * If the queue is empty, this will block indefinitely until a value is
+	 * added to the queue by another thread,
+	 * @param val Pointer to a variable to receive the value.
+	 * @throws queue_closed if the queue is closed and empty.
+	 */
+	void get(value_type* val) {
+		if (!get_until(val, static_cast<const no_timeout*>(nullptr)))
+			throw queue_closed();
+	}
+	/**
+	 * Retrieve a value from the queue.
+	 * If the queue is empty, this will block indefinitely until a value is
+	 * added to the queue by another thread,
+	 * @return The value removed from the queue
+	 * @throws queue_closed if the queue is closed and empty.
+	 */
+	value_type get() {
+		value_type val;
+		get(&val);
+		return val;
+	}
+	/**
+	 * Attempts to remove a value from the queue without blocking.
+	 * @param val Pointer to a variable to receive the value.
+	 * @return @em true if a value was removed from the queue, @em false if
+	 *  	   the queue is empty.
+	 */
+	bool try_get(value_type* val) {
+		if (!que_.try_pop(val))
+			return false;
+		wake_one(nPutWaiters_, notFullCond_);
+		return true;
+	}
+	/**
+	 * Attempt to remove an item from the queue for a bounded amount of time.
+	 * @param val Pointer to a variable to receive the value.
+	 * @param relTime The amount of time to wait until timing out.
+	 * @return @em true if the value was removed the queue, @em false if a
+	 *  	   timeout occurred, or the queue is closed and empty.
+	 */
+	template <typename Rep, class Period>
+	bool try_get_for(value_type* val, const std::chrono::duration<Rep, Period>& relTime) {
+		auto absTime = std::chrono::steady_clock::now() + relTime;
+		return get_until(val, &absTime);
+	}
+	/**
+	 * Attempt to remove an item from the queue until an absolute time.
+	 * @param val Pointer to a variable to receive the value.
+	 * @param absTime The absolute time to wait to before timing out.
+	 * @return @em true if the value was removed from the queue, @em false
+	 *  	   if a timeout occurred, or the queue is closed and empty.
+	 */
+	template <class Clock, class Duration>
+	bool try_get_until(value_type* val, const std::chrono::time_point<Clock,Duration>& absTime) {
+		return get_until(val, &absTime);
+	}
+	/**
+	 * Mark a task complete.
+	 * This decrements the number of outstanding tasks. It must be called
+	 * by the receiver thread once for each item removed from the queue
+	 * when processing of the item is complete.
+	 */
+	void task_done() { tasks_done(1); }
+	/**
+	 * Waits for all tasks to complete.
+	 * Note that new tasks can be added and processed by other threads while
+	 * this is blocked.
+	 */
+	void wait() {
+		unique_guard g(lock_);
+		if (nTask_ != 0)
+			tasksDoneCond_.wait(g, [this]{return nTask_ == 0;});
+	}
 };
 
 /////////////////////////////////////////////////////////////////////////////
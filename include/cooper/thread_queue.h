@@ -49,6 +49,8 @@
 #include <deque>
 #include <queue>
 #include <algorithm>
+#include <utility>
+#include "cooper/sync.h"
 
 namespace cooper {
 
@@ -80,6 +82,14 @@ namespace cooper {
  * shared pointers, as the "dead" part of the queue will not hold onto a
  * reference count after the item has been removed from the queue.
  *
+ * @par
+ * The queue can be closed to signal that no more items will be added to
+ * it. Any producers that are blocked waiting for room and any consumers
+ * blocked waiting for items are woken immediately. After that, new items
+ * are refused, but consumers can continue to drain the items that were
+ * already in the queue. Once it is empty, the blocking get() calls throw
+ * a @ref queue_closed exception, and the others return a failure.
+ *
  * @param T The type of the items to be held in the queue.
  * @param Container The type of the underlying container to use. It must
  * support back(), front(), push_back(), pop_front().
@@ -100,20 +110,27 @@ public:
 
 private:
 	/** Object lock */
-	mutable std::mutex lock_;
+	mutable sync::mutex lock_;
 	/** Condition get signaled when item added to empty queue */
-	std::condition_variable notEmptyCond_;
+	sync::condition_variable notEmptyCond_;
 	/** Condition gets signaled then item removed from full queue */
-	std::condition_variable notFullCond_;
+	sync::condition_variable notFullCond_;
 	/** The capacity of the queue */
 	size_type cap_;
+	/** Whether the queue was closed */
+	bool closed_;
+	/** A queue adapter that exposes the underlying container */
+	struct queue_type : public std::queue<T,Container> {
+		Container& container() { return this->c; }
+		const Container& container() const { return this->c; }
+	};
 	/** The actual STL container to hold data */
-	std::queue<T,Container> que_;
+	queue_type que_;
 
 	/** Simple, scope-based lock guard */
-	using guard = std::lock_guard<std::mutex>;
+	using guard = std::lock_guard<sync::mutex>;
 	/** General purpose guard */
-	using unique_guard = std::unique_lock<std::mutex>;
+	using unique_guard = std::unique_lock<sync::mutex>;
 
 	/** Copy constructor is deleted  */
 	thread_queue(const thread_queue&) =delete;
@@ -123,13 +140,14 @@ public:
 	 * Creates a task queue with the largest capacity supported by the
 	 * system.
 	 */
-	thread_queue() : cap_(MAX_CAPACITY) {}
+	thread_queue() : cap_(MAX_CAPACITY), closed_(false) {}
 	/**
 	 * Creates a task queue with the specified maximum capacity.
      * @param cap The maximum number of items the queue can hold. This must
      *            be at least one.
 	 */
-	explicit thread_queue(size_t cap) : cap_(std::max<size_type>(cap, 1)) {}
+	explicit thread_queue(size_t cap)
+		: cap_(std::max<size_type>(cap, 1)), closed_(false) {}
 	/**
 	 * Determine if the queue is empty.
 	 * @return @em true if there are no elements in the queue, @em false if
@@ -169,16 +187,90 @@ public:
 		guard g(lock_);
 		return que_.size();
 	}
+	/**
+	 * Pre-allocates memory in the underlying container for the specified
+	 * number of items.
+	 * This is only available if the container supports it, like a
+	 * @ref ring_buffer, and is a way to keep memory allocations out of the
+	 * critical path when the queue first fills up.
+	 * @param n The number of items for which to allocate memory.
+	 */
+	template <class C=Container>
+	auto reserve(size_type n) -> decltype(std::declval<C&>().reserve(n)) {
+		guard g(lock_);
+		que_.container().reserve(n);
+	}
+	/**
+	 * Gets the number of items that the underlying container can hold
+	 * without allocating more memory.
+	 * This is only available if the container supports it, like a
+	 * @ref ring_buffer.
+	 * @return The number of items for which memory is allocated.
+	 */
+	template <class C=Container>
+	auto reserved() const -> decltype(std::declval<const C&>().capacity()) {
+		guard g(lock_);
+		return que_.container().capacity();
+	}
+	/**
+	 * Releases any memory in the underlying container that is not needed
+	 * for the items currently in the queue.
+	 * This is only available if the container supports it, like a
+	 * @ref ring_buffer or std::deque.
+	 */
+	template <class C=Container>
+	auto shrink_to_fit() -> decltype(std::declval<C&>().shrink_to_fit()) {
+		guard g(lock_);
+		que_.container().shrink_to_fit();
+	}
+	/**
+	 * Closes the queue.
+	 * After this, no more items can be put into the queue, and any threads
+	 * blocked waiting to put or get items are woken immediately. Items
+	 * that are already in the queue can still be removed.
+	 */
+	void close() {
+		unique_guard g(lock_);
+		closed_ = true;
+		g.unlock();
+		notFullCond_.notify_all();
+		notEmptyCond_.notify_all();
+	}
+	/**
+	 * Determines if the queue was closed.
+	 * @return @em true if the queue was closed, @em false if not.
+	 */
+	bool closed() const {
+		guard g(lock_);
+		return closed_;
+	}
+	/**
+	 * Removes and discards all of the items in the queue.
+	 * The items are destroyed after the lock is released, so it's safe for
+	 * their destructors to use the queue.
+	 * @return The number of items that were discarded.
+	 */
+	size_type clear() {
+		queue_type que;
+		unique_guard g(lock_);
+		std::swap(que, que_);
+		g.unlock();
+		notFullCond_.notify_all();
+		return que.size();
+	}
 	/**
 	 * Put an item into the queue.
 	 * If the queue is full, this will block the caller until items are
 	 * removed bringing the size less than the capacity.
 	 * @param val The value to add to the queue.
+	 * @throws queue_closed if the queue is closed.
 	 */
 	void put(value_type val) {
 		unique_guard g(lock_);
-		if (que_.size() >= cap_)
-			notFullCond_.wait(g, [=]{return que_.size() < cap_;});
+		if (que_.size() >= cap_ && !closed_)
+			notFullCond_.wait(g, [=]{return que_.size() < cap_ || closed_;});
+		if (closed_)
+			throw queue_closed();
         bool wasEmpty = que_.empty();
 		que_.emplace(std::move(val));
 		if (wasEmpty) {
@@ -190,12 +282,13 @@ public:
 	 * Non-blocking attempt to place an item into the queue.
 	 * @param val The value to add to the queue.
 	 * @return @em true if the item was added to the queue, @em false if the
-	 *  	   item was not added because the queue is currently full.
+	 *  	   item was not added because the queue is currently full or
+	 *  	   closed.
 	 */
 	bool try_put(value_type val) {
 		unique_guard g(lock_);
 		size_type n = que_.size();
-		if (n >= cap_)
+		if (n >= cap_ || closed_)
 			return false;
 		que_.emplace(std::move(val));
 		if (n == 0) {
@@ -211,12 +304,14 @@ public:
 	 * @param val The value to add to the queue.
 	 * @param relTime The amount of time to wait until timing out.
 	 * @return @em true if the value was added to the queue, @em false if a
-	 *  	   timeout occurred.
+	 *  	   timeout occurred or the queue is closed.
 	 */
 	template <typename Rep, class Period>
-	bool try_put_for(value_type* val, const std::chrono::duration<Rep, Period>& relTime) {
+	bool try_put_for(value_type val, const std::chrono::duration<Rep, Period>& relTime) {
 		unique_guard g(lock_);
-		if (que_.size() >= cap_ && !notFullCond_.wait_for(g, relTime, [=]{return que_.size() < cap_;}))
+		if (que_.size() >= cap_ && !notFullCond_.wait_for(g, relTime, [=]{return que_.size() < cap_ || closed_;}))
+			return false;
+		if (closed_)
 			return false;
         bool wasEmpty = que_.empty();
 		que_.emplace(std::move(val));
@@ -234,12 +329,14 @@ public:
 	 * @param val The value to add to the queue.
 	 * @param absTime The absolute time to wait to before timing out.
 	 * @return @em true if the value was added to the queue, @em false if a
-	 *  	   timeout occurred.
+	 *  	   timeout occurred or the queue is closed.
 	 */
 	template <class Clock, class Duration>
-	bool try_put_until(value_type* val, const std::chrono::time_point<Clock,Duration>& absTime) {
+	bool try_put_until(value_type val, const std::chrono::time_point<Clock,Duration>& absTime) {
 		unique_guard g(lock_);
-		if (que_.size() >= cap_ && !notFullCond_.wait_until(g, absTime, [=]{return que_.size() < cap_;}))
+		if (que_.size() >= cap_ && !notFullCond_.wait_until(g, absTime, [=]{return que_.size() < cap_ || closed_;}))
+			return false;
+		if (closed_)
 			return false;
         bool wasEmpty = que_.empty();
 		que_.emplace(std::move(val));
@@ -254,11 +351,14 @@ public:
 	 * If the queue is empty, this will block indefinitely until a value is
 	 * added to the queue by another thread,
 	 * @param val Pointer to a variable to receive the value.
+	 * @throws queue_closed if the queue is closed and empty.
 	 */
 	void get(value_type* val) {
 		unique_guard g(lock_);
+		if (que_.empty() && !closed_)
+			notEmptyCond_.wait(g, [=]{return !que_.empty() || closed_;});
 		if (que_.empty())
-			notEmptyCond_.wait(g, [=]{return !que_.empty();});
+			throw queue_closed();
 		*val = std::move(que_.front());
 		que_.pop();
 		if (que_.size() == cap_-1) {
@@ -271,11 +371,14 @@ public:
 	 * If the queue is empty, this will block indefinitely until a value is
 	 * added to the queue by another thread,
 	 * @return The value removed from the queue
+	 * @throws queue_closed if the queue is closed and empty.
 	 */
 	value_type get() {
 		unique_guard g(lock_);
+		if (que_.empty() && !closed_)
+			notEmptyCond_.wait(g, [=]{return !que_.empty() || closed_;});
 		if (que_.empty())
-			notEmptyCond_.wait(g, [=]{return !que_.empty();});
+			throw queue_closed();
 		value_type val = std::move(que_.front());
 		que_.pop();
 		if (que_.size() == cap_-1) {
@@ -312,12 +415,14 @@ public:
 	 * @param val Pointer to a variable to receive the value.
 	 * @param relTime The amount of time to wait until timing out.
 	 * @return @em true if the value was removed the queue, @em false if a
-	 *  	   timeout occurred.
+	 *  	   timeout occurred, or the queue is closed and empty.
 	 */
 	template <typename Rep, class Period>
 	bool try_get_for(value_type* val, const std::chrono::duration<Rep, Period>& relTime) {
 		unique_guard g(lock_);
-		if (que_.empty() && !notEmptyCond_.wait_for(g, relTime, [=]{return !que_.empty();}))
+		if (que_.empty() && !notEmptyCond_.wait_for(g, relTime, [=]{return !que_.empty() || closed_;}))
+			return false;
+		if (que_.empty())
 			return false;
 		*val = std::move(que_.front());
 		que_.pop();
@@ -335,12 +440,14 @@ public:
 	 * @param val Pointer to a variable to receive the value.
 	 * @param absTime The absolute time to wait to before timing out.
 	 * @return @em true if the value was removed from the queue, @em false
-	 *  	   if a timeout occurred.
+	 *  	   if a timeout occurred, or the queue is closed and empty.
 	 */
 	template <class Clock, class Duration>
 	bool try_get_until(value_type* val, const std::chrono::time_point<Clock,Duration>& absTime) {
 		unique_guard g(lock_);
-		if (que_.empty() && !notEmptyCond_.wait_until(g, absTime, [=]{return !que_.empty();}))
+		if (que_.empty() && !notEmptyCond_.wait_until(g, absTime, [=]{return !que_.empty() || closed_;}))
+			return false;
+		if (que_.empty())
 			return false;
 		*val = std::move(que_.front());
 		que_.pop();
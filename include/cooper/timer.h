@@ -46,7 +46,9 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include "cooper/event_loop.h"
 
 namespace cooper {
 
@@ -62,11 +64,12 @@ public:
 
 private:
 	func_type func_;
+	std::chrono::nanoseconds initTime_;
+	std::chrono::nanoseconds interval_;
+#if !defined(COOPER_SINGLE_THREADED)
 	std::thread thr_;
 	std::mutex lock_;
 	std::condition_variable cond_;
-	std::chrono::nanoseconds initTime_;
-	std::chrono::nanoseconds interval_;
 	std::atomic<bool> quit_;
 
 	/** Simple, scope-based lock guard */
@@ -75,10 +78,28 @@ private:
 	using unique_guard = std::unique_lock<std::mutex>;
 
 	void thread_func();
+#else
+	/** Whether the timer is registered with the event loop */
+	bool running_;
+	/** Whether the callback is running, so the loop doesn't re-enter it */
+	bool firing_;
+	/** The time that the timer next expires */
+	std::chrono::steady_clock::time_point expiry_;
+
+	friend class event_loop;
+
+	/** Called by the event loop when the timer expires */
+	void fire();
+#endif
 
 public:
+#if !defined(COOPER_SINGLE_THREADED)
 	timer() : quit_{false} {}
 	timer(func_type f) : func_(std::move(f)), quit_{false} {}
+#else
+	timer() : running_{false}, firing_{false} {}
+	timer(func_type f) : func_(std::move(f)), running_{false}, firing_{false} {}
+#endif
 
 	virtual ~timer() { stop(); }
 
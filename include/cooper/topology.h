@@ -0,0 +1,152 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file topology.h
+/// Implementation of the class 'cpu_topology'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_topology_h
+#define __cooper_topology_h
+
+#include <vector>
+#include <cstddef>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The location of a CPU in the memory hierarchy.
+ */
+struct cpu_info
+{
+	/** The CPU number, as used by the OS */
+	int cpu = 0;
+	/** The NUMA node that the CPU is on */
+	size_t node = 0;
+	/**
+	 * The core complex that the CPU is in: the group of cores that share
+	 * a last-level cache. These are numbered across the whole machine.
+	 */
+	size_t complex = 0;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The layout of the CPUs in a machine, by NUMA node and core complex.
+ *
+ * This is used to keep work close to where it started: on the same core
+ * complex, where it can share the cache, or at least the same node, where
+ * it can share the local memory.
+ *
+ * The layout can be read from the system, or built by hand to describe
+ * a machine, or a subset of one.
+ */
+class cpu_topology
+{
+	/** The CPUs */
+	std::vector<cpu_info> cpus_;
+	/** The number of nodes */
+	size_t nNode_ = 0;
+
+public:
+	/**
+	 * Creates an empty topology.
+	 */
+	cpu_topology() =default;
+	/**
+	 * Reads the topology of the system.
+	 * On Linux this comes from sysfs. Elsewhere, or if that fails, all the
+	 * CPUs are put in a single node and complex.
+	 * @return The topology of the system.
+	 */
+	static cpu_topology detect();
+	/**
+	 * Creates a regular topology, numbering the CPUs in order.
+	 * @param nNode The number of NUMA nodes.
+	 * @param nComplex The number of core complexes in each node.
+	 * @param nCpu The number of CPUs in each complex.
+	 * @return The topology.
+	 */
+	static cpu_topology uniform(size_t nNode, size_t nComplex, size_t nCpu);
+	/**
+	 * Adds a CPU to the topology.
+	 * @param cpu The CPU number.
+	 * @param node The NUMA node that the CPU is on.
+	 * @param complex The core complex that the CPU is in.
+	 */
+	void add(int cpu, size_t node, size_t complex);
+	/**
+	 * Gets the number of CPUs.
+	 * @return The number of CPUs.
+	 */
+	size_t size() const { return cpus_.size(); }
+	/**
+	 * Gets the number of NUMA nodes.
+	 * This is one more than the highest node number.
+	 * @return The number of NUMA nodes.
+	 */
+	size_t num_nodes() const { return nNode_; }
+	/**
+	 * Gets the location of a CPU.
+	 * @param i The index of the CPU in the topology.
+	 * @return The location of the CPU.
+	 */
+	const cpu_info& operator[](size_t i) const { return cpus_[i]; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+/**
+ * Pins the calling thread to a CPU.
+ * This is only a hint. It's only supported on Linux, and if it fails, the
+ * thread runs wherever the OS puts it.
+ * @param cpu The CPU number.
+ */
+void pin_to_cpu(int cpu);
+
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_topology_h
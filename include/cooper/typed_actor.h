@@ -0,0 +1,290 @@
+/////////////////////////////////////////////////////////////////////////////
+/// @file typed_actor.h
+/// Implementation of the class 'typed_actor'
+/// @date 18-Oct-2026
+/////////////////////////////////////////////////////////////////////////////
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#ifndef __cooper_typed_actor_h
+#define __cooper_typed_actor_h
+
+#include "cooper/actor.h"
+#include "cooper/ring_buffer.h"
+#include <cassert>
+#include <variant>
+#include <mutex>
+#include <memory>
+#include <type_traits>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Base class for an actor with a fixed protocol of typed messages.
+ *
+ * A normal actor receives each message as a type-erased closure, which
+ * costs an allocation and an indirect call, and can't be inspected once
+ * it's queued. A typed actor instead declares the types of the messages
+ * that it accepts. They are held in its own mailbox as a std::variant of
+ * those types, stored inline in a ring buffer, so once the buffer has
+ * grown to size, sending a message doesn't allocate.
+ *
+ * The mailbox is drained by a task queued to the actor's thread whenever
+ * it goes from empty to non-empty. So there is at most one closure per
+ * burst of messages, not one per message. Each message is handed to the
+ * derived class's handle() overload for its type, chosen with std::visit
+ * over the variant, which compiles to a jump table. There are no virtual
+ * calls.
+ *
+ * The derived class needs a handle() member function for each message
+ * type, which can be private if this class is made a friend. Messages
+ * are passed as non-const references, so the handler can move from them.
+ *
+ * @par
+ * The actor can be destroyed with messages still queued. Those messages
+ * are discarded. But if it can be destroyed from another thread while
+ * messages are pending, the derived class must call stop() at the start
+ * of its destructor, so that the handlers are done before any of its
+ * members are torn down. A debug build asserts this in the base
+ * destructor. A handler can also destroy its own actor. Any messages
+ * left in the batch are then discarded.
+ *
+ * @par
+ * An exception thrown by a handler is discarded, the same as with any
+ * other task on a work thread, and the actor moves on to the next
+ * message.
+ *
+ * @par
+ * Each drain task only handles the messages that were queued when it
+ * started. If more arrive in the meantime, another task is queued to the
+ * thread, behind those of any other actors on the thread, so a busy
+ * actor can't starve the others.
+ *
+ * @param T The derived actor type.
+ * @param Msgs The types of messages that the actor accepts.
+ */
+template <typename T, typename... Msgs>
+class typed_actor : public this_actor<T>
+{
+public:
+	/** The type held in the mailbox */
+	using message_type = std::variant<Msgs...>;
+
+private:
+	/** The type of the message buffers */
+	using buffer_type = ring_buffer<message_type>;
+
+	/**
+	 * The mailbox.
+	 * This is shared with the drain tasks so that a task that is still
+	 * queued when the actor is destroyed can find out and do nothing.
+	 */
+	struct mailbox {
+		/** The actor's thread */
+		work_thread& thr;
+		/** Lock for the messages and actor pointer */
+		std::mutex lock;
+		/** The queued messages */
+		buffer_type msgs;
+		/** Whether a task is queued to drain the mailbox */
+		bool scheduled = false;
+		/** The actor, or null once it was stopped */
+		T* owner;
+		/** Held while the messages are being handled */
+		std::mutex drainLock;
+		/** The messages being handled. Only used in the actor thread. */
+		buffer_type batch;
+
+		mailbox(work_thread& thr, T* owner) : thr(thr), owner(owner) {}
+	};
+
+	/** The mailbox */
+	std::shared_ptr<mailbox> mbox_;
+
+	/** Simple, scope-based lock guard */
+	using guard = std::lock_guard<std::mutex>;
+
+	/** Queues a task to drain the mailbox */
+	static void schedule(const std::shared_ptr<mailbox>& mbox) {
+		try {
+			mbox->thr.cast([mbox] { drain(mbox); });
+		}
+		catch (...) {
+			guard g(mbox->lock);
+			mbox->scheduled = false;
+			throw;
+		}
+	}
+	/**
+	 * Handles the messages in the mailbox.
+	 * This runs in the actor thread.
+	 */
+	static void drain(const std::shared_ptr<mailbox>& mbox) {
+		guard dg(mbox->drainLock);
+		T* self;
+		{
+			guard g(mbox->lock);
+			if ((self = mbox->owner) == nullptr)
+				return;
+			mbox->msgs.swap(mbox->batch);
+		}
+
+		// The owner can only be cleared under us by a handler destroying
+		// the actor, since a destructor on another thread would need the
+		// drain lock that we're holding.
+		auto& batch = mbox->batch;
+		while (!batch.empty() && mbox->owner) {
+			try {
+				std::visit([self](auto& msg) { self->handle(msg); }, batch.front());
+			}
+			catch (...) {}
+			batch.pop_front();
+		}
+
+		if (!mbox->owner) {
+			batch.clear();
+			return;
+		}
+
+		bool sched;
+		{
+			guard g(mbox->lock);
+			sched = mbox->scheduled = !mbox->msgs.empty();
+		}
+		if (sched)
+			schedule(mbox);
+	}
+	/** Queues a message that was just put into the mailbox */
+	template <typename... Args>
+	void put(Args&&... args) {
+		bool sched;
+		{
+			guard g(mbox_->lock);
+			mbox_->msgs.emplace_back(std::forward<Args>(args)...);
+			sched = !mbox_->scheduled;
+			mbox_->scheduled = true;
+		}
+		if (sched)
+			schedule(mbox_);
+	}
+
+protected:
+	/**
+	 * Detaches the actor from its mailbox.
+	 * After this, no more messages are handled, and any still in the
+	 * mailbox are discarded. If called from another thread, this waits for
+	 * the actor to finish handling any messages that it's working on.
+	 * @par
+	 * A derived class that can be destroyed from another thread must call
+	 * this at the start of its destructor. Otherwise, a handler could
+	 * still be running while the derived members are destroyed. It's safe
+	 * to call more than once.
+	 */
+	void stop() {
+		std::unique_lock<std::mutex> dg(mbox_->drainLock, std::defer_lock);
+		if (!actor::on_actor_thread())
+			dg.lock();
+		guard g(mbox_->lock);
+		mbox_->owner = nullptr;
+		mbox_->msgs.clear();
+	}
+
+public:
+	/**
+	 * Creates a typed actor.
+	 */
+	typed_actor()
+		: mbox_(std::make_shared<mailbox>(actor::get_thread(), static_cast<T*>(this))) {}
+	/**
+	 * Creates a typed actor on a specific thread.
+	 * @param thr The thread for the actor.
+	 */
+	explicit typed_actor(work_thread& thr)
+		: this_actor<T>(thr),
+			mbox_(std::make_shared<mailbox>(thr, static_cast<T*>(this))) {}
+	/**
+	 * Destroys the actor.
+	 * Any messages still in the mailbox are discarded. This calls stop(),
+	 * but by now the derived part of the actor is gone, so a derived class
+	 * that is destroyed from another thread needs to call it first. In a
+	 * debug build, this asserts that it did, if any messages were pending.
+	 */
+	~typed_actor() {
+#if !defined(NDEBUG)
+		if (!actor::on_actor_thread()) {
+			guard g(mbox_->lock);
+			assert(!mbox_->owner || (!mbox_->scheduled && mbox_->msgs.empty()));
+		}
+#endif
+		stop();
+	}
+	/**
+	 * Sends a message to the actor.
+	 * @param msg The message. This must be one of the types that the
+	 *  		  actor accepts, or convertible to one.
+	 */
+	template <typename M>
+	void send(M&& msg) {
+		static_assert(std::is_constructible_v<message_type, M&&>,
+					  "The actor does not accept this type of message");
+		put(std::forward<M>(msg));
+	}
+	/**
+	 * Sends a message to the actor, constructing it in place.
+	 * @param args The arguments for the constructor of the message.
+	 */
+	template <typename M, typename... Args>
+	void emplace(Args&&... args) {
+		put(std::in_place_type<M>, std::forward<Args>(args)...);
+	}
+	/**
+	 * Pre-allocates space in the mailbox.
+	 * @param n The number of messages for which to allocate memory.
+	 */
+	void reserve(size_t n) {
+		guard g(mbox_->lock);
+		mbox_->msgs.reserve(n);
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// __cooper_typed_actor_h
@@ -47,13 +47,114 @@
 #include <utility>
 #include <atomic>
 #include <functional>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <mutex>
 #include "cooper/thread_queue.h"
+#include "cooper/ring_buffer.h"
 #include "cooper/func_wrapper.h"
+#include "cooper/sync.h"
+#include "cooper/event_loop.h"
+#include "cooper/arena.h"
 
 namespace cooper {
 
 /////////////////////////////////////////////////////////////////////////////
 
+/**
+ * How to handle the pending tasks when shutting down work threads.
+ */
+enum class shutdown_mode
+{
+	/** Run all the tasks that were already queued, then exit. */
+	drain,
+	/**
+	 * Discard the tasks that are still queued, then exit.
+	 * Any callers waiting on the futures for those tasks get a
+	 * std::future_error with a "broken promise" error code.
+	 */
+	discard
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Parameters to warm up work threads before they are put into service.
+ *
+ * The first tasks sent to a new thread are slow because its memory is
+ * cold. The queue needs to allocate memory, the thread's stack pages have
+ * not been mapped, and the allocator's caches for the thread are empty.
+ * These specify how much of each to prime in advance.
+ */
+struct warm_up_options
+{
+	/**
+	 * The number of tasks that the queue should hold before it needs to
+	 * allocate more memory.
+	 */
+	size_t queue_capacity = 0;
+	/**
+	 * The number of bytes of the thread's stack to touch, so that the
+	 * pages are mapped in advance. This must be less than the size of the
+	 * thread's stack.
+	 */
+	size_t stack_size = 0;
+	/**
+	 * The number of task-sized blocks of memory to cycle through the
+	 * allocator in the thread.
+	 */
+	size_t num_allocs = 0;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+class core_mesh;
+
+/**
+ * Waits for a future to be ready and gets its value.
+ * In the single-threaded build, this runs the event loop until the future
+ * is ready.
+ * @param fut The future.
+ * @return The value from the future.
+ * @throws would_block in the single-threaded build, if the loop runs out
+ *  	   of work before the future is ready.
+ */
+template <typename T>
+T get_result(std::future<T> fut) {
+#if defined(COOPER_SINGLE_THREADED)
+	event_loop::instance().wait([&fut] {
+		return fut.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	});
+#endif
+	return fut.get();
+}
+
+/**
+ * Waits for a shared future to be ready and gets a copy of its value.
+ * In the single-threaded build, this runs the event loop until the future
+ * is ready.
+ * @param fut The future.
+ * @return The value from the future.
+ * @throws would_block in the single-threaded build, if the loop runs out
+ *  	   of work before the future is ready.
+ */
+template <typename T>
+T get_result(std::shared_future<T> fut) {
+#if defined(COOPER_SINGLE_THREADED)
+	event_loop::instance().wait([&fut] {
+		return fut.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	});
+#endif
+	return fut.get();
+}
+
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 /**
  * A single thread that can execute arbitrary functions sequentially.
  * The work queue acts as a task executor that can run arbitrary functions
@@ -64,20 +165,132 @@ namespace cooper {
  */
 class work_thread
 {
+#if !defined(COOPER_SINGLE_THREADED)
 	/** The thread to perform the work */
 	std::thread thr_;
+#endif
+	/** The type of queue for the tasks */
+	using queue_type = thread_queue<func_wrapper, ring_buffer<func_wrapper>>;
+
 	/** The queue of tasks to perform */
-	thread_queue<func_wrapper> que_;
-	/** Signal to quit the thread */
-	std::atomic<bool> quit_;
+	queue_type que_;
+	/** The number of tasks submitted to the thread */
+	sync::atomic<uint64_t> nSubmitted_;
+	/** The number of tasks that the thread has completed */
+	sync::atomic<uint64_t> nCompleted_;
+#if !defined(COOPER_SINGLE_THREADED)
+	/** Becomes ready when the thread function exits */
+	std::future<void> done_;
+#else
+	/** Whether a task is running, so the loop doesn't re-enter it */
+	bool running_;
+
+	friend class event_loop;
+#endif
+	/** Lock to order closing the queue with queuing of final tasks */
+	sync::mutex finLock_;
+	/** Final tasks that were submitted after the queue was closed */
+	std::vector<func_wrapper> finals_;
+	/** Whether the thread has finished running the final tasks */
+	bool finished_;
+	/** The arena for the tasks, if any. Only used in the thread. */
+	std::unique_ptr<arena> arena_;
+#if !defined(COOPER_SINGLE_THREADED)
+	/** The mesh that connects the thread to its peers, if any */
+	std::atomic<detail::core_mesh*> mesh_;
+	/** The thread's position in the mesh */
+	size_t meshIdx_;
+
+	friend class detail::core_mesh;
+	friend class core_threads;
+#endif
+
+	/** General purpose guard */
+	using unique_guard = std::unique_lock<sync::mutex>;
+
+#if !defined(COOPER_SINGLE_THREADED)
 	/** The function to run in the thread's context  */
 	void thread_func();
+	/**
+	 * Gets the work thread that is running on the calling thread, if any.
+	 * @return The work thread that is running on the calling thread, or
+	 *  	   nullptr.
+	 */
+	static work_thread*& current() {
+		thread_local work_thread* thr = nullptr;
+		return thr;
+	}
+	/**
+	 * Queues a task to a thread in a mesh. Tasks from other threads in
+	 * the same mesh go through the dedicated queue for the pair, and all
+	 * others go through the regular queue.
+	 * @param mesh The thread's mesh.
+	 * @param task The task to queue.
+	 * @throws queue_closed if the thread was closed.
+	 */
+	void mesh_enqueue(detail::core_mesh* mesh, func_wrapper&& task);
+#else
+	/**
+	 * Runs the next task from the event loop, or the final tasks once
+	 * the queue is closed and drained.
+	 * @return @em true if anything ran, @em false if not.
+	 */
+	bool run_one();
+#endif
+	/** Runs the final tasks after the queue is closed and drained */
+	void run_finals();
+	/**
+	 * Runs a task in the thread's context, and counts it as completed.
+	 * The thread's arena, if any, is current while the task runs, and is
+	 * reset after the task is destroyed.
+	 * @param task The task to run. It's left empty.
+	 */
+	void run_task(func_wrapper& task) {
+		{
+			arena::scope sc(arena_.get());
+			try {
+				task();
+			}
+			catch (...) {}
+			task = func_wrapper();
+		}
+		++nCompleted_;
+	}
+	/**
+	 * Puts a task into the queue, keeping count of it.
+	 * @param task The task to queue.
+	 * @throws queue_closed if the thread was closed.
+	 */
+	void enqueue(func_wrapper task) {
+#if defined(COOPER_SINGLE_THREADED)
+		// Make room in a full queue by running the loop
+		if (que_.size() >= que_.capacity()) {
+			event_loop::instance().run_until([this] {
+				return que_.size() < que_.capacity() || que_.closed();
+			});
+		}
+#endif
+		++nSubmitted_;
+		try {
+#if !defined(COOPER_SINGLE_THREADED)
+			if (auto mesh = mesh_.load(std::memory_order_acquire)) {
+				mesh_enqueue(mesh, std::move(task));
+				return;
+			}
+#endif
+			que_.put(std::move(task));
+		}
+		catch (...) {
+			--nSubmitted_;
+			throw;
+		}
+	}
 
 public:
 	/**
 	 * Type for specifying size and capacity of internal thread queue.
 	 */
-	using size_type = thread_queue<func_wrapper>::size_type;
+	using size_type = queue_type::size_type;
 	/**
 	 * Create a new work thread and start it running.
 	 */
@@ -86,24 +299,97 @@ public:
 	 * Destroys the work thread, blocking until all tasks are complete.
 	 */
 	~work_thread();
+	/**
+	 * Closes the thread to new tasks.
+	 * This returns immediately. The thread will run all the tasks that
+	 * were already queued, and then exit. Any attempt to submit a new task
+	 * after this will throw a @ref queue_closed exception.
+	 */
+	void close();
+	/**
+	 * Determines if the thread was closed to new tasks.
+	 * @return @em true if the thread was closed, @em false if not.
+	 */
+	bool closed() const { return que_.closed(); }
 	/**
 	 * Request that the thread quit operation.
+	 * This is the same as close().
 	 */
-	void quit() {
-		quit_ = true;
-		cast([]{});
-	}
+	void quit() { close(); }
+	/**
+	 * Discards all the tasks that are currently queued.
+	 * Any callers waiting on the futures for those tasks get a
+	 * std::future_error with a "broken promise" error code.
+	 * @return The number of tasks discarded.
+	 */
+	size_type discard();
     /**
      * Joins the underlying thread, blocking until it completes all tasks.
+     * The thread must be closed, or this will block indefinitely.
      */
     void join() {
-        thr_.join();
+#if !defined(COOPER_SINGLE_THREADED)
+		if (thr_.joinable())
+			thr_.join();
+#else
+		event_loop::instance().wait([this] { return finished_; });
+#endif
     }
+	/**
+	 * Closes the thread and waits for it to exit.
+	 * @param mode Whether to run or discard the tasks that are still
+	 *  		   queued.
+	 */
+	void shutdown(shutdown_mode mode=shutdown_mode::drain);
+	/**
+	 * Closes the thread and waits a bounded amount of time for it to
+	 * run the tasks that are still queued. Any tasks left when the time
+	 * expires are discarded.
+	 * Note that a task that is running when the time expires can't be
+	 * interrupted, so this still blocks until it completes.
+	 * @param relTime The amount of time to drain the queue.
+	 * @return @em true if all the tasks ran, @em false if any were
+	 *  	   discarded.
+	 */
+	template <typename Rep, class Period>
+	bool shutdown_for(const std::chrono::duration<Rep, Period>& relTime) {
+		return shutdown_until(std::chrono::steady_clock::now() + relTime);
+	}
+	/**
+	 * Closes the thread and waits until an absolute time point for it to
+	 * run the tasks that are still queued. Any tasks left at that time are
+	 * discarded.
+	 * @param absTime The time at which to discard any remaining tasks.
+	 * @return @em true if all the tasks ran, @em false if any were
+	 *  	   discarded.
+	 */
+	bool shutdown_until(const std::chrono::steady_clock::time_point& absTime);
+	/**
+	 * Waits until an absolute time point for the thread to exit.
+	 * The thread must be closed for this to succeed.
+	 * @param absTime The absolute time to wait to before timing out.
+	 * @return @em true if the thread exited, @em false on a timeout.
+	 */
+	bool wait_until_done(const std::chrono::steady_clock::time_point& absTime) {
+#if !defined(COOPER_SINGLE_THREADED)
+		return done_.wait_until(absTime) == std::future_status::ready;
+#else
+		return event_loop::instance().run_until([this] { return finished_; }, absTime);
+#endif
+	}
 	/**
 	 * Get the ID of the work thread.
+	 * In the single-threaded build, this is the ID of the thread that runs
+	 * the event loop.
 	 * @return The ID of the work thread.
 	 */
-	std::thread::id get_id() const { return thr_.get_id(); }
+	std::thread::id get_id() const {
+#if !defined(COOPER_SINGLE_THREADED)
+		return thr_.get_id();
+#else
+		return event_loop::instance().get_id();
+#endif
+	}
 	/**
 	 * Gets the capacity of the task message queue.
 	 * @return The capacity of the task message queue.
@@ -135,6 +421,69 @@ public:
 	void queue_capacity(size_type cap) {
 		que_.capacity(cap);
 	}
+	/**
+	 * Pre-allocates memory in the task queue.
+	 * This lets the specified number of tasks be queued without the queue
+	 * having to allocate any more memory.
+	 * @param n The number of tasks for which to allocate memory.
+	 */
+	void queue_reserve(size_type n) {
+		que_.reserve(n);
+	}
+	/**
+	 * Gets the number of tasks that the queue can hold without allocating
+	 * more memory.
+	 * @return The number of tasks for which the queue has memory.
+	 */
+	size_type queue_reserved() const {
+		return que_.reserved();
+	}
+	/**
+	 * Releases any memory in the task queue that is not needed for the
+	 * tasks that are currently queued.
+	 * This can be used to give back the memory from a burst of activity
+	 * when the thread goes idle.
+	 */
+	void queue_shrink_to_fit() {
+		que_.shrink_to_fit();
+	}
+	/**
+	 * Warms up the thread before it is put into service.
+	 * This reserves memory in the queue, then sends a task to the thread
+	 * to touch its stack and prime the allocator in its context.
+	 * @param opts The amount of each resource to warm up.
+	 * @return A future that is ready when the thread is warmed up.
+	 */
+	std::future<void> warm_up(const warm_up_options& opts);
+	/**
+	 * Gives the thread a monotonic arena for its tasks.
+	 * While each task runs, the arena is available to it from
+	 * arena::current(), and it's reset after the task completes. So a
+	 * message handler can make all its temporary allocations from the
+	 * arena, and they're released in bulk with no per-object cost.
+	 * Since all the actors on the thread run one at a time, they share the
+	 * arena. If the thread already has one, this does nothing.
+	 * @param blockSize The size of the arena blocks.
+	 * @return A future that is ready when the arena is in place.
+	 */
+	std::future<void> use_arena(size_t blockSize=arena::DFLT_BLOCK_SIZE);
+	/**
+	 * Gets the total number of tasks that were submitted to the thread.
+	 * @return The total number of tasks that were submitted to the thread.
+	 */
+	uint64_t num_submitted() const { return nSubmitted_; }
+	/**
+	 * Gets the total number of tasks that the thread has completed.
+	 * @return The total number of tasks that the thread has completed.
+	 */
+	uint64_t num_completed() const { return nCompleted_; }
+	/**
+	 * Determines if the thread is idle.
+	 * This is the case when it has completed all the tasks submitted to
+	 * it, and thus has nothing queued or running.
+	 * @return @em true if the thread is idle, @em false if not.
+	 */
+	bool idle() const { return nCompleted_ == nSubmitted_; }
 	/**
 	 * Submit a task to the thread for execution.
 	 * This is an asynchronous call which queues the task to the internal
@@ -144,13 +493,14 @@ public:
 	 * @param f The function object for the thread to execute.
 	 * @return A future tied to the submitted task. It can be used to wait
 	 *  	   for the task to complete and retrieve its return value.
+	 * @throws queue_closed if the thread was closed.
 	 */
 	template<typename Func>
 	std::future<typename std::invoke_result_t<Func>> submit(Func f) {
 		using result_type = typename std::invoke_result_t<Func>;
 		std::packaged_task<result_type()> task(std::move(f));
 		std::future<result_type> fut(task.get_future());
-		que_.put(std::move(task));
+		enqueue(std::move(task));
 		return fut;
 	}
 	/**
@@ -183,7 +533,7 @@ public:
 	 */
 	template <class Func>
 	typename std::invoke_result_t<Func> call(Func&& f) {
-		return submit(std::forward<Func>(f)).get();
+		return detail::get_result(submit(std::forward<Func>(f)));
 	}
 	/**
 	 * Blocking call to wait for a task to execute in the internal thread.
@@ -199,20 +549,30 @@ public:
 	 */
 	template <class Func, class... Args>
 	typename std::invoke_result_t<Func,Args...> call(Func&& f, Args&&... args) {
-		return submit(std::forward<Func>(f), std::forward<Args>(args)...).get();
+		return detail::get_result(submit(std::forward<Func>(f), std::forward<Args>(args)...));
 	}
+	/**
+	 * Sends a task to run in the thread asynchronously, with no way to
+	 * get its result.
+	 * This queues the function object itself, without wrapping it in a
+	 * packaged task, so there's no shared state for a future. If the
+	 * task throws an exception, it is ignored. If the task is discarded,
+	 * the function object is destroyed without being called.
+	 * @param f The function object for the thread to execute
+	 * @throws queue_closed if the thread was closed.
+	 */
+	template <class Func>
+	void post(Func f) { enqueue(std::move(f)); }
 	/**
 	 * Sends a task to run in the thread asynchronously.
 	 * This is the same as @ref submit, but completely discards the return
 	 * value, indicating the intention of the caller that the task is purely
-	 * asynchronous.
+	 * asynchronous. Like post(), it doesn't create a future.
 	 * @param f The function object for the thread to execute
-	 * @param args The arguments to the function. These will be bound to the
-	 *  		   function and queued for execution.
-	 * @throws Any exception thrown by the task.
+	 * @throws queue_closed if the thread was closed.
 	 */
 	template <class Func>
-	void cast(Func&& f) { submit(std::forward<Func>(f)); }
+	void cast(Func&& f) { post(std::forward<Func>(f)); }
 	/**
 	 * Sends a task to run in the thread asynchronously.
 	 * This is the same as @ref submit, but completely discards the return
@@ -221,11 +581,11 @@ public:
 	 * @param f The function object for the thread to execute
 	 * @param args The arguments to the function. These will be bound to the
 	 *  		   function and queued for execution.
-	 * @throws Any exception thrown by the task.
+	 * @throws queue_closed if the thread was closed.
 	 */
 	template <class Func, class... Args>
 	void cast(Func&& f, Args&&... args) {
-		submit(std::forward<Func>(f), std::forward<Args>(args)...);
+		post(std::bind(std::forward<Func>(f), std::forward<Args>(args)...));
 	}
 	/**
 	 * Wait until all the tasks queued up until now have executed.
@@ -238,6 +598,34 @@ public:
 	 * this, while this call was blocked, waiting to execute.
 	 */
 	void flush() { call([]{}); }
+	/**
+	 * Sends a clean-up task that is guaranteed to run, even if the
+	 * thread is closed.
+	 * If the thread is open, this is the same as cast(). If it was closed,
+	 * but is still running, the task is held and run in the thread after
+	 * the queue is drained. If the thread already exited, the task runs
+	 * immediately, in the context of the caller.
+	 * @par
+	 * This is used to release resources, like actors, that are tied to the
+	 * thread. Note that a task queued while the thread was open can still
+	 * be dropped by discard().
+	 * @param f The function object to execute.
+	 */
+	template <class Func>
+	void finalize(Func f) {
+		unique_guard g(finLock_);
+		if (!finished_) {
+			if (!que_.closed())
+				enqueue(std::move(f));
+			else {
+				++nSubmitted_;
+				finals_.emplace_back(std::move(f));
+			}
+			return;
+		}
+		g.unlock();
+		f();
+	}
 };
 
 /////////////////////////////////////////////////////////////////////////////
@@ -251,7 +639,7 @@ class work_threads
 	/** The collection of worker threads */
     std::vector<work_thread> thrs_;
 	/** The count for the next available thread */
-	mutable std::atomic<size_t> nextThr_;
+	mutable sync::atomic<size_t> nextThr_;
 
 public:
 	/**
@@ -265,7 +653,7 @@ public:
 	 *
 	 * @param n The number of threads to add to the collection.
 	 */
-    work_threads(size_t n) : thrs_(n) {}
+    work_threads(size_t n) : thrs_(n), nextThr_(0) {}
     /**
      * Gets the index for the next thread that can be assigned.
      * @return size_t The index for the next thread that can be assigned.
@@ -281,6 +669,29 @@ public:
      * assigned.
      */
 	work_thread& next_thread() { return thrs_[next_thread_idx()]; }
+    /**
+     * Gets the index for the next thread that can be assigned, using a
+     * round-robin counter that is local to the calling thread.
+     *
+     * This spreads the assignments across the collection like
+     * next_thread_idx(), but without any contention on a shared counter.
+     * Each calling thread starts at a different point in the collection.
+     *
+     * @return size_t The index for the next thread that can be assigned.
+     */
+	size_t local_next_thread_idx() const {
+		thread_local size_t idx = std::hash<std::thread::id>()(std::this_thread::get_id());
+		return idx++ % thrs_.size();
+	}
+    /**
+     * Gets a reference to the next thread in the collection that can be
+     * assigned, using a round-robin counter that is local to the calling
+     * thread.
+     *
+     * @return A reference to the next thread in the collection that can be
+     * assigned.
+     */
+	work_thread& local_next_thread() { return thrs_[local_next_thread_idx()]; }
     /**
      * Gets a reference to the specific work thread in the collection.
      *
@@ -288,11 +699,121 @@ public:
      * @return A reference to the specific work thread in the collection.
      */
 	work_thread& operator[](size_t i) { return thrs_[i]; }
-
-	void flush() {
-		for (auto& thr : thrs_)
-			thr.flush();
+	/**
+	 * Destroys the collection, draining and stopping all the threads.
+	 */
+	~work_threads() { shutdown(); }
+	/**
+	 * Gets the number of threads in the collection.
+	 * @return The number of threads in the collection.
+	 */
+	size_t size() const { return thrs_.size(); }
+	/**
+	 * Wait until all the tasks queued to each of the threads, up until now,
+	 * have executed.
+	 * This queues an empty (no-op) function to all of the threads at once,
+	 * and then waits for all of them to execute. So it takes about as long
+	 * as the slowest thread rather than a round trip to each, in turn.
+	 * @par
+	 * Note that this does not account for tasks that the threads send to
+	 * each other while this is blocked. For that, see wait_quiescent().
+	 */
+	void flush();
+	/**
+	 * Warms up all of the threads before they are put into service.
+	 * The threads are all warmed up in parallel, and this blocks until
+	 * they are all done.
+	 * @param opts The amount of each resource to warm up in each thread.
+	 */
+	void warm_up(const warm_up_options& opts);
+	/**
+	 * Gives each of the threads a monotonic arena for its tasks.
+	 * This blocks until they are all in place.
+	 * @param blockSize The size of the arena blocks.
+	 * @sa work_thread::use_arena()
+	 */
+	void use_arena(size_t blockSize=arena::DFLT_BLOCK_SIZE);
+	/**
+	 * Determines if the whole collection is quiescent.
+	 * This is when all the threads are idle, and there are no tasks in
+	 * flight between them.
+	 * @par
+	 * This takes a snapshot of the completed task counter for all of the
+	 * threads, followed by one of the submitted task counters. Since the
+	 * counters only increase, and a task that sends a message to another
+	 * thread bumps the receiver's submitted count before its own completed
+	 * count, the two totals can only match if every thread was idle and
+	 * nothing moved between them while the counters were read.
+	 * @par
+	 * Tasks submitted by threads outside the collection are not accounted
+	 * for until they are actually queued.
+	 * @return @em true if the collection is quiescent, @em false if not.
+	 */
+	bool quiescent() const;
+	/**
+	 * Waits for the whole collection to be quiescent.
+	 * This blocks until all of the threads are idle, and there are no
+	 * tasks in flight between them, including any tasks sent from one
+	 * thread to another while this was waiting.
+	 */
+	void wait_quiescent();
+	/**
+	 * Waits a bounded amount of time for the whole collection to be
+	 * quiescent.
+	 * @param relTime The amount of time to wait until timing out.
+	 * @return @em true if the collection is quiescent, @em false if a
+	 *  	   timeout occurred.
+	 */
+	template <typename Rep, class Period>
+	bool try_wait_quiescent_for(const std::chrono::duration<Rep, Period>& relTime) {
+		return try_wait_quiescent_until(std::chrono::steady_clock::now() + relTime);
+	}
+	/**
+	 * Waits until an absolute time point for the whole collection to be
+	 * quiescent.
+	 * @param absTime The absolute time to wait to before timing out.
+	 * @return @em true if the collection is quiescent, @em false if a
+	 *  	   timeout occurred.
+	 */
+	bool try_wait_quiescent_until(const std::chrono::steady_clock::time_point& absTime);
+	/**
+	 * Closes all of the threads to new tasks.
+	 * This returns immediately. Each of the threads will run the tasks
+	 * that were already queued to it, and then exit. Note that after this,
+	 * any task that tries to send a message to another thread in the
+	 * collection will fail. To let the threads finish the work that they
+	 * pass between themselves, call wait_quiescent() first.
+	 */
+	void close();
+	/**
+	 * Closes all of the threads and waits for them to exit.
+	 * All the threads are signaled first, so they can drain or discard
+	 * their queues in parallel, and then they are joined.
+	 * @param mode Whether to run or discard the tasks that are still
+	 *  		   queued.
+	 */
+	void shutdown(shutdown_mode mode=shutdown_mode::drain);
+	/**
+	 * Closes all of the threads and waits a bounded amount of time for
+	 * them to run the tasks that are still queued. Any tasks left when the
+	 * time expires are discarded.
+	 * @param relTime The amount of time to drain the queues.
+	 * @return @em true if all the tasks ran, @em false if any were
+	 *  	   discarded.
+	 */
+	template <typename Rep, class Period>
+	bool shutdown_for(const std::chrono::duration<Rep, Period>& relTime) {
+		return shutdown_until(std::chrono::steady_clock::now() + relTime);
 	}
+	/**
+	 * Closes all of the threads and waits until an absolute time point for
+	 * them to run the tasks that are still queued. Any tasks left at that
+	 * time are discarded.
+	 * @param absTime The time at which to discard any remaining tasks.
+	 * @return @em true if all the tasks ran, @em false if any were
+	 *  	   discarded.
+	 */
+	bool shutdown_until(const std::chrono::steady_clock::time_point& absTime);
 };
 
 /////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,109 @@
+// arena.cpp
+//
+// This file is part of the cooper project.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#include "cooper/arena.h"
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+// arena
+
+// This is the slow path, when the request doesn't fit in what's left of
+// the current block. Large requests get their own allocation, and leave
+// the current block alone, so the rest of it can still be used.
+
+void* arena::next_block(size_t n, size_t align)
+{
+	// Enough to fit the request at any alignment of the block
+	size_t sz = n + align - 1;
+
+	if (sz > blockSize_) {
+		large_.emplace_back(new char[sz]);
+		auto addr = (uintptr_t(large_.back().get()) + (align - 1)) & ~uintptr_t(align - 1);
+		nUsed_ += n;
+		return reinterpret_cast<void*>(addr);
+	}
+
+	if (ptr_)
+		++curBlk_;
+
+	if (curBlk_ >= blocks_.size()) {
+		blocks_.emplace_back(new char[blockSize_]);
+		curBlk_ = blocks_.size() - 1;
+	}
+
+	ptr_ = blocks_[curBlk_].get();
+	end_ = ptr_ + blockSize_;
+	return do_allocate(n, align);
+}
+
+// --------------------------------------------------------------------------
+// The work thread calls this after every task, so it only rewinds the
+// pointer. Nothing is freed but the large allocations.
+
+void arena::reset()
+{
+	if (!large_.empty())
+		large_.clear();
+	curBlk_ = 0;
+	if (blocks_.empty())
+		ptr_ = end_ = nullptr;
+	else {
+		ptr_ = blocks_[0].get();
+		end_ = ptr_ + blockSize_;
+	}
+	nUsed_ = 0;
+}
+
+// --------------------------------------------------------------------------
+
+void arena::release()
+{
+	large_.clear();
+	blocks_.clear();
+	curBlk_ = 0;
+	ptr_ = end_ = nullptr;
+	nUsed_ = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
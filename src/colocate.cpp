@@ -0,0 +1,399 @@
+// colocate.cpp
+//
+// This file is part of the cooper project.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+
+#include "cooper/colocate.h"
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include <cmath>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+// colocator
+
+colocator::colocator(const colocate_options& opts)
+	: opts_(opts), nThread_(0), nPass_(0), nMove_(0),
+		tmr_([this]{ rebalance(); })
+{
+}
+
+colocator::colocator(const std::chrono::nanoseconds& interval,
+					 const colocate_options& opts)
+	: colocator(opts)
+{
+	tmr_.start(interval);
+}
+
+// --------------------------------------------------------------------------
+
+colocator::~colocator()
+{
+	tmr_.stop();
+}
+
+// --------------------------------------------------------------------------
+
+size_t colocator::size()
+{
+	std::lock_guard<std::mutex> g(lock_);
+	return actors_.size();
+}
+
+// --------------------------------------------------------------------------
+
+void colocator::add(mobile_actor* act)
+{
+	std::lock_guard<std::mutex> g(lock_);
+	actors_.insert(act);
+}
+
+// --------------------------------------------------------------------------
+
+void colocator::remove(mobile_actor* act)
+{
+	std::lock_guard<std::mutex> g(lock_);
+	actors_.erase(act);
+}
+
+// --------------------------------------------------------------------------
+// The actors can't be destroyed while we hold the lock, so it's safe to
+// look at all of them, and to move them. The traffic counts can hold
+// pointers to actors that are gone, so those are only used as keys, and
+// ignored unless they're still registered.
+//
+// The actors with the most traffic are placed first, since they have the
+// most to gain. Each one goes to the thread where its partners are, as
+// long as that thread isn't full. The placement is updated as we go, so
+// later actors see where the earlier ones went.
+
+size_t colocator::rebalance()
+{
+	using traffic_map = std::unordered_map<mobile_actor*, uint64_t>;
+
+	std::lock_guard<std::mutex> g(lock_);
+	++nPass_;
+
+	size_t n = actors_.size();
+	if (n == 0)
+		return 0;
+
+	std::unordered_map<mobile_actor*, work_thread*> where;
+	std::unordered_map<work_thread*, size_t> load;
+
+	for (auto act : actors_) {
+		auto thr = act->thr_.load();
+		where[act] = thr;
+		++load[thr];
+	}
+	nThread_ = std::max(nThread_, load.size());
+
+	auto cap = size_t(std::ceil(opts_.balance * double(n) / double(nThread_)));
+	cap = std::max<size_t>(cap, 1);
+
+	// The traffic between each pair, in both directions
+
+	std::unordered_map<mobile_actor*, traffic_map> w;
+	for (auto act : actors_) {
+		for (auto [dest, cnt] : act->take_traffic()) {
+			if (dest != act && actors_.count(dest) != 0) {
+				w[act][dest] += cnt;
+				w[dest][act] += cnt;
+			}
+		}
+	}
+
+	std::vector<std::pair<uint64_t, mobile_actor*>> order;
+	for (const auto& [act, peers] : w) {
+		uint64_t tot = 0;
+		for (auto [peer, cnt] : peers)
+			tot += cnt;
+		order.emplace_back(tot, act);
+	}
+	std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+		return a.first > b.first;
+	});
+
+	size_t nMove = 0;
+	for (const auto& [tot, act] : order) {
+		if (nMove == opts_.max_moves)
+			break;
+
+		std::unordered_map<work_thread*, uint64_t> byThr;
+		for (auto [peer, cnt] : w[act])
+			byThr[where[peer]] += cnt;
+
+		auto cur = where[act];
+		uint64_t here = byThr[cur];
+
+		work_thread* best = nullptr;
+		uint64_t bestCnt = 0;
+
+		for (auto [thr, cnt] : byThr) {
+			if (thr != cur && cnt > bestCnt && load[thr] < cap) {
+				best = thr;
+				bestCnt = cnt;
+			}
+		}
+
+		if (best && bestCnt >= here + opts_.min_messages
+				&& double(bestCnt) >= opts_.gain * double(here)) {
+			where[act] = best;
+			--load[cur];
+			++load[best];
+			act->move_to(*best);
+			++nMove;
+		}
+	}
+
+	nMove_ += nMove;
+	return nMove;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// mobile_actor
+
+mobile_actor::mobile_actor(work_thread& thr)
+	: thr_(&thr), scheduled_(false), stopped_(false), dead_(nullptr),
+		col_(nullptr), nMove_(0)
+{
+}
+
+// --------------------------------------------------------------------------
+
+mobile_actor::mobile_actor(colocator& col, work_thread& thr)
+	: thr_(&thr), scheduled_(false), stopped_(false), dead_(nullptr),
+		col_(&col), nMove_(0)
+{
+	col_->add(this);
+}
+
+// If messages were pending or being handled, the derived class had to stop
+// the actor, or a handler could have run against its destroyed members.
+
+mobile_actor::~mobile_actor()
+{
+#if !defined(NDEBUG)
+	{
+		guard g(lock_);
+		assert(stopped_ || (!scheduled_ && mbox_.empty()));
+	}
+#endif
+	stop();
+}
+
+// --------------------------------------------------------------------------
+// Once we're out of the colocator, we can't be moved again. With the
+// mailbox emptied, any drain task finishes after the message it's on, but
+// we need to wait for it, since it points back at us. From inside one of
+// our own handlers, we tell the drain to stop without touching the actor
+// again, since it may be about to go away.
+
+void mobile_actor::stop()
+{
+	if (col_)
+		col_->remove(this);
+
+	bool self = (current() == this);
+	std::deque<func_wrapper> mbox;
+	{
+		guard g(lock_);
+		stopped_ = true;
+		std::swap(mbox, mbox_);
+		if (self) {
+			scheduled_ = false;
+			cond_.notify_all();
+		}
+	}
+	mbox.clear();
+
+	if (self) {
+		if (dead_)
+			*dead_ = true;
+		return;
+	}
+
+#if defined(COOPER_SINGLE_THREADED)
+	event_loop::instance().run_until([this] { return !scheduled_; });
+#endif
+	unique_guard g(lock_);
+	cond_.wait(g, [this] { return !scheduled_; });
+}
+
+// --------------------------------------------------------------------------
+// A message sent from the handler of another actor in the same colocator
+// counts as traffic between the two. The count is kept by the sender, and
+// only touched by its thread and the colocator, so the lock is normally
+// uncontended.
+
+void mobile_actor::send(func_wrapper f)
+{
+	auto from = current();
+	if (col_ && from && from != this && from->col_ == col_) {
+		std::lock_guard<std::mutex> g(from->trafficLock_);
+		++from->sent_[this];
+	}
+
+	bool sched;
+	{
+		guard g(lock_);
+		if (stopped_)
+			throw queue_closed();
+		mbox_.push_back(std::move(f));
+		sched = !scheduled_;
+		scheduled_ = true;
+	}
+	if (sched)
+		schedule();
+}
+
+// --------------------------------------------------------------------------
+
+// If the task can't be queued, the guard is destroyed right here, and
+// cancels the drain.
+
+void mobile_actor::schedule()
+{
+	auto thr = thr_.load();
+	thr->post([dt=drain_task(this), thr]() mutable {
+		auto act = dt.act;
+		dt.act = nullptr;
+		act->drain(thr);
+	});
+}
+
+// --------------------------------------------------------------------------
+// The messages are destroyed after the lock is released, in case their
+// destructors send anything back to us.
+
+void mobile_actor::cancel_drain()
+{
+	std::deque<func_wrapper> mbox;
+	{
+		guard g(lock_);
+		std::swap(mbox, mbox_);
+		scheduled_ = false;
+		cond_.notify_all();
+	}
+}
+
+// --------------------------------------------------------------------------
+// Only one drain task is ever queued, so the messages are handled in order,
+// on one thread at a time. If the actor was moved, the task hands off to
+// the new thread, which picks up with the next message. It also yields
+// the thread after a batch, so a busy actor doesn't starve the others.
+// Once a handler has destroyed the actor, we can't touch it again.
+
+void mobile_actor::drain(work_thread* thr)
+{
+	auto prev = current();
+	current() = this;
+
+	bool dead = false;
+	dead_ = &dead;
+
+	for (size_t n=0; ; ++n) {
+		func_wrapper f;
+		{
+			unique_guard g(lock_);
+			if (mbox_.empty()) {
+				scheduled_ = false;
+				cond_.notify_all();
+				break;
+			}
+			if (thr_.load() != thr || n == MAX_BATCH) {
+				g.unlock();
+				try {
+					schedule();
+				}
+				catch (...) {}
+				break;
+			}
+			f = std::move(mbox_.front());
+			mbox_.pop_front();
+		}
+
+		try {
+			f();
+		}
+		catch (...) {}
+
+		if (dead) {
+			current() = prev;
+			return;
+		}
+	}
+
+	dead_ = nullptr;
+	current() = prev;
+}
+
+// --------------------------------------------------------------------------
+
+std::unordered_map<mobile_actor*, uint64_t> mobile_actor::take_traffic()
+{
+	std::lock_guard<std::mutex> g(trafficLock_);
+	auto traffic = sent_;
+
+	for (auto p = sent_.begin(); p != sent_.end(); ) {
+		if ((p->second /= 2) == 0)
+			p = sent_.erase(p);
+		else
+			++p;
+	}
+	return traffic;
+}
+
+// --------------------------------------------------------------------------
+
+void mobile_actor::move_to(work_thread& thr)
+{
+	guard g(lock_);
+	if (thr_.load() != &thr) {
+		thr_ = &thr;
+		++nMove_;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
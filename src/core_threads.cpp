@@ -0,0 +1,355 @@
+// core_threads.cpp
+//
+// This file is part of the cooper project.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+
+#include "cooper/core_threads.h"
+#include "cooper/topology.h"
+#include <thread>
+
+namespace cooper {
+
+#if !defined(COOPER_SINGLE_THREADED)
+
+/////////////////////////////////////////////////////////////////////////////
+// work_thread
+
+// Only a task running on a thread of the same mesh can use the pair
+// queues, since each one has a single producer.
+
+void work_thread::mesh_enqueue(detail::core_mesh* mesh, func_wrapper&& task)
+{
+	auto from = current();
+	if (from && from->mesh_.load(std::memory_order_relaxed) == mesh) {
+		mesh->send(from->meshIdx_, meshIdx_, std::move(task));
+		return;
+	}
+	que_.put(std::move(task));
+	mesh->wake(meshIdx_);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// core_mesh
+
+namespace detail {
+
+core_mesh::core_mesh(work_threads& thrs, const core_options& opts)
+	: n_(thrs.size()), batch_(std::max<size_t>(opts.batch, 1)),
+		cores_(new core[thrs.size()])
+{
+	links_.reserve(n_*n_);
+	for (size_t i=0; i<n_*n_; ++i)
+		links_.emplace_back(new link(opts.ring_capacity));
+
+	for (size_t i=0; i<n_; ++i)
+		cores_[i].thr = &thrs[i];
+}
+
+// --------------------------------------------------------------------------
+// Once a message goes to the overflow list, everything after it to the
+// same peer goes there too, until the receiver takes them, to keep them in
+// order.
+//
+// The sending flag closes the race with the receiver exiting. It's set
+// before checking that the receiver is still open, and the receiver checks
+// it after seeing that it's closed, so either we see the close and refuse
+// the message, or the receiver sees us and waits for the message to land.
+
+void core_mesh::send(size_t from, size_t to, func_wrapper&& task)
+{
+	auto& dst = cores_[to];
+	auto& lk = get_link(from, to);
+
+	lk.sending.store(true);
+	if (dst.closed.load()) {
+		lk.sending.store(false, std::memory_order_release);
+		throw queue_closed();
+	}
+
+	auto& src = cores_[from];
+
+	if (lk.nOverflow.load(std::memory_order_acquire) != 0
+			|| !lk.ring.try_push(std::move(task))) {
+		std::lock_guard<std::mutex> g(lk.lock);
+		lk.overflow.push_back(std::move(task));
+		lk.nOverflow.store(lk.overflow.size(), std::memory_order_release);
+		src.nOverflowed.store(src.nOverflowed.load(std::memory_order_relaxed) + 1,
+							  std::memory_order_relaxed);
+	}
+	lk.sending.store(false, std::memory_order_release);
+	wake(to);
+
+	src.nSent.store(src.nSent.load(std::memory_order_relaxed) + 1,
+					std::memory_order_relaxed);
+}
+
+// --------------------------------------------------------------------------
+// The overflow list is only taken once the queue is empty. The sender
+// stops using the queue as soon as the list isn't empty, so at that point
+// everything in the list is newer than anything that went through the
+// queue.
+
+size_t core_mesh::run_link(size_t from, size_t me)
+{
+	auto thr = cores_[me].thr;
+	auto& lk = get_link(from, me);
+	func_wrapper task;
+	size_t nRun = 0;
+
+	while (nRun < batch_ && lk.ring.try_pop(&task)) {
+		run_task(thr, task);
+		++nRun;
+	}
+
+	if (lk.nOverflow.load(std::memory_order_acquire) != 0 && lk.ring.empty()) {
+		std::deque<func_wrapper> ovf;
+		{
+			std::lock_guard<std::mutex> g(lk.lock);
+			std::swap(ovf, lk.overflow);
+			lk.nOverflow.store(0, std::memory_order_release);
+		}
+		for (auto& t : ovf) {
+			run_task(thr, t);
+			++nRun;
+		}
+	}
+	return nRun;
+}
+
+// --------------------------------------------------------------------------
+
+bool core_mesh::has_inbound(size_t me)
+{
+	for (size_t from=0; from<n_; ++from) {
+		auto& lk = get_link(from, me);
+		if (lk.sending.load() || !lk.ring.empty()
+				|| lk.nOverflow.load(std::memory_order_acquire) != 0)
+			return true;
+	}
+	return false;
+}
+
+// --------------------------------------------------------------------------
+
+bool core_mesh::has_work(size_t me)
+{
+	auto thr = cores_[me].thr;
+	return has_inbound(me) || !thr->que_.empty() || thr->que_.closed();
+}
+
+// --------------------------------------------------------------------------
+// The sleeping flag and the queues are checked in opposite orders by the
+// two sides, with a full fence in between on each, so either the thread
+// sees the new message, or the sender sees the flag and wakes it.
+
+void core_mesh::wake(size_t i)
+{
+	auto& c = cores_[i];
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (c.sleeping.load(std::memory_order_relaxed)) {
+		std::lock_guard<std::mutex> g(c.lock);
+		c.sleeping.store(false, std::memory_order_relaxed);
+		c.cond.notify_one();
+	}
+}
+
+// --------------------------------------------------------------------------
+
+void core_mesh::park(size_t me)
+{
+	auto& c = cores_[me];
+	c.sleeping.store(true, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (has_work(me)) {
+		c.sleeping.store(false, std::memory_order_relaxed);
+		return;
+	}
+
+	std::unique_lock<std::mutex> g(c.lock);
+	c.cond.wait(g, [&c] { return !c.sleeping.load(std::memory_order_relaxed); });
+}
+
+// --------------------------------------------------------------------------
+
+void core_mesh::run_task(work_thread* thr, func_wrapper& task)
+{
+	thr->run_task(task);
+}
+
+// --------------------------------------------------------------------------
+// The thread can only exit once it's closed, and there's nothing left for
+// it anywhere: its regular queue, or any inbound connection. The closed
+// flag has to be read before looking at the connections.
+
+void core_mesh::run(size_t me)
+{
+	constexpr int N_SPIN = 64;
+
+	auto& c = cores_[me];
+	auto thr = c.thr;
+	func_wrapper task;
+	int nIdle = 0;
+
+	while (true) {
+		size_t nRun = 0;
+
+		for (size_t from=0; from<n_; ++from)
+			nRun += run_link(from, me);
+
+		for (size_t k=0; k<batch_ && thr->que_.try_get(&task); ++k) {
+			run_task(thr, task);
+			++nRun;
+		}
+
+		if (nRun != 0) {
+			nIdle = 0;
+			continue;
+		}
+
+		if (c.closed.load() && thr->que_.closed()
+				&& !has_inbound(me) && thr->que_.empty())
+			break;
+
+		if (thr->que_.closed() || ++nIdle < N_SPIN)
+			std::this_thread::yield();
+		else {
+			park(me);
+			nIdle = 0;
+		}
+	}
+}
+
+// --------------------------------------------------------------------------
+
+uint64_t core_mesh::num_sent() const
+{
+	uint64_t n = 0;
+	for (size_t i=0; i<n_; ++i)
+		n += cores_[i].nSent.load(std::memory_order_relaxed);
+	return n;
+}
+
+// --------------------------------------------------------------------------
+
+uint64_t core_mesh::num_overflowed() const
+{
+	uint64_t n = 0;
+	for (size_t i=0; i<n_; ++i)
+		n += cores_[i].nOverflowed.load(std::memory_order_relaxed);
+	return n;
+}
+
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// core_threads
+
+// The threads are already running, blocked on their regular queues. Each
+// one is joined to the mesh, and then sent a task to pin it, which wakes
+// it up to switch over to polling the mesh.
+
+core_threads::core_threads(size_t n, const core_options& opts)
+	: work_threads(n), mesh_(new detail::core_mesh(*this, opts))
+{
+	for (size_t i=0; i<size(); ++i) {
+		auto& thr = (*this)[i];
+		thr.meshIdx_ = i;
+		thr.mesh_.store(mesh_.get(), std::memory_order_release);
+	}
+
+	auto nCpu = std::max(1u, std::thread::hardware_concurrency());
+
+	for (size_t i=0; i<size(); ++i) {
+		(*this)[i].post([cpu=int(i % nCpu), pin=opts.pin] {
+			if (pin)
+				detail::pin_to_cpu(cpu);
+		});
+	}
+}
+
+// --------------------------------------------------------------------------
+// The threads have to be stopped, and cut loose from the mesh, before it's
+// destroyed.
+
+core_threads::~core_threads()
+{
+	shutdown();
+	for (size_t i=0; i<size(); ++i)
+		(*this)[i].mesh_.store(nullptr);
+}
+
+// --------------------------------------------------------------------------
+
+uint64_t core_threads::num_mesh_sends() const
+{
+	return mesh_->num_sent();
+}
+
+// --------------------------------------------------------------------------
+
+uint64_t core_threads::num_overflows() const
+{
+	return mesh_->num_overflowed();
+}
+
+#else
+
+/////////////////////////////////////////////////////////////////////////////
+// core_threads
+
+core_threads::core_threads(size_t n, const core_options&) : work_threads(n)
+{
+}
+
+core_threads::~core_threads()
+{
+	shutdown();
+}
+
+uint64_t core_threads::num_mesh_sends() const { return 0; }
+
+uint64_t core_threads::num_overflows() const { return 0; }
+
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
@@ -0,0 +1,169 @@
+// event_loop.cpp
+//
+// This file is part of the cooper project.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+
+#if defined(COOPER_SINGLE_THREADED)
+
+#include "cooper/event_loop.h"
+#include "cooper/work_thread.h"
+#include "cooper/timer.h"
+#include <algorithm>
+
+using namespace std::chrono;
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+event_loop& event_loop::instance()
+{
+	static event_loop loop;
+	return loop;
+}
+
+// --------------------------------------------------------------------------
+
+void event_loop::add(work_thread* thr)
+{
+	thrs_.push_back(thr);
+}
+
+// --------------------------------------------------------------------------
+
+void event_loop::remove(work_thread* thr)
+{
+	thrs_.erase(std::remove(thrs_.begin(), thrs_.end(), thr), thrs_.end());
+}
+
+// --------------------------------------------------------------------------
+
+void event_loop::add(timer* tmr)
+{
+	timers_.push_back(tmr);
+}
+
+// --------------------------------------------------------------------------
+
+void event_loop::remove(timer* tmr)
+{
+	timers_.erase(std::remove(timers_.begin(), timers_.end(), tmr), timers_.end());
+}
+
+// --------------------------------------------------------------------------
+// A timer whose callback is running, further up the stack, is skipped.
+
+timer* event_loop::next_timer() const
+{
+	timer* next = nullptr;
+	for (auto tmr : timers_) {
+		if (!tmr->firing_ && (!next || tmr->expiry_ < next->expiry_))
+			next = tmr;
+	}
+	return next;
+}
+
+// --------------------------------------------------------------------------
+// Timers that are due go ahead of the tasks, so that a busy loop can't
+// starve them. The work threads are checked round-robin, starting after
+// the one that ran last. Tasks can add or remove threads and timers, so
+// nothing is held across a call.
+
+bool event_loop::poll_one()
+{
+	auto tmr = next_timer();
+	if (tmr && tmr->expiry_ <= clock::now()) {
+		tmr->fire();
+		return true;
+	}
+
+	for (size_t i=0, n=thrs_.size(); i<n; ++i) {
+		size_t idx = (next_ + i) % n;
+		if (thrs_[idx]->run_one()) {
+			next_ = idx + 1;
+			return true;
+		}
+	}
+	return false;
+}
+
+// --------------------------------------------------------------------------
+
+size_t event_loop::poll()
+{
+	size_t n = 0;
+	while (poll_one())
+		++n;
+	return n;
+}
+
+// --------------------------------------------------------------------------
+// With no tasks ready, the only thing that can happen is a timer expiring,
+// so the loop sleeps until the next one, if it comes before the timeout.
+
+bool event_loop::run_one_until(const clock::time_point& absTime)
+{
+	if (poll_one())
+		return true;
+
+	auto tmr = next_timer();
+	if (!tmr || tmr->expiry_ > absTime)
+		return false;
+
+	std::this_thread::sleep_until(tmr->expiry_);
+	tmr->fire();
+	return true;
+}
+
+// --------------------------------------------------------------------------
+
+size_t event_loop::run()
+{
+	size_t n = 0;
+	while (run_one())
+		++n;
+	return n;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif		// COOPER_SINGLE_THREADED
@@ -0,0 +1,232 @@
+// hibernate.cpp
+//
+// This file is part of the cooper project.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#include "cooper/hibernate.h"
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+using namespace std::chrono;
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+// hibernator
+
+hibernator::hibernator(const nanoseconds& idleTime, const nanoseconds& interval)
+	: nActor_(0), nPending_(0), epoch_(0), nIdle_(0), nHibernating_(0),
+		tmr_([this]{ sweep(); })
+{
+	nIdle_ = uint64_t(std::max<nanoseconds::rep>(1, idleTime / interval));
+	tmr_.start(interval);
+}
+
+// --------------------------------------------------------------------------
+// Once the timer is stopped, no new sweep tasks are sent, but we need to
+// wait for any that are still queued to the work threads. In the
+// single-threaded build, that means running them.
+
+hibernator::~hibernator()
+{
+	tmr_.stop();
+#if defined(COOPER_SINGLE_THREADED)
+	event_loop::instance().run_until([this] { return nPending_ == 0; });
+#else
+	while (nPending_ != 0)
+		std::this_thread::yield();
+#endif
+}
+
+// --------------------------------------------------------------------------
+// This runs in the actor's thread, as it handles its first message.
+
+void hibernator::add(hibernating_actor* act)
+{
+	thread_actors* acts;
+	{
+		std::lock_guard<std::mutex> g(lock_);
+		auto& p = actors_[&act->get_thread()];
+		if (!p)
+			p = std::make_unique<thread_actors>();
+		acts = p.get();
+	}
+
+	std::lock_guard<std::mutex> g(acts->lock);
+	acts->awake.insert(act);
+	act->acts_ = acts;
+	++nActor_;
+}
+
+// --------------------------------------------------------------------------
+
+void hibernator::remove(hibernating_actor* act)
+{
+	auto acts = act->acts_;
+	if (!acts)
+		return;
+
+	std::lock_guard<std::mutex> g(acts->lock);
+	if (acts->awake.erase(act) != 0 || acts->asleep.erase(act) != 0)
+		--nActor_;
+}
+
+// --------------------------------------------------------------------------
+// This runs in the actor's thread, as it handles the message that woke it.
+
+void hibernator::wake(hibernating_actor* act)
+{
+	auto acts = act->acts_;
+	std::lock_guard<std::mutex> g(acts->lock);
+	if (acts->asleep.erase(act) != 0)
+		acts->awake.insert(act);
+}
+
+// --------------------------------------------------------------------------
+// This only reads the epoch counters of the actors that are awake. A work
+// thread is sent a sweep task only if it has at least one that looks idle.
+// The tasks are sent without holding any locks, since a thread with a
+// bounded queue can block us, and it may need a lock to wake one of its
+// actors before it can make room.
+
+void hibernator::sweep()
+{
+	uint64_t epoch = ++epoch_;
+
+	sweepThrs_.clear();
+	{
+		std::lock_guard<std::mutex> g(lock_);
+		for (auto& [thr, acts] : actors_)
+			sweepThrs_.emplace_back(thr, acts.get());
+	}
+
+	for (auto [thr, acts] : sweepThrs_) {
+		bool idle = false;
+		{
+			std::lock_guard<std::mutex> g(acts->lock);
+			for (auto act : acts->awake) {
+				if (epoch - act->lastEpoch_.load(std::memory_order_relaxed) >= nIdle_) {
+					idle = true;
+					break;
+				}
+			}
+		}
+
+		if (idle) {
+			try {
+				thr->cast([this, acts=acts, ps=pending_sweep(this)] {
+					hibernate_idle(acts);
+				});
+			}
+			catch (...) {}
+		}
+	}
+}
+
+// --------------------------------------------------------------------------
+// This runs in the context of the work thread, so none of the actors on it
+// can be handling a message while we look at them. The thread's lock is
+// held while they hibernate so that an actor being destroyed from another
+// thread waits for us in remove().
+
+void hibernator::hibernate_idle(thread_actors* acts)
+{
+	std::lock_guard<std::mutex> g(acts->lock);
+	for (auto it = acts->awake.begin(); it != acts->awake.end(); ) {
+		auto act = *it;
+		try {
+			act->hibernate();
+		}
+		catch (...) {}
+
+		if (act->hibernating_) {
+			acts->asleep.insert(act);
+			it = acts->awake.erase(it);
+		}
+		else
+			++it;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// hibernating_actor
+
+hibernating_actor::hibernating_actor(hibernator& hib)
+	: hib_(hib), lastEpoch_(hib.epoch()), hibernating_(false),
+		acts_(nullptr), stopped_(false)
+{
+}
+
+// --------------------------------------------------------------------------
+
+hibernating_actor::hibernating_actor(hibernator& hib, work_thread& thr)
+	: actor(thr), hib_(hib), lastEpoch_(hib.epoch()), hibernating_(false),
+		acts_(nullptr), stopped_(false)
+{
+}
+
+// --------------------------------------------------------------------------
+
+// A registered actor destroyed from another thread must have been stopped
+// by the derived class, or a sweep could have hibernated it while the
+// derived members were being torn down.
+
+hibernating_actor::~hibernating_actor()
+{
+	assert(stopped_ || !acts_ || on_actor_thread());
+	stop();
+}
+
+// --------------------------------------------------------------------------
+// Once we're out of the hibernator, no sweep can touch us.
+
+void hibernating_actor::stop()
+{
+	stopped_ = true;
+	hib_.remove(this);
+	if (hibernating_) {
+		hibernating_ = false;
+		--hib_.nHibernating_;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
@@ -0,0 +1,244 @@
+// simulation.cpp
+//
+// This file is part of the cooper project.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#include "cooper/simulation.h"
+#include <algorithm>
+#include <iterator>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+// Cost models
+
+cost_model fixed_cost(sim_clock::duration cost)
+{
+	return [cost](std::mt19937_64&) { return cost; };
+}
+
+// --------------------------------------------------------------------------
+
+cost_model exponential_cost(sim_clock::duration mean)
+{
+	if (mean.count() <= 0)
+		return fixed_cost(sim_clock::duration{0});
+
+	return [mean](std::mt19937_64& rng) {
+		std::exponential_distribution<double> dist(1.0 / double(mean.count()));
+		return sim_clock::duration(sim_clock::rep(dist(rng)));
+	};
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// sim_thread
+
+sim_thread::sim_thread(sim_executor& sim, cost_model cost)
+	: sim_(sim), busy_(false), cost_(std::move(cost)), nCompleted_(0),
+		maxQueue_(0), busyTime_(0), waitTime_(0), maxWait_(0)
+{
+}
+
+// --------------------------------------------------------------------------
+// The task doesn't go into the queue until it arrives, so that the
+// thread doesn't start it early. Tasks arrive in order of time, and in
+// the order they were sent when the times are the same. So the arrival
+// events don't need to say which task they're for, and a random
+// ordering of simultaneous events can't reorder the messages from a
+// single sender.
+
+void sim_thread::send(sim_clock::duration cost, func_wrapper f)
+{
+	auto t = sim_.send_time();
+
+	auto p = inFlight_.end();
+	while (p != inFlight_.begin() && std::prev(p)->arrival > t)
+		--p;
+	inFlight_.insert(p, task{ std::move(f), cost, t });
+
+	sim_.schedule(t, [this] { arrive(); });
+}
+
+// --------------------------------------------------------------------------
+
+void sim_thread::arrive()
+{
+	que_.push_back(std::move(inFlight_.front()));
+	inFlight_.pop_front();
+	maxQueue_ = std::max(maxQueue_, que_.size());
+	if (!busy_)
+		dispatch();
+}
+
+// --------------------------------------------------------------------------
+// Runs the next task immediately, in real time, but marks the thread busy
+// for its simulated cost. Anything that the task sends arrives when it's
+// done.
+
+void sim_thread::dispatch()
+{
+	if (que_.empty())
+		return;
+
+	task t = std::move(que_.front());
+	que_.pop_front();
+
+	auto now = sim_.now();
+	auto cost = (t.cost.count() < 0) ? cost_(sim_.rng()) : t.cost;
+	auto end = now + cost;
+
+	auto wait = now - t.arrival;
+	waitTime_ += wait;
+	maxWait_ = std::max(maxWait_, wait);
+	busyTime_ += cost;
+	busy_ = true;
+
+	auto prevEnd = sim_.taskEnd_;
+	sim_.taskEnd_ = &end;
+	try {
+		t.f();
+	}
+	catch (...) {}
+	sim_.taskEnd_ = prevEnd;
+
+	sim_.schedule(end, [this] {
+		busy_ = false;
+		++nCompleted_;
+		dispatch();
+	});
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// sim_executor
+
+sim_executor::sim_executor(uint64_t seed, interleave policy)
+	: now_(), seq_(0), policy_(policy), rng_(seed), nextThr_(0),
+		taskEnd_(nullptr), lastTimer_(0), nEvents_(0)
+{
+}
+
+// --------------------------------------------------------------------------
+
+sim_thread& sim_executor::add_thread(cost_model cost)
+{
+	thrs_.push_back(std::make_unique<sim_thread>(*this, std::move(cost)));
+	return *thrs_.back();
+}
+
+// --------------------------------------------------------------------------
+
+void sim_executor::schedule(time_point t, func_wrapper f)
+{
+	auto seq = seq_++;
+	auto key = (policy_ == interleave::random) ? rng_() : seq;
+	events_.push_back(event{ std::max(t, now_), key, seq, std::move(f) });
+	std::push_heap(events_.begin(), events_.end(), later());
+}
+
+// --------------------------------------------------------------------------
+
+sim_executor::timer_id sim_executor::every(duration interval,
+										   std::function<void()> f)
+{
+	auto id = ++lastTimer_;
+	timers_.insert(id);
+	auto pf = std::make_shared<std::function<void()>>(std::move(f));
+	schedule(now_ + interval, [this, id, interval, pf] {
+		periodic(id, interval, pf);
+	});
+	return id;
+}
+
+// --------------------------------------------------------------------------
+
+void sim_executor::periodic(timer_id id, duration interval,
+							std::shared_ptr<std::function<void()>> f)
+{
+	if (timers_.count(id) == 0)
+		return;
+
+	(*f)();
+	schedule(now_ + interval, [this, id, interval, f] {
+		periodic(id, interval, f);
+	});
+}
+
+// --------------------------------------------------------------------------
+
+bool sim_executor::step()
+{
+	if (events_.empty())
+		return false;
+
+	std::pop_heap(events_.begin(), events_.end(), later());
+	event ev = std::move(events_.back());
+	events_.pop_back();
+
+	now_ = ev.t;
+	++nEvents_;
+	ev.f();
+	return true;
+}
+
+// --------------------------------------------------------------------------
+
+uint64_t sim_executor::run()
+{
+	uint64_t n = 0;
+	while (step())
+		++n;
+	return n;
+}
+
+// --------------------------------------------------------------------------
+
+uint64_t sim_executor::run_until(time_point t)
+{
+	uint64_t n = 0;
+	while (!events_.empty() && events_.front().t <= t) {
+		step();
+		++n;
+	}
+	now_ = std::max(now_, t);
+	return n;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
@@ -0,0 +1,320 @@
+// stealing_pool.cpp
+//
+// This file is part of the cooper project.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+
+#include "cooper/stealing_pool.h"
+
+#if !defined(COOPER_SINGLE_THREADED)
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+stealing_pool::stealing_pool(const cpu_topology& topo, const stealing_options& opts)
+	: topo_(topo.size() != 0 ? topo : cpu_topology::uniform(1, 1, 1)),
+		workers_(new worker[topo_.size()]),
+		inject_(new queue_type[topo_.num_nodes()]),
+		nextNode_(0), nQueued_(0), nPending_(0), nSleeping_(0), stop_(false)
+{
+	for (size_t i=0; i<size(); ++i) {
+		workers_[i].cpu = topo_[i];
+		plan_steals(i);
+	}
+
+	for (size_t i=0; i<size(); ++i)
+		workers_[i].thr = std::thread([this, i, pin=opts.pin] { worker_func(i, pin); });
+}
+
+// --------------------------------------------------------------------------
+// The tasks can post more, so we wait for them all before closing the pool
+// to new ones.
+
+stealing_pool::~stealing_pool()
+{
+	wait();
+	{
+		std::lock_guard<std::mutex> g(idleLock_);
+		stop_ = true;
+	}
+	idleCond_.notify_all();
+
+	for (size_t i=0; i<size(); ++i)
+		workers_[i].thr.join();
+}
+
+// --------------------------------------------------------------------------
+// Each level of the victim list starts just past the worker itself, so
+// that the workers in a group don't all pile onto the same victim. The
+// other nodes are ordered the same way.
+
+void stealing_pool::plan_steals(size_t i)
+{
+	auto& w = workers_[i];
+	const auto& me = topo_[i];
+	size_t n = size();
+
+	for (int lvl=0; lvl<3; ++lvl) {
+		for (size_t k=1; k<n; ++k) {
+			size_t j = (i + k) % n;
+			const auto& other = topo_[j];
+
+			int jlvl = (other.node != me.node) ? 2
+				: (other.complex != me.complex) ? 1 : 0;
+
+			if (jlvl == lvl)
+				w.victims.push_back(j);
+		}
+		w.levelEnd[lvl] = w.victims.size();
+	}
+
+	size_t nNode = topo_.num_nodes();
+	for (size_t k=1; k<nNode; ++k)
+		w.remoteNodes.push_back((me.node + k) % nNode);
+}
+
+// --------------------------------------------------------------------------
+// The queued count goes up after the task is in place, and the sleeping
+// count is checked after that, while a worker going to sleep does the
+// opposite. Both are sequentially consistent, so either the worker sees
+// the task, or we see the worker.
+
+void stealing_pool::enqueue(func_wrapper task, size_t node, bool local)
+{
+	if (stop_)
+		throw queue_closed();
+
+	++nPending_;
+
+	if (local) {
+		auto& w = workers_[current().second];
+		std::lock_guard<std::mutex> g(w.lock);
+		w.tasks.push_back(std::move(task));
+		++w.size;
+	}
+	else {
+		try {
+			inject_[node].put(std::move(task));
+		}
+		catch (...) {
+			--nPending_;
+			throw;
+		}
+	}
+
+	++nQueued_;
+	wake();
+}
+
+// --------------------------------------------------------------------------
+
+void stealing_pool::wake()
+{
+	if (nSleeping_ != 0) {
+		{ std::lock_guard<std::mutex> g(idleLock_); }
+		idleCond_.notify_one();
+	}
+}
+
+// --------------------------------------------------------------------------
+
+bool stealing_pool::pop(size_t i, func_wrapper* task)
+{
+	auto& w = workers_[i];
+	if (w.size.load(std::memory_order_relaxed) == 0)
+		return false;
+
+	std::lock_guard<std::mutex> g(w.lock);
+	if (w.tasks.empty())
+		return false;
+
+	*task = std::move(w.tasks.back());
+	w.tasks.pop_back();
+	--w.size;
+	return true;
+}
+
+// --------------------------------------------------------------------------
+
+bool stealing_pool::steal(size_t victim, func_wrapper* task)
+{
+	auto& w = workers_[victim];
+	if (w.size.load(std::memory_order_relaxed) == 0)
+		return false;
+
+	std::lock_guard<std::mutex> g(w.lock);
+	if (w.tasks.empty())
+		return false;
+
+	*task = std::move(w.tasks.front());
+	w.tasks.pop_front();
+	--w.size;
+	return true;
+}
+
+// --------------------------------------------------------------------------
+
+bool stealing_pool::find_task(size_t i, func_wrapper* task)
+{
+	auto& w = workers_[i];
+
+	if (pop(i, task)) {
+		++w.nLocal;
+		return true;
+	}
+
+	if (inject_[w.cpu.node].try_get(task)) {
+		++w.nInjected;
+		return true;
+	}
+
+	size_t lvl = 0;
+	for (size_t k=0; k<w.victims.size(); ++k) {
+		while (k == w.levelEnd[lvl])
+			++lvl;
+		if (steal(w.victims[k], task)) {
+			++w.nSteal[lvl];
+			return true;
+		}
+	}
+
+	for (auto node : w.remoteNodes) {
+		if (inject_[node].try_get(task)) {
+			++w.nSteal[size_t(steal_level::remote)];
+			return true;
+		}
+	}
+	return false;
+}
+
+// --------------------------------------------------------------------------
+
+void stealing_pool::worker_func(size_t i, bool pin)
+{
+	constexpr int N_SPIN = 64;
+
+	current() = { this, i };
+	if (pin)
+		detail::pin_to_cpu(workers_[i].cpu.cpu);
+
+	int nIdle = 0;
+
+	while (true) {
+		func_wrapper task;
+		if (find_task(i, &task)) {
+			--nQueued_;
+			try {
+				task();
+			}
+			catch (...) {}
+			task = func_wrapper();
+			nIdle = 0;
+
+			if (--nPending_ == 0) {
+				{ std::lock_guard<std::mutex> g(idleLock_); }
+				doneCond_.notify_all();
+			}
+			continue;
+		}
+
+		if (nQueued_ > 0) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		if (stop_)
+			break;
+
+		if (++nIdle < N_SPIN) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> g(idleLock_);
+		++nSleeping_;
+		idleCond_.wait(g, [this] { return nQueued_ > 0 || stop_; });
+		--nSleeping_;
+		nIdle = 0;
+	}
+}
+
+// --------------------------------------------------------------------------
+
+void stealing_pool::wait()
+{
+	std::unique_lock<std::mutex> g(idleLock_);
+	doneCond_.wait(g, [this] { return nPending_ == 0; });
+}
+
+// --------------------------------------------------------------------------
+
+uint64_t stealing_pool::num_local() const
+{
+	uint64_t n = 0;
+	for (size_t i=0; i<size(); ++i)
+		n += workers_[i].nLocal;
+	return n;
+}
+
+// --------------------------------------------------------------------------
+
+uint64_t stealing_pool::num_injected() const
+{
+	uint64_t n = 0;
+	for (size_t i=0; i<size(); ++i)
+		n += workers_[i].nInjected;
+	return n;
+}
+
+// --------------------------------------------------------------------------
+
+uint64_t stealing_pool::num_steals(steal_level lvl) const
+{
+	uint64_t n = 0;
+	for (size_t i=0; i<size(); ++i)
+		n += workers_[i].nSteal[size_t(lvl)];
+	return n;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
+
+#endif
@@ -0,0 +1,300 @@
+// task_graph.cpp
+//
+// This file is part of the cooper project.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+
+#include "cooper/task_graph.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+task_graph::~task_graph()
+{
+	try {
+		if (running())
+			wait();
+	}
+	catch (...) {}
+}
+
+// --------------------------------------------------------------------------
+
+void task_graph::check(node_id id) const
+{
+	if (id >= nodes_.size())
+		throw std::out_of_range("task_graph: no such node");
+}
+
+// --------------------------------------------------------------------------
+
+void task_graph::check_idle()
+{
+	if (running())
+		throw std::logic_error("task_graph: graph is running");
+}
+
+// --------------------------------------------------------------------------
+
+task_graph::node_id task_graph::add(std::function<void()> f,
+									const node_id* first, const node_id* last)
+{
+	check_idle();
+	for (auto p = first; p != last; ++p)
+		check(*p);
+
+	node_id id = nodes_.size();
+	auto& nd = nodes_.emplace_back(std::move(f));
+
+	for (auto p = first; p != last; ++p) {
+		auto& succ = nodes_[*p].succ;
+		// Ignore duplicates, so the pending count is right
+		if (succ.empty() || succ.back() != id) {
+			succ.push_back(id);
+			++nd.nDep;
+		}
+	}
+
+	if (nd.nDep == 0)
+		roots_.push_back(id);
+	return id;
+}
+
+// --------------------------------------------------------------------------
+
+task_graph& task_graph::run_on(node_id id, size_t thrIdx)
+{
+	check_idle();
+	check(id);
+	nodes_[id].thrIdx = thrIdx;
+	return *this;
+}
+
+// --------------------------------------------------------------------------
+
+task_graph& task_graph::run_near(node_id id, node_id dep)
+{
+	check_idle();
+	check(id);
+	check(dep);
+
+	const auto& succ = nodes_[dep].succ;
+	if (std::find(succ.begin(), succ.end(), id) == succ.end())
+		throw std::invalid_argument("task_graph: not a dependency");
+
+	nodes_[id].near = dep;
+	return *this;
+}
+
+// --------------------------------------------------------------------------
+
+size_t task_graph::ran_on(node_id id) const
+{
+	check(id);
+	return nodes_[id].ranOn;
+}
+
+// --------------------------------------------------------------------------
+
+bool task_graph::running()
+{
+	guard g(lock_);
+	return running_;
+}
+
+// --------------------------------------------------------------------------
+
+void task_graph::start(work_threads& thrs)
+{
+	{
+		guard g(lock_);
+		if (running_)
+			throw std::logic_error("task_graph: graph is running");
+		if (nodes_.empty())
+			return;
+		running_ = true;
+		err_ = nullptr;
+	}
+
+	thrs_ = &thrs;
+	failed_ = false;
+	nRemaining_ = nodes_.size();
+
+	for (auto& nd : nodes_) {
+		nd.nPending = nd.nDep;
+		nd.ranOn = npos;
+	}
+
+	for (auto id : roots_)
+		schedule(id, npos);
+}
+
+// --------------------------------------------------------------------------
+
+void task_graph::wait()
+{
+#if defined(COOPER_SINGLE_THREADED)
+	event_loop::instance().wait([this] { return !running_; });
+#endif
+	unique_guard g(lock_);
+	doneCond_.wait(g, [this] { return !running_; });
+	if (err_)
+		std::rethrow_exception(err_);
+}
+
+// --------------------------------------------------------------------------
+
+void task_graph::fail(std::exception_ptr err)
+{
+	guard g(lock_);
+	if (!err_)
+		err_ = err;
+	failed_ = true;
+}
+
+// --------------------------------------------------------------------------
+
+task_graph::completion*& task_graph::current_completion()
+{
+	static thread_local completion* comp = nullptr;
+	return comp;
+}
+
+// --------------------------------------------------------------------------
+// The node is posted with a guard that completes it if it's dropped. If the
+// post fails, the guard is destroyed right here, and does the same.
+
+void task_graph::schedule(node_id id, size_t prodIdx)
+{
+	const auto& nd = nodes_[id];
+	size_t n = thrs_->size();
+
+	size_t idx;
+	if (nd.thrIdx != npos)
+		idx = nd.thrIdx % n;
+	else if (nd.near != npos)
+		idx = nodes_[nd.near].ranOn;
+	else if (prodIdx != npos)
+		idx = prodIdx;
+	else
+		idx = thrs_->next_thread_idx();
+
+	try {
+		(*thrs_)[idx].post([ng=node_guard(this, id, idx)]() mutable {
+			auto graph = ng.graph;
+			ng.graph = nullptr;
+			graph->run_node(ng.id, ng.thrIdx);
+		});
+	}
+	catch (...) {
+		// The guard already completed the node
+	}
+}
+
+// --------------------------------------------------------------------------
+
+void task_graph::run_node(node_id id, size_t thrIdx)
+{
+	auto& nd = nodes_[id];
+	nd.ranOn = thrIdx;
+
+	if (!failed_) {
+		try {
+			nd.func();
+		}
+		catch (...) {
+			fail(std::current_exception());
+		}
+	}
+	complete(id, thrIdx);
+}
+
+// --------------------------------------------------------------------------
+
+void task_graph::drop(node_id id, size_t thrIdx)
+{
+	nodes_[id].ranOn = thrIdx;
+	fail(std::make_exception_ptr(queue_closed()));
+	complete(id, thrIdx);
+}
+
+// --------------------------------------------------------------------------
+// If this thread is already completing nodes for the graph, the node is
+// just added to its list. The completion is signaled under the lock, so the
+// waiter can't return, and possibly destroy the graph, until this is done
+// with it.
+
+void task_graph::complete(node_id id, size_t thrIdx)
+{
+	auto& cur = current_completion();
+	if (cur && cur->graph == this) {
+		cur->nodes.emplace_back(id, thrIdx);
+		return;
+	}
+
+	completion comp{this, {{id, thrIdx}}};
+	auto prev = cur;
+	cur = &comp;
+
+	while (!comp.nodes.empty()) {
+		auto [nid, idx] = comp.nodes.back();
+		comp.nodes.pop_back();
+
+		for (auto succ : nodes_[nid].succ) {
+			if (--nodes_[succ].nPending == 0)
+				schedule(succ, idx);
+		}
+
+		if (--nRemaining_ == 0) {
+			cur = prev;
+			guard g(lock_);
+			running_ = false;
+			doneCond_.notify_all();
+			return;
+		}
+	}
+	cur = prev;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
@@ -47,6 +47,8 @@ namespace cooper {
 
 /////////////////////////////////////////////////////////////////////////////
 
+#if !defined(COOPER_SINGLE_THREADED)
+
 void timer::thread_func()
 {
 	unique_guard g(lock_);
@@ -101,6 +103,68 @@ void timer::start(const nanoseconds& initTime,
 	thr_ = thread(&timer::thread_func, this);
 }
 
+#else
+
+// In the single-threaded build, a running timer is registered with the
+// event loop, which calls fire() when it expires. The expiry times follow
+// the same rules as the timer thread.
+
+void timer::stop()
+{
+	if (!running_)
+		return;
+
+	running_ = false;
+	event_loop::instance().remove(this);
+}
+
+// --------------------------------------------------------------------------
+
+void timer::start(const nanoseconds& initTime,
+				  const nanoseconds& interval)
+{
+	// Cancel a running timer
+	stop();
+
+	initTime_ = initTime;
+	interval_ = interval;
+
+	auto first = initTime_;
+	if (first.count() == 0 || first == interval_) {
+		if (interval_.count() == 0)
+			return;
+		first = interval_;
+	}
+
+	expiry_ = steady_clock::now() + first;
+	running_ = true;
+	event_loop::instance().add(this);
+}
+
+// --------------------------------------------------------------------------
+// The next expiry is set before running the callback, so that it can stop
+// or restart the timer.
+
+void timer::fire()
+{
+	if (interval_.count() == 0)
+		stop();
+	else
+		expiry_ = std::max(expiry_+interval_, steady_clock::now());
+
+	firing_ = true;
+	try {
+		func_();
+	}
+	catch (...) {
+		firing_ = false;
+		throw;
+	}
+	firing_ = false;
+}
+
+#endif
+
 
 /////////////////////////////////////////////////////////////////////////////
 // end namespace 'cooper'
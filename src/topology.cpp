@@ -0,0 +1,176 @@
+// topology.cpp
+//
+// This file is part of the cooper project.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+
+#include "cooper/topology.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <map>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace cooper {
+
+/////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+#if defined(__linux__)
+
+// Gets the NUMA node of a CPU from the 'nodeN' link in its sysfs directory.
+
+bool read_node(const fs::path& dir, size_t* node)
+{
+	std::error_code ec;
+	for (const auto& ent : fs::directory_iterator(dir, ec)) {
+		auto name = ent.path().filename().string();
+		if (name.size() > 4 && name.compare(0, 4, "node") == 0) {
+			try {
+				*node = std::stoul(name.substr(4));
+				return true;
+			}
+			catch (...) {}
+		}
+	}
+	return false;
+}
+
+// Gets the list of CPUs that share the last-level cache with a CPU. The
+// list is just used as a name for the complex.
+
+bool read_llc(const fs::path& dir, std::string* cpus)
+{
+	for (const char* idx : { "index3", "index2" }) {
+		std::ifstream is(dir / "cache" / idx / "shared_cpu_list");
+		if (is && std::getline(is, *cpus) && !cpus->empty())
+			return true;
+	}
+	return false;
+}
+
+#endif
+
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// cpu_topology
+
+void cpu_topology::add(int cpu, size_t node, size_t complex)
+{
+	cpus_.push_back(cpu_info{ cpu, node, complex });
+	nNode_ = std::max(nNode_, node+1);
+}
+
+// --------------------------------------------------------------------------
+
+cpu_topology cpu_topology::uniform(size_t nNode, size_t nComplex, size_t nCpu)
+{
+	cpu_topology topo;
+	int cpu = 0;
+	for (size_t node=0; node<nNode; ++node) {
+		for (size_t cx=0; cx<nComplex; ++cx) {
+			for (size_t i=0; i<nCpu; ++i)
+				topo.add(cpu++, node, node*nComplex + cx);
+		}
+	}
+	return topo;
+}
+
+// --------------------------------------------------------------------------
+// Complexes are named by their list of CPUs, then numbered in the order
+// that they're found.
+
+cpu_topology cpu_topology::detect()
+{
+	auto n = std::max(1u, std::thread::hardware_concurrency());
+
+#if defined(__linux__)
+	cpu_topology topo;
+	std::map<std::string, size_t> complexes;
+
+	for (unsigned i=0; i<n; ++i) {
+		fs::path dir = "/sys/devices/system/cpu/cpu" + std::to_string(i);
+
+		size_t node = 0;
+		read_node(dir, &node);
+
+		std::string llc;
+		if (!read_llc(dir, &llc))
+			llc = "node" + std::to_string(node);
+
+		auto p = complexes.emplace(llc, complexes.size()).first;
+		topo.add(int(i), node, p->second);
+	}
+	return topo;
+#else
+	return uniform(1, 1, n);
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+void pin_to_cpu(int cpu)
+{
+#if defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+	(void) cpu;
+#endif
+}
+
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// end namespace 'cooper'
+}
@@ -39,40 +39,391 @@
  ***************************************************************************/
 
 #include "cooper/work_thread.h"
+#include "cooper/core_threads.h"
+#include <vector>
 
 namespace cooper {
 
 /////////////////////////////////////////////////////////////////////////////
 
-// The constructor sets the quit flag to false before starting up the
-// internal thread.
+namespace {
 
-work_thread::work_thread() : quit_(false)
+// Touches (at least) the specified number of bytes of the stack of the
+// calling thread, a page at a time. The access after the recursive call
+// prevents it from being turned into a loop.
+
+void touch_stack(size_t n)
+{
+	volatile char page[4096];
+	page[0] = 0;
+	if (n > sizeof(page))
+		touch_stack(n - sizeof(page));
+	page[sizeof(page)-1] = page[0];
+}
+
+// Allocates and then frees the specified number of blocks, in the range
+// of sizes used for task closures and promise states, to get the memory
+// into the allocator's caches for the calling thread.
+
+void prime_allocator(size_t n)
+{
+	static constexpr size_t SIZES[] = { 32, 64, 128, 256 };
+	constexpr size_t N_SIZES = sizeof(SIZES) / sizeof(SIZES[0]);
+
+	std::vector<void*> blocks;
+	blocks.reserve(n);
+
+	for (size_t i=0; i<n; ++i)
+		blocks.push_back(::operator new(SIZES[i % N_SIZES]));
+
+	for (auto p : blocks)
+		::operator delete(p);
+}
+
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+#if !defined(COOPER_SINGLE_THREADED)
+
+// The constructor initializes the state before starting up the internal
+// thread. The thread runs inside a packaged task so that its future can
+// tell when it's done.
+
+work_thread::work_thread()
+	: nSubmitted_(0), nCompleted_(0), finished_(false), mesh_(nullptr), meshIdx_(0)
+{
+	std::packaged_task<void()> task([this]{ thread_func(); });
+	done_ = task.get_future();
+	thr_ = std::thread(std::move(task));
+}
+
+// --------------------------------------------------------------------------
+
+work_thread::~work_thread()
+{
+	shutdown();
+}
+
+#else
+
+// In the single-threaded build, the thread is just a queue that the
+// event loop runs.
+
+work_thread::work_thread()
+	: nSubmitted_(0), nCompleted_(0), running_(false), finished_(false)
 {
-	thr_ = std::thread(&work_thread::thread_func, this);
+	event_loop::instance().add(this);
 }
 
 // --------------------------------------------------------------------------
 
 work_thread::~work_thread()
 {
-	quit();
-	if (thr_.joinable())
-		thr_.join();
+	shutdown();
+	event_loop::instance().remove(this);
+}
+
+#endif
+
+// --------------------------------------------------------------------------
+
+std::future<void> work_thread::warm_up(const warm_up_options& opts)
+{
+	if (opts.queue_capacity != 0)
+		que_.reserve(opts.queue_capacity);
+
+	return submit([opts] {
+		if (opts.stack_size != 0)
+			touch_stack(opts.stack_size);
+		if (opts.num_allocs != 0)
+			prime_allocator(opts.num_allocs);
+	});
+}
+
+// --------------------------------------------------------------------------
+// The arena is only touched in the thread's context, so it's created there.
+
+std::future<void> work_thread::use_arena(size_t blockSize /*=arena::DFLT_BLOCK_SIZE*/)
+{
+	return submit([this, blockSize] {
+		if (!arena_)
+			arena_ = std::make_unique<arena>(blockSize);
+	});
+}
+
+// --------------------------------------------------------------------------
+// Closing is done under the final lock so that finalize() can't put a task
+// into the queue after the thread decided it was done.
+
+void work_thread::close()
+{
+	std::lock_guard<sync::mutex> g(finLock_);
+#if !defined(COOPER_SINGLE_THREADED)
+	if (auto mesh = mesh_.load(std::memory_order_acquire))
+		mesh->close(meshIdx_);
+#endif
+	que_.close();
+#if !defined(COOPER_SINGLE_THREADED)
+	if (auto mesh = mesh_.load(std::memory_order_acquire))
+		mesh->wake(meshIdx_);
+#endif
+}
+
+// --------------------------------------------------------------------------
+// The discarded tasks count as completed, to keep the quiescence counters
+// in balance.
+
+work_thread::size_type work_thread::discard()
+{
+	auto n = que_.clear();
+	nCompleted_ += n;
+	return n;
+}
+
+// --------------------------------------------------------------------------
+
+void work_thread::shutdown(shutdown_mode mode /*=shutdown_mode::drain*/)
+{
+	close();
+	if (mode == shutdown_mode::discard)
+		discard();
+	join();
+}
+
+// --------------------------------------------------------------------------
+
+bool work_thread::shutdown_until(const std::chrono::steady_clock::time_point& absTime)
+{
+	close();
+	bool drained = wait_until_done(absTime);
+	if (!drained)
+		drained = (discard() == 0);
+	join();
+	return drained;
 }
 
 // --------------------------------------------------------------------------
+
+#if !defined(COOPER_SINGLE_THREADED)
+
 // The thread function. This runs in the context of the internal thread to
-// process the queued tasks.
+// process the queued tasks. If the thread is joined to a mesh, it switches
+// over to polling the mesh after the task that woke it.
 
 void work_thread::thread_func()
 {
-	while (!(quit_ && que_.empty())) {
+	current() = this;
+
+	while (!mesh_.load(std::memory_order_acquire)) {
+		func_wrapper task;
 		try {
-			que_.get()();
+			task = que_.get();
+		}
+		catch (const queue_closed&) {
+			break;
 		}
-		catch (...) {}
+
+		run_task(task);
 	}
+
+	if (auto mesh = mesh_.load(std::memory_order_acquire))
+		mesh->run(meshIdx_);
+
+	run_finals();
+}
+
+#else
+
+// Runs one task for the event loop. A thread that is already running a
+// task, further up the stack, is skipped, so that its tasks still run one
+// at a time.
+
+bool work_thread::run_one()
+{
+	if (running_ || finished_)
+		return false;
+
+	func_wrapper task;
+	if (!que_.try_get(&task)) {
+		if (!que_.closed())
+			return false;
+		running_ = true;
+		run_finals();
+		running_ = false;
+		return true;
+	}
+
+	running_ = true;
+	run_task(task);
+	running_ = false;
+	return true;
+}
+
+#endif
+
+// --------------------------------------------------------------------------
+// The queue is closed and drained. Run any final tasks that came in after
+// it was closed, which might, in turn, queue up more.
+
+void work_thread::run_finals()
+{
+	while (true) {
+		unique_guard g(finLock_);
+		if (finals_.empty()) {
+			finished_ = true;
+			break;
+		}
+		auto finals = std::move(finals_);
+		finals_.clear();
+		g.unlock();
+
+		for (auto& task : finals)
+			run_task(task);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// work_threads
+
+void work_threads::flush()
+{
+	std::vector<std::future<void>> futs;
+	futs.reserve(thrs_.size());
+
+	for (auto& thr : thrs_)
+		futs.push_back(thr.submit([]{}));
+
+	for (auto& fut : futs)
+		detail::get_result(std::move(fut));
+}
+
+// --------------------------------------------------------------------------
+
+void work_threads::warm_up(const warm_up_options& opts)
+{
+	std::vector<std::future<void>> futs;
+	futs.reserve(thrs_.size());
+
+	for (auto& thr : thrs_)
+		futs.push_back(thr.warm_up(opts));
+
+	for (auto& fut : futs)
+		detail::get_result(std::move(fut));
+}
+
+// --------------------------------------------------------------------------
+
+void work_threads::use_arena(size_t blockSize /*=arena::DFLT_BLOCK_SIZE*/)
+{
+	std::vector<std::future<void>> futs;
+	futs.reserve(thrs_.size());
+
+	for (auto& thr : thrs_)
+		futs.push_back(thr.use_arena(blockSize));
+
+	for (auto& fut : futs)
+		detail::get_result(std::move(fut));
+}
+
+// --------------------------------------------------------------------------
+// Note that the completed counters must all be read before any of the
+// submitted ones.
+
+bool work_threads::quiescent() const
+{
+	uint64_t nCompleted = 0, nSubmitted = 0;
+
+	for (const auto& thr : thrs_)
+		nCompleted += thr.num_completed();
+
+	for (const auto& thr : thrs_)
+		nSubmitted += thr.num_submitted();
+
+	return nCompleted == nSubmitted;
+}
+
+// --------------------------------------------------------------------------
+
+void work_threads::wait_quiescent()
+{
+	try_wait_quiescent_until(std::chrono::steady_clock::time_point::max());
+}
+
+// --------------------------------------------------------------------------
+// There's no signal for the collection going quiet, so this polls, backing
+// off from a few quick yields up to a 1ms sleep between checks. In the
+// single-threaded build, it just runs the loop until it goes quiet.
+
+bool work_threads::try_wait_quiescent_until(const std::chrono::steady_clock::time_point& absTime)
+{
+#if defined(COOPER_SINGLE_THREADED)
+	return event_loop::instance().run_until([this] { return quiescent(); }, absTime);
+#else
+	using namespace std::chrono;
+
+	constexpr int N_SPIN = 16;
+	constexpr auto MAX_SLEEP = microseconds(1000);
+
+	auto slp = microseconds(10);
+
+	for (int i=0; !quiescent(); ++i) {
+		auto now = steady_clock::now();
+		if (now >= absTime)
+			return false;
+
+		if (i < N_SPIN)
+			std::this_thread::yield();
+		else {
+			std::this_thread::sleep_for(std::min<steady_clock::duration>(slp, absTime-now));
+			slp = std::min(2*slp, MAX_SLEEP);
+		}
+	}
+	return true;
+#endif
+}
+
+// --------------------------------------------------------------------------
+
+void work_threads::close()
+{
+	for (auto& thr : thrs_)
+		thr.close();
+}
+
+// --------------------------------------------------------------------------
+
+void work_threads::shutdown(shutdown_mode mode /*=shutdown_mode::drain*/)
+{
+	close();
+
+	if (mode == shutdown_mode::discard) {
+		for (auto& thr : thrs_)
+			thr.discard();
+	}
+
+	for (auto& thr : thrs_)
+		thr.join();
+}
+
+// --------------------------------------------------------------------------
+// All the threads are closed together, so they all drain in parallel up to
+// the same deadline.
+
+bool work_threads::shutdown_until(const std::chrono::steady_clock::time_point& absTime)
+{
+	close();
+
+	bool drained = true;
+	for (auto& thr : thrs_) {
+		if (!thr.wait_until_done(absTime) && thr.discard() != 0)
+			drained = false;
+	}
+
+	for (auto& thr : thrs_)
+		thr.join();
+
+	return drained;
 }
 
 /////////////////////////////////////////////////////////////////////////////
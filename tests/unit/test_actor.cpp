@@ -0,0 +1,144 @@
+// test_actor.cpp
+//
+// Test of the actor class in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#include "cooper/actor.h"
+#include "catch2_version.h"
+#include <future>
+#include <vector>
+
+using namespace std::chrono;
+using namespace cooper;
+
+// An actor that reports the thread that it was destroyed on, and the
+// number of messages that it processed before that.
+class dtor_actor : public this_actor<dtor_actor>
+{
+	int n_ = 0;
+	std::promise<std::pair<std::thread::id, int>>& done_;
+
+public:
+	dtor_actor(std::promise<std::pair<std::thread::id, int>>& done)
+		: done_(done) {}
+	~dtor_actor() {
+		done_.set_value({ std::this_thread::get_id(), n_ });
+	}
+
+	void slow_inc() {
+		cast([this] {
+			std::this_thread::sleep_for(1ms);
+			++n_;
+		});
+	}
+
+	std::thread::id thread_id() {
+		return call([]{ return std::this_thread::get_id(); });
+	}
+};
+
+TEST_CASE("actor deferred delete", "[actor]") {
+	constexpr int N = 10;
+
+	SECTION("unique") {
+		std::promise<std::pair<std::thread::id, int>> done;
+		auto fut = done.get_future();
+
+		auto act = make_actor<dtor_actor>(done);
+		auto id = act->thread_id();
+
+		for (int i=0; i<N; ++i)
+			act->slow_inc();
+		act.reset();
+
+		auto [dtor_id, n] = fut.get();
+		REQUIRE(dtor_id == id);
+		REQUIRE(n == N);
+	}
+
+	SECTION("shared") {
+		std::promise<std::pair<std::thread::id, int>> done;
+		auto fut = done.get_future();
+
+		auto act = make_shared_actor<dtor_actor>(done);
+		auto act2 = act;
+		auto id = act->thread_id();
+
+		for (int i=0; i<N; ++i)
+			act->slow_inc();
+		act.reset();
+		REQUIRE(fut.wait_for(0ms) == std::future_status::timeout);
+		act2.reset();
+
+		auto [dtor_id, n] = fut.get();
+		REQUIRE(dtor_id == id);
+		REQUIRE(n == N);
+	}
+}
+
+// An actor that can report the ID of its thread.
+class id_actor : public this_actor<id_actor>
+{
+public:
+	id_actor() {}
+	id_actor(work_thread& thr) : this_actor(thr) {}
+
+	std::thread::id thread_id() {
+		return call([]{ return std::this_thread::get_id(); });
+	}
+};
+
+TEST_CASE("actor placement", "[actor]") {
+	work_thread thr;
+	auto id = thr.call([]{ return std::this_thread::get_id(); });
+
+	SECTION("explicit") {
+		id_actor act(thr);
+		REQUIRE(act.thread_id() == id);
+	}
+
+	SECTION("scoped") {
+		placement plc(thr);
+		id_actor act1, act2;
+		REQUIRE(act1.thread_id() == id);
+		REQUIRE(act2.thread_id() == id);
+	}
+}
@@ -0,0 +1,93 @@
+// test_actor_pool.cpp
+//
+// Test of the actor_pool class in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#include "cooper/actor_pool.h"
+#include "catch2_version.h"
+
+using namespace cooper;
+
+// A simple per-session actor that counts requests.
+class session : public actor
+{
+	int n_ = 0;
+
+public:
+	void inc() { cast([this] { ++n_; }); }
+	int count() { return call([this] { return n_; }); }
+	void reset() { n_ = 0; }
+};
+
+TEST_CASE("actor_pool recycling", "[actor_pool]") {
+	work_threads thrs(2);
+	actor_pool<session> pool(thrs, 16);
+
+	SECTION("acquire new") {
+		auto s = pool.acquire();
+		s->inc();
+		s->inc();
+		REQUIRE(s->count() == 2);
+		REQUIRE(pool.num_created() == 1);
+		REQUIRE(pool.num_recycled() == 0);
+	}
+
+	SECTION("recycle") {
+		for (int i=0; i<10; ++i) {
+			auto s = pool.acquire();
+			REQUIRE(s->count() == 0);
+			s->inc();
+			s.reset();
+			thrs.wait_quiescent();
+		}
+		REQUIRE(pool.num_created() + pool.num_recycled() == 10);
+		REQUIRE(pool.num_created() <= 2);
+	}
+
+	SECTION("reserve") {
+		pool.reserve(4);
+		REQUIRE(pool.num_created() == 8);
+
+		auto s = pool.acquire();
+		REQUIRE(pool.num_recycled() == 1);
+		REQUIRE(pool.num_created() == 8);
+	}
+}
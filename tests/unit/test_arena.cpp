@@ -0,0 +1,165 @@
+// test_arena.cpp
+//
+// Unit tests for the cooper 'arena' class.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/arena.h"
+#include "cooper/actor.h"
+#include "catch2_version.h"
+#include <memory_resource>
+#include <vector>
+#include <string>
+
+using namespace cooper;
+
+TEST_CASE("arena allocation", "[arena]") {
+	constexpr size_t BLOCK_SIZE = 1024;
+	arena a(BLOCK_SIZE);
+
+	REQUIRE(a.block_size() == BLOCK_SIZE);
+	REQUIRE(a.num_blocks() == 0);
+	REQUIRE(a.used() == 0);
+
+	SECTION("alignment") {
+		REQUIRE(a.allocate(1, 1) != nullptr);
+		auto p = a.allocate(8, 8);
+		REQUIRE(reinterpret_cast<uintptr_t>(p) % 8 == 0);
+		p = a.allocate(16, 64);
+		REQUIRE(reinterpret_cast<uintptr_t>(p) % 64 == 0);
+		REQUIRE(a.num_blocks() == 1);
+	}
+
+	SECTION("reset reuses the blocks") {
+		for (int i=0; i<100; ++i)
+			REQUIRE(a.allocate(100) != nullptr);
+		auto nBlk = a.num_blocks();
+		REQUIRE(nBlk > 1);
+
+		a.reset();
+		REQUIRE(a.used() == 0);
+
+		for (int i=0; i<100; ++i)
+			REQUIRE(a.allocate(100) != nullptr);
+		REQUIRE(a.num_blocks() == nBlk);
+
+		a.release();
+		REQUIRE(a.num_blocks() == 0);
+	}
+
+	SECTION("large allocations") {
+		auto p = a.allocate(4*BLOCK_SIZE, 16);
+		REQUIRE(p != nullptr);
+		REQUIRE(reinterpret_cast<uintptr_t>(p) % 16 == 0);
+		REQUIRE(a.num_blocks() == 0);
+		REQUIRE(a.used() == 4*BLOCK_SIZE);
+		a.reset();
+		REQUIRE(a.used() == 0);
+	}
+
+	SECTION("pmr containers") {
+		std::pmr::vector<std::pmr::string> v{&a};
+		for (int i=0; i<50; ++i)
+			v.emplace_back("a string that is too long for small buffers");
+		REQUIRE(v.size() == 50);
+		REQUIRE(v.back() == "a string that is too long for small buffers");
+		REQUIRE(a.used() > 50*40);
+	}
+}
+
+TEST_CASE("work_thread arena", "[arena]") {
+	work_thread thr;
+
+	REQUIRE(detail::get_result(thr.submit([] { return arena::current(); })) == nullptr);
+
+	detail::get_result(thr.use_arena(4096));
+
+	// The arena is current in each task, and reset after each one.
+	auto used = [] {
+		auto a = arena::current();
+		if (!a)
+			return size_t(-1);
+		size_t n = a->used();
+		std::pmr::vector<int> v{a};
+		v.resize(100);
+		return n;
+	};
+
+	REQUIRE(detail::get_result(thr.submit(used)) == 0);
+	REQUIRE(detail::get_result(thr.submit(used)) == 0);
+
+	REQUIRE(arena::current() == nullptr);
+}
+
+// An actor that tokenizes its messages into the arena
+class tokenizer : public actor
+{
+	size_t handle_count(const std::string& s) {
+		std::pmr::vector<std::pmr::string> toks{message_arena()};
+		size_t i = 0;
+		while (i < s.size()) {
+			auto j = s.find(' ', i);
+			if (j == std::string::npos)
+				j = s.size();
+			toks.emplace_back(s.substr(i, j-i));
+			i = j + 1;
+		}
+		return toks.size();
+	}
+
+public:
+	using actor::actor;
+
+	size_t count(const std::string& s) {
+		return call(&tokenizer::handle_count, this, s);
+	}
+	bool has_arena() {
+		return call([this] { return message_arena() != nullptr; });
+	}
+};
+
+TEST_CASE("actor message arena", "[arena]") {
+	work_thread thr;
+	detail::get_result(thr.use_arena());
+
+	tokenizer tok(thr);
+	REQUIRE(tok.has_arena());
+	REQUIRE(tok.count("one two three four") == 4);
+	REQUIRE(tok.count("five") == 1);
+}
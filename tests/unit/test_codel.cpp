@@ -0,0 +1,167 @@
+// test_codel.cpp
+//
+// Test of the CoDel load shedding in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/codel.h"
+#include "catch2_version.h"
+
+using namespace std::chrono;
+using namespace cooper;
+
+TEST_CASE("codel state", "[codel]") {
+	codel_options opts;
+	opts.target = 5ms;
+	opts.interval = 100ms;
+
+	codel cd(opts);
+	auto t = codel::clock::now();
+
+	// Short delays are fine
+	for (int i=0; i<100; ++i, t+=1ms)
+		REQUIRE(!cd.on_dequeue(t - 1ms, t));
+	REQUIRE(!cd.overloaded());
+
+	// A burst above target, shorter than the interval
+	for (int i=0; i<50; ++i, t+=1ms)
+		REQUIRE(!cd.on_dequeue(t - 20ms, t));
+	REQUIRE(!cd.on_dequeue(t - 1ms, t));
+	REQUIRE(!cd.overloaded());
+
+	// A standing delay for more than an interval
+	int nShed = 0;
+	for (int i=0; i<300; ++i, t+=1ms)
+		if (cd.on_dequeue(t - 20ms, t)) ++nShed;
+
+	REQUIRE(cd.overloaded());
+	// One at 100ms, then at intervals shrinking by sqrt(n)
+	REQUIRE(nShed >= 3);
+	REQUIRE(nShed < 10);
+
+	// Recovers as soon as the delay drops
+	REQUIRE(!cd.on_dequeue(t - 1ms, t));
+	REQUIRE(!cd.overloaded());
+}
+
+TEST_CASE("codel unsheddable tasks", "[codel]") {
+	codel_options opts;
+	opts.target = 5ms;
+	opts.interval = 100ms;
+
+	// The same delays, but one also gets a task that can't be shed in
+	// between each of the others.
+	codel a(opts), b(opts);
+	auto t = codel::clock::now();
+
+	int nShedA = 0, nShedB = 0;
+	for (int i=0; i<300; ++i, t+=2ms) {
+		if (a.on_dequeue(t - 20ms, t)) ++nShedA;
+
+		b.on_dequeue_unsheddable(t - 20ms, t - 1ms);
+		if (b.on_dequeue(t - 20ms, t)) ++nShedB;
+	}
+
+	REQUIRE(a.overloaded());
+	REQUIRE(b.overloaded());
+	REQUIRE(nShedA >= 3);
+
+	// The unsheddable tasks don't use up the sheds
+	REQUIRE(nShedB >= nShedA);
+	REQUIRE(nShedB <= nShedA + 1);
+}
+
+// --------------------------------------------------------------------------
+
+// An actor with a slow handler
+class slow_actor : public codel_actor
+{
+	size_t n_ = 0;
+
+public:
+	slow_actor(work_thread& thr, const codel_options& opts)
+		: codel_actor(thr, opts) {}
+
+	bool work() {
+		return cast([this] {
+			std::this_thread::sleep_for(1ms);
+			++n_;
+		});
+	}
+
+	void important() { cast_critical([this] { ++n_; }); }
+
+	size_t count() { return call([this] { return n_; }); }
+};
+
+TEST_CASE("codel actor", "[codel]") {
+	work_thread thr;
+
+	codel_options opts;
+	opts.target = 2ms;
+	opts.interval = 20ms;
+
+	slow_actor act(thr, opts);
+
+	// Flood it with far more than it can handle
+	constexpr size_t N = 500;
+	size_t nSent = 0;
+	for (size_t i=0; i<N; ++i) {
+		if (act.work()) ++nSent;
+		if (i % 10 == 0)
+			std::this_thread::sleep_for(1ms);
+	}
+	act.important();
+
+	REQUIRE(act.num_rejected() > 0);
+	REQUIRE(nSent + act.num_rejected() == N);
+
+	// Everything that wasn't shed, plus the critical message, ran
+	auto n = act.count();
+	REQUIRE(n + act.num_shed() == nSent + 1);
+
+	// The queue is drained, so the delay recovers
+	std::this_thread::sleep_for(50ms);
+	for (int i=0; i<5; ++i) {
+		act.work();
+		act.count();
+	}
+	REQUIRE(!act.overloaded());
+	REQUIRE(act.work());
+}
@@ -0,0 +1,223 @@
+// test_cohort.cpp
+//
+// Test of the cohort class in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/cohort.h"
+#include "catch2_version.h"
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+using namespace cooper;
+
+// A cohort of counters
+class counters : public cohort<int64_t>
+{
+	std::vector<int64_t> count_;
+	size_t nBatch_ = 0;
+
+protected:
+	void on_batch(const member_id* ids, const int64_t* msgs, size_t n) override {
+		auto count = count_.data();
+		for (size_t i=0; i<n; ++i) {
+			if (msgs[i] < 0)
+				throw std::invalid_argument("negative count");
+			count[ids[i]] += msgs[i];
+		}
+		++nBatch_;
+	}
+
+public:
+	counters(work_thread& thr, size_t n) : cohort(thr, n), count_(n, 0) {}
+
+	void add(member_id id, int64_t val) { send(id, val); }
+
+	int64_t count(member_id id) {
+		return call([this, id] { return count_[id]; });
+	}
+
+	size_t num_batches() {
+		return call([this] { return nBatch_; });
+	}
+};
+
+// A cohort whose members check that their messages arrive in order, and
+// that no batch has two messages for the same member.
+class sequencers : public cohort<uint32_t>
+{
+	std::vector<uint32_t> last_;
+	std::vector<bool> inBatch_;
+	bool ok_ = true;
+
+protected:
+	void on_batch(const member_id* ids, const uint32_t* msgs, size_t n) override {
+		for (size_t i=0; i<n; ++i) {
+			if (inBatch_[ids[i]] || msgs[i] != last_[ids[i]] + 1)
+				ok_ = false;
+			inBatch_[ids[i]] = true;
+			last_[ids[i]] = msgs[i];
+		}
+		for (size_t i=0; i<n; ++i)
+			inBatch_[ids[i]] = false;
+	}
+
+public:
+	sequencers(work_thread& thr, size_t n)
+		: cohort(thr, n), last_(n, 0), inBatch_(n, false) {}
+
+	void next(member_id id, uint32_t seq) { send(id, seq); }
+
+	bool ok() { return call([this] { return ok_; }); }
+
+	uint32_t last(member_id id) {
+		return call([this, id] { return last_[id]; });
+	}
+};
+
+// --------------------------------------------------------------------------
+
+TEST_CASE("cohort counters", "[cohort]") {
+	constexpr size_t N = 1000;
+	work_thread thr;
+	counters cnt(thr, N);
+
+	REQUIRE(cnt.size() == N);
+
+	for (int i=0; i<10; ++i)
+		for (size_t j=0; j<N; ++j)
+			cnt.add(cohort<int64_t>::member_id(j), int64_t(j));
+
+	for (size_t j=0; j<N; ++j)
+		REQUIRE(cnt.count(cohort<int64_t>::member_id(j)) == int64_t(10*j));
+}
+
+TEST_CASE("cohort batches", "[cohort]") {
+	work_thread thr;
+	counters cnt(thr, 4);
+
+	// Block the thread so that all the messages land in one drain
+	std::promise<void> go;
+	auto fut = go.get_future().share();
+	thr.cast([fut] { fut.wait(); });
+
+	cnt.add(0, 1);
+	cnt.add(1, 1);
+	cnt.add(0, 1);
+	cnt.add(2, 1);
+	cnt.add(0, 1);
+
+	go.set_value();
+
+	// Member 0 had three messages, so three batches
+	REQUIRE(cnt.num_batches() == 3);
+	REQUIRE(cnt.count(0) == 3);
+	REQUIRE(cnt.count(1) == 1);
+	REQUIRE(cnt.count(2) == 1);
+	REQUIRE(cnt.count(3) == 0);
+}
+
+TEST_CASE("cohort handler throws", "[cohort]") {
+	work_thread thr;
+	counters cnt(thr, 4);
+
+	std::promise<void> go;
+	auto fut = go.get_future().share();
+	thr.cast([fut] { fut.wait(); });
+
+	// The second batch throws, but the third is still delivered
+	cnt.add(0, 1);
+	cnt.add(0, -1);
+	cnt.add(0, 1);
+
+	go.set_value();
+
+	REQUIRE(cnt.num_batches() == 2);
+	REQUIRE(cnt.count(0) == 2);
+
+	// The failed drain isn't replayed
+	cnt.add(1, 5);
+	REQUIRE(cnt.count(1) == 5);
+	REQUIRE(cnt.count(0) == 2);
+	REQUIRE(cnt.num_batches() == 3);
+}
+
+TEST_CASE("cohort bad member", "[cohort]") {
+	work_thread thr;
+	counters cnt(thr, 4);
+
+	cnt.add(7, 1);
+	cnt.add(1, 1);
+
+	REQUIRE(cnt.count(1) == 1);
+	REQUIRE(cnt.num_batches() == 1);
+}
+
+TEST_CASE("cohort ordering", "[cohort]") {
+	constexpr size_t N = 64;
+	constexpr uint32_t M = 100;
+	work_thread thr;
+	sequencers seq(thr, N);
+
+	// Uneven number of messages per member, sent in bulk and singly
+	std::vector<cohort<uint32_t>::member_id> ids;
+	std::vector<uint32_t> msgs;
+	std::vector<uint32_t> next(N, 1);
+
+	for (uint32_t i=0; i<M; ++i) {
+		for (size_t j=0; j<N; j+=(i%3)+1) {
+			ids.push_back(cohort<uint32_t>::member_id(j));
+			msgs.push_back(next[j]++);
+		}
+		if (i % 2 == 0) {
+			seq.send(ids.data(), msgs.data(), ids.size());
+		}
+		else {
+			for (size_t k=0; k<ids.size(); ++k)
+				seq.next(ids[k], msgs[k]);
+		}
+		ids.clear();
+		msgs.clear();
+	}
+
+	REQUIRE(seq.ok());
+	for (size_t j=0; j<N; ++j)
+		REQUIRE(seq.last(cohort<uint32_t>::member_id(j)) == next[j]-1);
+}
@@ -0,0 +1,311 @@
+// test_colocate.cpp
+//
+// Unit tests for the cooper 'colocate' classes.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/colocate.h"
+#include "catch2_version.h"
+#include <thread>
+#include <vector>
+#include <memory>
+#include <future>
+#include <chrono>
+
+using namespace cooper;
+
+// A plain actor, to test the placement hints
+class plain : public actor
+{
+public:
+	plain() {}
+	explicit plain(work_thread& thr) : actor(thr) {}
+	explicit plain(const colocate_with& hint) : actor(hint) {}
+
+	work_thread* thread() { return &get_thread(); }
+};
+
+// A mobile actor that records the messages it gets, and which thread
+// handled them.
+class recorder : public mobile_actor
+{
+	std::vector<int> vals_;
+	std::vector<std::thread::id> ids_;
+
+public:
+	explicit recorder(work_thread& thr) : mobile_actor(thr) {}
+	~recorder() { stop(); }
+
+	void add(int i) {
+		cast([this, i] {
+			vals_.push_back(i);
+			ids_.push_back(std::this_thread::get_id());
+		});
+	}
+	std::vector<int> vals() { return call([this] { return vals_; }); }
+	std::vector<std::thread::id> ids() { return call([this] { return ids_; }); }
+	work_thread* thread() { return &get_thread(); }
+	void self_destruct() { cast([this] { delete this; }); }
+};
+
+// A mobile actor that bounces a counter back and forth with a peer
+class pinger : public mobile_actor
+{
+	pinger* peer_ = nullptr;
+	int nRecv_ = 0;
+
+public:
+	pinger(colocator& col, work_thread& thr) : mobile_actor(col, thr) {}
+	~pinger() { stop(); }
+
+	void set_peer(pinger* peer) { peer_ = peer; }
+
+	// Bounces the counter until it hits zero, then sets the promise
+	void ping(int n, std::shared_ptr<std::promise<void>> done) {
+		cast([this, n, done] {
+			++nRecv_;
+			if (n > 0)
+				peer_->ping(n-1, done);
+			else
+				done->set_value();
+		});
+	}
+	// Bounces the counter and waits for it to finish
+	void rally(int n) {
+		auto done = std::make_shared<std::promise<void>>();
+		ping(n, done);
+		done->get_future().wait();
+	}
+	int num_received() { return call([this] { return nRecv_; }); }
+	work_thread* thread() { return &get_thread(); }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("colocate_with hint", "[colocate]") {
+	work_thread thrA, thrB;
+	plain a(thrA);
+
+	plain b(colocate_with{a});
+	REQUIRE(b.thread() == &thrA);
+
+	{
+		placement plc(colocate_with{a});
+		plain c;
+		REQUIRE(c.thread() == &thrA);
+	}
+
+	recorder r(thrB);
+	plain d(colocate_with{r});
+	REQUIRE(d.thread() == &thrB);
+}
+
+TEST_CASE("mobile_actor messages", "[colocate]") {
+	work_thread thr;
+	recorder r(thr);
+
+	for (int i=0; i<500; ++i)
+		r.add(i);
+
+	auto vals = r.vals();
+	REQUIRE(vals.size() == 500);
+	for (int i=0; i<500; ++i)
+		REQUIRE(vals[i] == i);
+}
+
+TEST_CASE("mobile_actor move with pending messages", "[colocate]") {
+	work_thread thrA, thrB;
+	recorder r(thrA);
+
+	// Hold the first thread so the messages pile up before the move
+	std::promise<void> gate;
+	thrA.cast([fut=gate.get_future().share()] { fut.wait(); });
+
+	for (int i=0; i<100; ++i)
+		r.add(i);
+	r.move_to(thrB);
+	for (int i=100; i<200; ++i)
+		r.add(i);
+
+	gate.set_value();
+
+	REQUIRE(r.thread() == &thrB);
+	REQUIRE(r.num_moves() == 1);
+
+	auto vals = r.vals();
+	REQUIRE(vals.size() == 200);
+	for (int i=0; i<200; ++i)
+		REQUIRE(vals[i] == i);
+
+	// Everything ran on the new thread
+	for (auto id : r.ids())
+		REQUIRE(id == thrB.get_id());
+}
+
+TEST_CASE("mobile_actor stop", "[colocate]") {
+	work_thread thr;
+
+	// Hold the thread so the messages stay queued
+	std::promise<void> gate;
+	thr.cast([fut=gate.get_future().share()] { fut.wait(); });
+
+	auto r = std::make_unique<recorder>(thr);
+	for (int i=0; i<100; ++i)
+		r->add(i);
+
+	// The destructor discards the messages, then waits for the drain task
+	// that's stuck behind the gate.
+	std::thread t([&r] { r.reset(); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	gate.set_value();
+	t.join();
+
+	REQUIRE(!r);
+	thr.flush();
+}
+
+TEST_CASE("mobile_actor deletes itself", "[colocate]") {
+	work_thread thr;
+
+	std::promise<void> gate;
+	thr.cast([fut=gate.get_future().share()] { fut.wait(); });
+
+	// The message after the one that deletes the actor is never handled
+	auto r = new recorder(thr);
+	r->add(1);
+	r->self_destruct();
+	r->add(2);
+	gate.set_value();
+	thr.flush();
+}
+
+TEST_CASE("mobile_actor drain discarded", "[colocate]") {
+	work_thread thr;
+
+	std::promise<void> gate, busy;
+	thr.cast([fut=gate.get_future().share(), &busy] {
+		busy.set_value();
+		fut.wait();
+	});
+	busy.get_future().wait();
+
+	auto r = std::make_unique<recorder>(thr);
+	auto fut = std::async(std::launch::async, [&r] { return r->vals(); });
+	while (thr.queue_size() == 0)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	// Dropping the drain task breaks the pending call, and the actor can
+	// still be destroyed.
+	thr.close();
+	REQUIRE(thr.discard() == 1);
+	REQUIRE_THROWS_AS(fut.get(), std::future_error);
+
+	r.reset();
+	gate.set_value();
+}
+
+TEST_CASE("mobile_actor moves back and forth", "[colocate]") {
+	work_thread thrA, thrB;
+	recorder r(thrA);
+
+	for (int i=0; i<2000; ++i) {
+		r.add(i);
+		if (i % 100 == 0)
+			r.move_to((i/100) % 2 ? thrA : thrB);
+	}
+
+	auto vals = r.vals();
+	REQUIRE(vals.size() == 2000);
+	for (int i=0; i<2000; ++i)
+		REQUIRE(vals[i] == i);
+}
+
+TEST_CASE("colocator pairs up chatty actors", "[colocate]") {
+	work_thread thrA, thrB;
+
+	colocate_options opts;
+	opts.min_messages = 10;
+	colocator col(opts);
+
+	// Two pairs, each split across the threads
+	pinger a1(col, thrA), b1(col, thrB), a2(col, thrA), b2(col, thrB);
+	a1.set_peer(&b1);
+	b1.set_peer(&a1);
+	a2.set_peer(&b2);
+	b2.set_peer(&a2);
+
+	REQUIRE(col.size() == 4);
+
+	a1.rally(100);
+	a2.rally(100);
+	REQUIRE(a1.num_received() + b1.num_received() == 101);
+	REQUIRE(a2.num_received() + b2.num_received() == 101);
+
+	REQUIRE(col.rebalance() == 2);
+	REQUIRE(col.num_passes() == 1);
+	REQUIRE(col.num_moves() == 2);
+
+	REQUIRE(a1.thread() == b1.thread());
+	REQUIRE(a2.thread() == b2.thread());
+
+	// ...and the pairs are spread over both threads
+	REQUIRE(a1.thread() != a2.thread());
+
+	// Once together, there's no reason to move again
+	a1.rally(100);
+	a2.rally(100);
+	REQUIRE(col.rebalance() == 0);
+}
+
+TEST_CASE("colocator ignores light traffic", "[colocate]") {
+	work_thread thrA, thrB;
+
+	colocate_options opts;
+	opts.min_messages = 1000;
+	colocator col(opts);
+
+	pinger a(col, thrA), b(col, thrB);
+	a.set_peer(&b);
+	b.set_peer(&a);
+
+	a.rally(100);
+
+	REQUIRE(col.rebalance() == 0);
+	REQUIRE(a.thread() != b.thread());
+}
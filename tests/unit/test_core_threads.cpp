@@ -0,0 +1,220 @@
+// test_core_threads.cpp
+//
+// Unit tests for the cooper 'core_threads' class.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/core_threads.h"
+#include "cooper/actor.h"
+#include "catch2_version.h"
+#include <future>
+#include <vector>
+#include <atomic>
+#include <chrono>
+
+using namespace cooper;
+
+static core_options test_opts(size_t cap=256) {
+	core_options opts;
+	opts.ring_capacity = cap;
+	opts.pin = false;
+	return opts;
+}
+
+// An actor that bounces a counter back and forth with a peer
+class volley : public actor
+{
+	volley* peer_ = nullptr;
+	std::vector<int> seen_;
+
+public:
+	explicit volley(work_thread& thr) : actor(thr) {}
+
+	void set_peer(volley* peer) { peer_ = peer; }
+
+	void hit(int n) {
+		cast([this, n] {
+			seen_.push_back(n);
+			if (n > 0)
+				peer_->hit(n-1);
+		});
+	}
+	std::vector<int> seen() { return call([this] { return seen_; }); }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("core_threads external tasks", "[core_threads]") {
+	core_threads thrs(2, test_opts());
+	REQUIRE(thrs.size() == 2);
+
+	auto fut = thrs[1].submit([] { return 42; });
+	REQUIRE(fut.get() == 42);
+
+	// Tasks from outside the set don't use the mesh
+	thrs.flush();
+	REQUIRE(thrs.num_mesh_sends() == 0);
+}
+
+TEST_CASE("core_threads mesh keeps order", "[core_threads]") {
+	constexpr int N = 5000;
+	core_threads thrs(2, test_opts());
+
+	std::vector<int> v;
+	thrs[0].post([&thrs, &v] {
+		for (int i=0; i<N; ++i)
+			thrs[1].post([&v, i] { v.push_back(i); });
+	});
+	thrs.wait_quiescent();
+
+	REQUIRE(v.size() == size_t(N));
+	for (int i=0; i<N; ++i)
+		REQUIRE(v[i] == i);
+
+	REQUIRE(thrs.num_mesh_sends() == uint64_t(N));
+}
+
+TEST_CASE("core_threads overflow keeps order", "[core_threads]") {
+	constexpr int N = 1000;
+	core_threads thrs(2, test_opts(4));
+
+	// Hold the receiver, so the sender fills the queue
+	std::promise<void> gate;
+	thrs[1].post([fut=gate.get_future().share()] { fut.wait(); });
+
+	std::vector<int> v;
+	auto sent = thrs[0].submit([&thrs, &v] {
+		for (int i=0; i<N; ++i)
+			thrs[1].post([&v, i] { v.push_back(i); });
+	});
+	sent.get();
+	gate.set_value();
+	thrs.wait_quiescent();
+
+	REQUIRE(thrs.num_overflows() > 0);
+	REQUIRE(v.size() == size_t(N));
+	for (int i=0; i<N; ++i)
+		REQUIRE(v[i] == i);
+}
+
+TEST_CASE("core_threads actors", "[core_threads]") {
+	core_threads thrs(2, test_opts(8));
+
+	volley a(thrs[0]), b(thrs[1]);
+	a.set_peer(&b);
+	b.set_peer(&a);
+
+	a.hit(1000);
+	thrs.wait_quiescent();
+
+	auto va = a.seen(), vb = b.seen();
+	REQUIRE(va.size() == 501);
+	REQUIRE(vb.size() == 500);
+	REQUIRE(va.front() == 1000);
+	REQUIRE(va.back() == 0);
+	REQUIRE(thrs.num_mesh_sends() >= 1000);
+}
+
+TEST_CASE("core_threads send to self", "[core_threads]") {
+	core_threads thrs(1, test_opts(4));
+
+	std::promise<int> done;
+	auto fut = done.get_future();
+
+	thrs[0].post([&thrs, &done] {
+		auto n = std::make_shared<int>(0);
+		for (int i=0; i<100; ++i)
+			thrs[0].post([n] { ++*n; });
+		thrs[0].post([n, &done] { done.set_value(*n); });
+	});
+	REQUIRE(fut.get() == 100);
+}
+
+TEST_CASE("core_threads closed peer", "[core_threads]") {
+	core_threads thrs(2, test_opts());
+	thrs[1].close();
+
+	auto fut = thrs[0].submit([&thrs] {
+		thrs[1].post([] {});
+	});
+	REQUIRE_THROWS_AS(fut.get(), queue_closed);
+}
+
+TEST_CASE("core_threads blocking call after overflow", "[core_threads]") {
+	using namespace std::chrono;
+	core_threads thrs(2, test_opts(4));
+
+	// A burst of casts fills the queue, then the sender blocks on a call
+	// to the same peer, which has to run after all of them.
+	auto fut = thrs[0].submit([&thrs] {
+		auto n = std::make_shared<int>(0);
+		for (int i=0; i<10; ++i)
+			thrs[1].post([n] { ++*n; });
+		return thrs[1].call([n] { return *n; });
+	});
+
+	REQUIRE(fut.wait_for(2s) == std::future_status::ready);
+	REQUIRE(fut.get() == 10);
+	REQUIRE(thrs.num_overflows() > 0);
+}
+
+TEST_CASE("core_threads send races with close", "[core_threads]") {
+	// Every send is either refused, or it runs. None are lost, so the
+	// set always reaches quiescence.
+	for (int k=0; k<20; ++k) {
+		core_threads thrs(2, test_opts(4));
+		auto nRun = std::make_shared<std::atomic<int>>(0);
+		std::atomic<int> nSent{0};
+
+		thrs[0].post([&thrs, &nSent, nRun] {
+			try {
+				for (int i=0; i<1000; ++i) {
+					thrs[1].post([nRun] { ++*nRun; });
+					++nSent;
+				}
+			}
+			catch (const queue_closed&) {}
+		});
+		thrs[1].close();
+		thrs[1].join();
+
+		REQUIRE(thrs.try_wait_quiescent_for(std::chrono::seconds(5)));
+		REQUIRE(*nRun == nSent);
+	}
+}
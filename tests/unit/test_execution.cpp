@@ -0,0 +1,223 @@
+// test_execution.cpp
+//
+// Test of the sender and receiver scheduling in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/actor.h"
+#include "cooper/execution.h"
+#include "catch2_version.h"
+#include <string>
+#include <memory>
+#include <future>
+
+using namespace cooper;
+
+TEST_CASE("schedule work thread", "[execution]") {
+	work_thread thr;
+
+	auto id = sync_wait(schedule(thr) | then([] { return std::this_thread::get_id(); }));
+	REQUIRE(id);
+	REQUIRE(*id == thr.get_id());
+
+	// A void sender
+	REQUIRE(sync_wait(schedule(thr)));
+}
+
+TEST_CASE("then chain", "[execution]") {
+	work_thread thr;
+
+	auto snd = then(schedule(thr), [] { return 21; })
+				| then([](int n) { return 2*n; })
+				| then([](int n) { return std::to_string(n); });
+
+	REQUIRE(sync_wait(std::move(snd)) == std::string("42"));
+
+	// Move-only values and functions
+	auto p = std::make_unique<int>(7);
+	auto snd2 = schedule(thr)
+				| then([p=std::move(p)]() mutable { return std::move(p); })
+				| then([](std::unique_ptr<int> p) { return *p; });
+	REQUIRE(sync_wait(std::move(snd2)) == 7);
+}
+
+TEST_CASE("then error", "[execution]") {
+	work_thread thr;
+
+	bool ran = false;
+	auto snd = schedule(thr)
+				| then([]() -> int { throw std::runtime_error("bad"); })
+				| then([&ran](int) { ran = true; });
+
+	REQUIRE_THROWS_AS(sync_wait(std::move(snd)), std::runtime_error);
+	REQUIRE(!ran);
+}
+
+TEST_CASE("schedule closed thread", "[execution]") {
+	work_thread thr;
+	thr.close();
+	REQUIRE_THROWS_AS(sync_wait(schedule(thr)), queue_closed);
+}
+
+// A receiver that counts its completions
+struct counting_receiver {
+	int* nValue;
+	int* nError;
+	int* nStopped;
+
+	void set_value() { ++*nValue; }
+	void set_error(std::exception_ptr) { ++*nError; }
+	void set_stopped() { ++*nStopped; }
+};
+
+TEST_CASE("schedule closed thread completes once", "[execution]") {
+	work_thread thr;
+	thr.close();
+
+	int nValue = 0, nError = 0, nStopped = 0;
+	auto op = schedule(thr).connect(counting_receiver{&nValue, &nError, &nStopped});
+	op.start();
+
+	REQUIRE(nValue == 0);
+	REQUIRE(nError == 1);
+	REQUIRE(nStopped == 0);
+
+	// A detached operation is freed exactly once
+	start_detached(schedule(thr));
+}
+
+TEST_CASE("schedule discarded", "[execution]") {
+	work_thread thr;
+
+	std::promise<void> go, busy;
+	auto fut = go.get_future().share();
+	thr.cast([fut, &busy] {
+		busy.set_value();
+		fut.wait();
+	});
+	busy.get_future().wait();
+
+	std::promise<bool> res;
+	auto resFut = res.get_future();
+	std::thread waiter([&thr, &res] {
+		res.set_value(sync_wait(schedule(thr)));
+	});
+
+	while (thr.queue_size() == 0)
+		std::this_thread::yield();
+	thr.discard();
+	go.set_value();
+
+	// Stopped, not completed
+	REQUIRE(!resFut.get());
+	waiter.join();
+}
+
+TEST_CASE("when all", "[execution]") {
+	work_threads thrs(3);
+
+	auto snd = when_all(
+		schedule(thrs[0]) | then([] { return 1; }),
+		schedule(thrs[1]) | then([] { return std::string("two"); }),
+		schedule(thrs[2])
+	);
+
+	auto res = sync_wait(std::move(snd));
+	REQUIRE(res);
+	REQUIRE(std::get<0>(*res) == 1);
+	REQUIRE(std::get<1>(*res) == "two");
+
+	// Empty
+	REQUIRE(sync_wait(when_all()));
+
+	// Composed further
+	auto sum = when_all(
+		schedule(thrs) | then([] { return 2; }),
+		schedule(thrs) | then([] { return 3; })
+	) | then([](std::tuple<int,int> t) { return std::get<0>(t) + std::get<1>(t); });
+
+	REQUIRE(sync_wait(std::move(sum)) == 5);
+}
+
+TEST_CASE("when all error", "[execution]") {
+	work_threads thrs(2);
+
+	auto snd = when_all(
+		schedule(thrs[0]) | then([] { return 1; }),
+		schedule(thrs[1]) | then([]() -> int { throw std::logic_error("oops"); })
+	);
+	REQUIRE_THROWS_AS(sync_wait(std::move(snd)), std::logic_error);
+}
+
+TEST_CASE("start detached", "[execution]") {
+	work_thread thr;
+	std::promise<std::thread::id> prom;
+
+	start_detached(schedule(thr) | then([&prom] {
+		prom.set_value(std::this_thread::get_id());
+	}));
+
+	REQUIRE(prom.get_future().get() == thr.get_id());
+}
+
+// --------------------------------------------------------------------------
+
+// An actor with an asynchronous interface that returns senders
+class async_counter : public this_actor<async_counter>
+{
+	int n_ = 0;
+
+public:
+	using this_actor::this_actor;
+
+	auto inc() {
+		return schedule(scheduler()) | then([this] { return ++n_; });
+	}
+};
+
+TEST_CASE("actor sender", "[execution]") {
+	work_thread thr;
+	async_counter cnt(thr);
+
+	REQUIRE(sync_wait(cnt.inc()) == 1);
+
+	auto both = when_all(cnt.inc(), cnt.inc())
+				| then([](std::tuple<int,int> t) { return std::get<0>(t) + std::get<1>(t); });
+	REQUIRE(sync_wait(std::move(both)) == 5);
+}
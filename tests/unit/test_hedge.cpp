@@ -0,0 +1,202 @@
+// test_hedge.cpp
+//
+// Test of hedged calls in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/hedge.h"
+#include "catch2_version.h"
+#include <future>
+#include <thread>
+
+using namespace cooper;
+using namespace std::chrono;
+
+// A replica that reports which one handled the request
+class replica : public actor
+{
+	int id_;
+
+public:
+	replica() : id_(0) {}
+	void set_id(int id) { id_ = id; }
+	int id() const { return id_; }
+};
+
+// Blocks a work thread until the returned promise is set.
+static std::promise<void> block(work_thread& thr) {
+	std::promise<void> gate, busy;
+	auto busyFut = busy.get_future();
+	thr.cast([fut=gate.get_future().share(), busy=std::move(busy)]() mutable {
+		busy.set_value();
+		fut.wait();
+	});
+	busyFut.wait();
+	return gate;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("latency tracker", "[hedge]") {
+	hedge_options opts;
+	opts.percentile = 0.9;
+	opts.window = 64;
+	opts.min_samples = 64;
+	opts.min_delay = microseconds(1);
+	opts.max_delay = milliseconds(50);
+	opts.initial_delay = milliseconds(5);
+
+	latency_tracker lat(opts);
+	REQUIRE(lat.percentile() == milliseconds(5));
+
+	for (int i=1; i<=64; ++i)
+		lat.add(microseconds(i));
+	REQUIRE(lat.percentile() == microseconds(58));
+
+	// Clamped to the maximum
+	for (int i=1; i<=64; ++i)
+		lat.add(seconds(i));
+	REQUIRE(lat.percentile() == milliseconds(50));
+	REQUIRE(lat.num_samples() == 128);
+}
+
+TEST_CASE("hedged call", "[hedge]") {
+	work_threads thrs(2);
+	hedge_options opts;
+	opts.initial_delay = milliseconds(20);
+
+	replica_group<replica> grp(thrs, 2, opts);
+	for (size_t i=0; i<grp.size(); ++i)
+		thrs[i].call([&grp, i] { grp[i].set_id(int(i)); });
+
+	SECTION("fast replicas") {
+		for (int i=0; i<4; ++i)
+			grp.call([](replica& r) { return r.id(); });
+		REQUIRE(grp.num_calls() == 4);
+		REQUIRE(grp.num_hedged() == 0);
+	}
+
+	SECTION("slow replica") {
+		// Replica 0 is next, and its thread is stuck
+		auto gate = block(thrs[0]);
+
+		auto start = steady_clock::now();
+		int id = grp.call([](replica& r) { return r.id(); });
+		auto elapsed = steady_clock::now() - start;
+
+		REQUIRE(id == 1);
+		REQUIRE(elapsed >= milliseconds(20));
+		REQUIRE(grp.num_hedged() == 1);
+		REQUIRE(grp.num_hedge_wins() == 1);
+
+		// The request to the stuck replica never starts
+		gate.set_value();
+		thrs[0].flush();
+		REQUIRE(grp.num_cancelled() == 1);
+	}
+
+	SECTION("errors") {
+		auto gate = block(thrs[0]);
+
+		// The hedge fails, so the caller waits for the first request
+		auto fut = std::async(std::launch::async, [&grp] {
+			return grp.call([](replica& r) {
+				if (r.id() == 1)
+					throw std::runtime_error("fail");
+				return r.id();
+			});
+		});
+		while (grp.num_hedged() == 0)
+			std::this_thread::sleep_for(milliseconds(1));
+		thrs[1].flush();
+		gate.set_value();
+		REQUIRE(fut.get() == 0);
+
+		// Both fail
+		REQUIRE_THROWS_AS(grp.call([](replica&) -> int {
+			throw std::runtime_error("fail");
+		}), std::runtime_error);
+	}
+}
+
+TEST_CASE("hedged call discarded", "[hedge]") {
+	work_threads thrs(2);
+	hedge_options opts;
+	opts.initial_delay = milliseconds(10);
+
+	SECTION("single replica") {
+		replica_group<replica> grp(thrs, 1, opts);
+		auto gate = block(thrs[0]);
+
+		auto fut = std::async(std::launch::async, [&grp] {
+			return grp.call([](replica& r) { return r.id(); });
+		});
+		while (thrs[0].queue_size() == 0)
+			std::this_thread::sleep_for(milliseconds(1));
+
+		thrs[0].close();
+		REQUIRE(thrs[0].discard() == 1);
+		REQUIRE_THROWS_AS(fut.get(), queue_closed);
+		gate.set_value();
+	}
+
+	SECTION("hedge discarded after first request failed") {
+		replica_group<replica> grp(thrs, 2, opts);
+		auto gate0 = block(thrs[0]);
+		auto gate1 = block(thrs[1]);
+
+		auto fut = std::async(std::launch::async, [&grp] {
+			return grp.call([](replica&) -> int {
+				throw std::runtime_error("fail");
+			});
+		});
+		while (grp.num_hedged() == 0 || thrs[1].queue_size() == 0)
+			std::this_thread::sleep_for(milliseconds(1));
+
+		// The first request fails, then the hedge is dropped
+		gate0.set_value();
+		thrs[0].flush();
+		REQUIRE(fut.wait_for(milliseconds(0)) == std::future_status::timeout);
+
+		thrs[1].close();
+		REQUIRE(thrs[1].discard() == 1);
+		REQUIRE_THROWS_AS(fut.get(), std::runtime_error);
+		gate1.set_value();
+	}
+}
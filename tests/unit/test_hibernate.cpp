@@ -0,0 +1,212 @@
+// test_hibernate.cpp
+//
+// Test of the actor hibernation in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/hibernate.h"
+#include "catch2_version.h"
+#include <vector>
+#include <future>
+#include <thread>
+
+using namespace std::chrono;
+using namespace cooper;
+
+// An actor that keeps a cache which it drops while hibernating.
+class cache_actor : public hibernating_actor
+{
+	std::vector<int> cache_;
+	int nHibernate_ = 0;
+	int nWake_ = 0;
+
+protected:
+	void on_hibernate() override {
+		++nHibernate_;
+		cache_.clear();
+		cache_.shrink_to_fit();
+	}
+	void on_wake() override {
+		++nWake_;
+		cache_.resize(100);
+	}
+
+public:
+	cache_actor(hibernator& hib, work_thread& thr)
+			: hibernating_actor(hib, thr), cache_(100) {}
+	~cache_actor() { stop(); }
+
+	// Returns the cache size seen by the handler.
+	size_t cache_size() {
+		return call([this] { return cache_.size(); });
+	}
+
+	std::pair<int,int> counts() {
+		return actor::call([this] { return std::make_pair(nHibernate_, nWake_); });
+	}
+};
+
+// Waits up to a second for the hibernator to reach a number of
+// hibernating actors.
+static bool wait_hibernating(hibernator& hib, size_t n)
+{
+	auto tp = steady_clock::now() + 1s;
+	while (hib.num_hibernating() != n) {
+		if (steady_clock::now() > tp)
+			return false;
+		std::this_thread::sleep_for(1ms);
+	}
+	return true;
+}
+
+TEST_CASE("hibernate idle actor", "[hibernate]") {
+	work_thread thr;
+	hibernator hib(20ms, 5ms);
+
+	{
+		cache_actor act(hib, thr);
+
+		// The actor registers when it handles its first message
+		REQUIRE(hib.size() == 0);
+		REQUIRE(act.cache_size() == 100);
+		REQUIRE(hib.size() == 1);
+
+		REQUIRE(wait_hibernating(hib, 1));
+		REQUIRE(act.counts() == std::make_pair(1, 0));
+
+		// The message wakes the actor before it's handled
+		REQUIRE(act.cache_size() == 100);
+		REQUIRE(hib.num_hibernating() == 0);
+		REQUIRE(act.counts() == std::make_pair(1, 1));
+
+		REQUIRE(wait_hibernating(hib, 1));
+	}
+
+	// Destroying a hibernating actor unregisters it
+	REQUIRE(hib.size() == 0);
+	REQUIRE(hib.num_hibernating() == 0);
+}
+
+TEST_CASE("hibernate busy actor", "[hibernate]") {
+	work_thread thr;
+	hibernator hib(50ms, 5ms);
+	cache_actor act(hib, thr);
+
+	// Keep the actor busy for several idle periods
+	auto tp = steady_clock::now() + 200ms;
+	while (steady_clock::now() < tp) {
+		REQUIRE(act.cache_size() == 100);
+		std::this_thread::sleep_for(2ms);
+	}
+	REQUIRE(act.counts().first == 0);
+}
+
+TEST_CASE("hibernate many actors", "[hibernate]") {
+	constexpr size_t N = 20;
+	work_threads thrs(2);
+	hibernator hib(20ms, 5ms);
+
+	std::vector<std::unique_ptr<cache_actor>> acts;
+	for (size_t i=0; i<N; ++i) {
+		acts.push_back(std::make_unique<cache_actor>(hib, thrs.next_thread()));
+		acts.back()->cache_size();
+	}
+
+	REQUIRE(hib.size() == N);
+	REQUIRE(wait_hibernating(hib, N));
+
+	for (auto& act : acts)
+		REQUIRE(act->cache_size() == 100);
+	REQUIRE(hib.num_hibernating() == 0);
+
+	acts.clear();
+	REQUIRE(hib.size() == 0);
+}
+
+TEST_CASE("hibernate skips sleeping actors", "[hibernate]") {
+	work_thread thr;
+	hibernator hib(10ms, 2ms);
+	cache_actor act(hib, thr);
+	act.cache_size();
+
+	REQUIRE(wait_hibernating(hib, 1));
+	thr.flush();
+
+	// With every actor on the thread asleep, the sweeps leave it alone
+	auto nSubmitted = thr.num_submitted();
+	std::this_thread::sleep_for(50ms);
+	REQUIRE(thr.num_submitted() == nSubmitted);
+
+	// Until one wakes up
+	REQUIRE(act.cache_size() == 100);
+	REQUIRE(wait_hibernating(hib, 1));
+	REQUIRE(act.counts() == std::make_pair(2, 1));
+}
+
+TEST_CASE("hibernate sweep on a full queue", "[hibernate]") {
+	work_thread thr, thr2;
+	hibernator hib(10ms, 2ms);
+	cache_actor idler(hib, thr);
+	idler.cache_size();
+
+	// Hold the thread, and fill its queue, so that when the actor goes
+	// idle, the sweep blocks trying to queue its task.
+	std::promise<void> gate, busy;
+	thr.cast([fut=gate.get_future().share(), &busy] {
+		busy.set_value();
+		fut.wait();
+	});
+	busy.get_future().wait();
+
+	thr.queue_capacity(1);
+	thr.cast([]{});
+	std::this_thread::sleep_for(30ms);
+
+	// Actors on other threads can still come and go
+	auto fut = std::async(std::launch::async, [&hib, &thr2] {
+		cache_actor act(hib, thr2);
+		return act.cache_size();
+	});
+	bool ready = fut.wait_for(1s) == std::future_status::ready;
+
+	gate.set_value();
+	REQUIRE(ready);
+	REQUIRE(fut.get() == 100);
+	REQUIRE(wait_hibernating(hib, 1));
+}
@@ -0,0 +1,203 @@
+// test_rate_limit.cpp
+//
+// Test of the rate limiters in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/rate_limit.h"
+#include "catch2_version.h"
+#include <string>
+#include <stdexcept>
+
+using namespace std::chrono;
+using namespace cooper;
+
+TEST_CASE("token bucket", "[rate_limit]") {
+	auto t = token_bucket::clock::now();
+	token_bucket bkt(100.0, 5.0, t);
+
+	REQUIRE(bkt.full(t));
+
+	// Take the burst
+	for (int i=0; i<5; ++i)
+		REQUIRE(bkt.try_take(t));
+	REQUIRE(!bkt.try_take(t));
+
+	// One token refills in 10ms
+	REQUIRE(!bkt.try_take(t + 5ms));
+	REQUIRE(bkt.try_take(t + 10ms));
+	REQUIRE(!bkt.try_take(t + 10ms));
+
+	// Never more than the burst
+	REQUIRE(bkt.available(t + 1s) == 5.0);
+
+	SECTION("reserve") {
+		t += 1s;
+		nanoseconds delay;
+		for (int i=0; i<5; ++i) {
+			REQUIRE(bkt.reserve(1s, &delay, t));
+			REQUIRE(delay.count() == 0);
+		}
+		REQUIRE(bkt.reserve(1s, &delay, t));
+		REQUIRE(delay >= 9ms);
+		REQUIRE(delay <= 11ms);
+
+		// Borrowed one, so the next is twice as far out
+		REQUIRE(bkt.reserve(1s, &delay, t));
+		REQUIRE(delay >= 19ms);
+		REQUIRE(delay <= 21ms);
+
+		// Too long to wait
+		REQUIRE(!bkt.reserve(25ms, &delay, t));
+	}
+}
+
+TEST_CASE("token bucket parameters", "[rate_limit]") {
+	REQUIRE_THROWS_AS(token_bucket(0.0, 5.0), std::invalid_argument);
+	REQUIRE_THROWS_AS(token_bucket(-1.0, 5.0), std::invalid_argument);
+	REQUIRE_THROWS_AS(token_bucket(100.0, 0.5), std::invalid_argument);
+	REQUIRE_THROWS_AS(token_bucket(100.0, -5.0), std::invalid_argument);
+
+	limit_options opts;
+	opts.rate = 0.0;
+	REQUIRE_THROWS_AS(rate_limiter(opts), std::invalid_argument);
+	REQUIRE_THROWS_AS(keyed_rate_limiter<int>(opts), std::invalid_argument);
+}
+
+TEST_CASE("rate limiter reject", "[rate_limit]") {
+	limit_options opts;
+	opts.rate = 1.0;
+	opts.burst = 10.0;
+
+	rate_limiter lim(opts);
+
+	size_t n = 0;
+	for (int i=0; i<20; ++i)
+		if (lim.admit()) ++n;
+
+	REQUIRE(n == 10);
+	REQUIRE(lim.num_accepted() == 10);
+	REQUIRE(lim.num_rejected() == 10);
+	REQUIRE(lim.num_delayed() == 0);
+}
+
+TEST_CASE("rate limiter delay", "[rate_limit]") {
+	limit_options opts;
+	opts.rate = 1000.0;
+	opts.burst = 1.0;
+	opts.mode = limit_mode::delay;
+
+	rate_limiter lim(opts);
+
+	auto start = steady_clock::now();
+	for (int i=0; i<11; ++i)
+		REQUIRE(lim.admit());
+
+	REQUIRE(steady_clock::now() - start >= 9ms);
+	REQUIRE(lim.num_accepted() >= 1);
+	REQUIRE(lim.num_accepted() + lim.num_delayed() == 11);
+	REQUIRE(lim.num_rejected() == 0);
+
+	SECTION("max delay") {
+		opts.rate = 1.0;
+		opts.max_delay = 10ms;
+		rate_limiter lim(opts);
+
+		REQUIRE(lim.admit());
+		REQUIRE(!lim.admit());
+		REQUIRE(lim.num_rejected() == 1);
+	}
+}
+
+TEST_CASE("keyed rate limiter", "[rate_limit]") {
+	limit_options opts;
+	opts.rate = 1.0;
+	opts.burst = 2.0;
+
+	keyed_rate_limiter<std::string> lim(opts);
+
+	REQUIRE(lim.admit("bad"));
+	REQUIRE(lim.admit("bad"));
+	REQUIRE(!lim.admit("bad"));
+	REQUIRE(!lim.admit("bad"));
+
+	// Others are unaffected by the bad client
+	REQUIRE(lim.admit("good"));
+	REQUIRE(lim.admit("good"));
+
+	REQUIRE(lim.size() == 2);
+	REQUIRE(lim.num_accepted() == 4);
+	REQUIRE(lim.num_rejected() == 2);
+}
+
+// --------------------------------------------------------------------------
+
+// An actor that limits the messages from each client
+class limited_counter : public rate_limited_actor<keyed_rate_limiter<int>>
+{
+	size_t n_ = 0;
+
+public:
+	limited_counter(work_thread& thr, const limit_options& opts)
+		: rate_limited_actor(thr, opts) {}
+
+	bool inc(int client) {
+		return cast_from(client, [this] { ++n_; });
+	}
+
+	size_t count() { return call([this] { return n_; }); }
+};
+
+TEST_CASE("rate limited actor", "[rate_limit]") {
+	work_thread thr;
+
+	limit_options opts;
+	opts.rate = 1.0;
+	opts.burst = 5.0;
+
+	limited_counter cnt(thr, opts);
+
+	for (int i=0; i<100; ++i)
+		cnt.inc(1);
+	for (int i=0; i<3; ++i)
+		REQUIRE(cnt.inc(2));
+
+	REQUIRE(cnt.count() == 8);
+	REQUIRE(cnt.limiter().num_rejected() == 95);
+}
@@ -0,0 +1,192 @@
+// test_reactive.cpp
+//
+// Test of the reactive cells in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/reactive.h"
+#include "catch2_version.h"
+#include <vector>
+#include <numeric>
+
+using namespace cooper;
+
+// Statistics over a set of samples, recomputed incrementally
+class stats : public reactive_actor
+{
+	input_cell<std::vector<int>> samples_;
+	input_cell<int> scale_;
+	derived_cell<int> sum_;
+	derived_cell<int> sign_;
+	derived_cell<int> scaled_;
+	observer report_;
+	std::vector<int> reports_;
+
+public:
+	explicit stats(work_thread& thr)
+		: reactive_actor(thr),
+			samples_(*this),
+			scale_(*this, 1),
+			sum_(*this, [this] {
+				auto& v = samples_.get();
+				return std::accumulate(v.begin(), v.end(), 0);
+			}, samples_),
+			sign_(*this, [this] { return sum_.get() < 0 ? -1 : 1; }, sum_),
+			scaled_(*this, [this] { return sign_.get() * scale_.get(); }, sign_, scale_),
+			report_(*this, [this] { reports_.push_back(sum_.get()); }, sum_) {}
+
+	void add(int x) { cast([this, x] { samples_.modify([x](auto& v) { v.push_back(x); }); }); }
+	void scale(int x) { cast([this, x] { scale_.set(x); }); }
+
+	int sum() { return call([this] { return sum_.get(); }); }
+	int scaled() { return call([this] { return scaled_.get(); }); }
+
+	// The number of times each derived cell was computed
+	std::vector<size_t> computes() {
+		return call([this] {
+			return std::vector<size_t>{
+				sum_.num_computes(), sign_.num_computes(), scaled_.num_computes()
+			};
+		});
+	}
+	std::vector<int> reports() { return call([this] { return reports_; }); }
+	size_t flushes() { return call([this] { return num_flushes(); }); }
+
+	// Closes the thread, then adds samples, counting the ones that fail
+	// to queue the observers.
+	int add_after_close(int n) {
+		return call([this, n] {
+			get_thread().close();
+			int nFail = 0;
+			for (int i=0; i<n; ++i) {
+				try {
+					samples_.modify([i](auto& v) { v.push_back(i); });
+				}
+				catch (const queue_closed&) {
+					++nFail;
+				}
+			}
+			return nFail;
+		});
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("reactive lazy", "[reactive]") {
+	work_thread thr;
+	stats st(thr);
+
+	// Nothing is computed until it's read
+	st.add(1);
+	st.add(2);
+	thr.flush();
+	REQUIRE(st.computes() == std::vector<size_t>{ 1, 0, 0 });
+
+	REQUIRE(st.scaled() == 1);
+	REQUIRE(st.computes() == std::vector<size_t>{ 1, 1, 1 });
+
+	// Reading again doesn't recompute
+	REQUIRE(st.scaled() == 1);
+	REQUIRE(st.sum() == 3);
+	REQUIRE(st.computes() == std::vector<size_t>{ 1, 1, 1 });
+}
+
+TEST_CASE("reactive cutoff", "[reactive]") {
+	work_thread thr;
+	stats st(thr);
+
+	st.add(5);
+	REQUIRE(st.scaled() == 1);
+
+	// The sum changes, but the sign doesn't, so the scaled value is not
+	// recomputed.
+	st.add(5);
+	REQUIRE(st.scaled() == 1);
+	REQUIRE(st.computes()[1] == 2);
+	REQUIRE(st.computes()[2] == 1);
+
+	// Only the scale changed, so the sum is not recomputed
+	size_t nSum = st.computes()[0];
+	st.scale(3);
+	REQUIRE(st.scaled() == 3);
+	REQUIRE(st.computes()[0] == nSum);
+
+	// Setting the same value does nothing
+	st.scale(3);
+	REQUIRE(st.scaled() == 3);
+	REQUIRE(st.computes()[2] == 2);
+
+	st.add(-20);
+	REQUIRE(st.scaled() == -3);
+}
+
+TEST_CASE("reactive observer batch", "[reactive]") {
+	constexpr int N = 100;
+	work_thread thr;
+	stats st(thr);
+
+	// Hold the thread so the updates arrive as a burst
+	std::promise<void> gate;
+	thr.cast([fut=gate.get_future()] { fut.wait(); });
+
+	for (int i=1; i<=N; ++i)
+		st.add(i);
+	gate.set_value();
+
+	// The observers are queued behind the updates when the first one runs,
+	// so it takes a second flush to be sure they ran.
+	thr.flush();
+	thr.flush();
+	REQUIRE(st.reports() == std::vector<int>{ N*(N+1)/2 });
+	REQUIRE(st.flushes() == 1);
+
+	// A change that doesn't affect the observed cell doesn't run it
+	st.scale(2);
+	thr.flush();
+	REQUIRE(st.reports().size() == 1);
+}
+
+TEST_CASE("reactive closed thread", "[reactive]") {
+	work_thread thr;
+	stats st(thr);
+
+	// Each change tries again to queue the observers
+	REQUIRE(st.add_after_close(2) == 2);
+}
@@ -0,0 +1,208 @@
+// test_read_cache.cpp
+//
+// Test of the read_cache and cached_actor classes in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/read_cache.h"
+#include "catch2_version.h"
+#include <thread>
+#include <vector>
+#include <string>
+#include <map>
+
+using namespace cooper;
+
+// A key/value store with cached reads
+class config : public cached_actor
+{
+	std::map<std::string, int> vals_;
+	read_cache<std::string, int> cache_;
+	int nRead_ = 0;
+
+public:
+	using cached_actor::cached_actor;
+
+	int get(const std::string& key) {
+		return read(cache_, key, [this, key] {
+			++nRead_;
+			auto p = vals_.find(key);
+			return p == vals_.end() ? 0 : p->second;
+		});
+	}
+	// Reads through a cache that is private to the calling thread. Since
+	// it is static, only one config object in a program can use this.
+	int get_local(const std::string& key) {
+		thread_local read_cache<std::string, int, std::hash<std::string>, sync::null_mutex> cache;
+		return read(cache, key, [this, key] {
+			++nRead_;
+			return vals_[key];
+		});
+	}
+	void set(const std::string& key, int val) {
+		write([this, key, val] { vals_[key] = val; });
+	}
+	int set_wait(const std::string& key, int val) {
+		return call_write([this, key, val] { return vals_[key] = val; });
+	}
+	void touch(const std::string& key, int val) {
+		cast([this, key, val] {
+			vals_[key] = val;
+			invalidate();
+		});
+	}
+	int num_reads() { return call([this] { return nRead_; }); }
+	const read_cache<std::string, int>& cache() const { return cache_; }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("cache version", "[read_cache]") {
+	cache_version ver;
+	uint64_t v = 99;
+
+	REQUIRE(ver.stable(&v));
+	REQUIRE(v == 0);
+
+	ver.begin_write();
+	REQUIRE(!ver.stable(&v));
+	ver.end_write();
+	REQUIRE(ver.stable(&v));
+	REQUIRE(v == 1);
+
+	ver.bump();
+	REQUIRE(ver.current() == 2);
+}
+
+TEST_CASE("read cache entries", "[read_cache]") {
+	read_cache<int, int> cache(2);
+	int val = 0;
+
+	REQUIRE(!cache.find(1, 0, &val));
+	cache.insert(1, 0, 10);
+	REQUIRE(cache.find(1, 0, &val));
+	REQUIRE(val == 10);
+	REQUIRE(!cache.find(1, 1, &val));
+
+	// An older read doesn't replace a newer one
+	cache.insert(1, 2, 12);
+	cache.insert(1, 1, 11);
+	REQUIRE(cache.find(1, 2, &val));
+	REQUIRE(val == 12);
+
+	// Stale entries make room for new ones
+	cache.insert(2, 2, 20);
+	cache.insert(3, 3, 30);
+	REQUIRE(cache.size() == 1);
+	REQUIRE(cache.find(3, 3, &val));
+
+	REQUIRE(cache.num_hits() == 3);
+	REQUIRE(cache.num_misses() == 2);
+}
+
+TEST_CASE("cached actor", "[read_cache]") {
+	work_thread thr;
+	config cfg(thr);
+
+	cfg.set_wait("a", 1);
+	REQUIRE(cfg.version() == 1);
+
+	for (int i=0; i<10; ++i)
+		REQUIRE(cfg.get("a") == 1);
+	REQUIRE(cfg.num_reads() == 1);
+	REQUIRE(cfg.cache().num_hits() == 9);
+
+	// A write that was sent, but not yet run, still invalidates the cache
+	cfg.set("a", 2);
+	REQUIRE(cfg.get("a") == 2);
+	REQUIRE(cfg.get("a") == 2);
+	REQUIRE(cfg.num_reads() == 2);
+
+	// So does an explicit invalidation
+	cfg.touch("a", 3);
+	thr.flush();
+	REQUIRE(cfg.get("a") == 3);
+	REQUIRE(cfg.num_reads() == 3);
+}
+
+TEST_CASE("cached actor thread local", "[read_cache]") {
+	work_thread thr;
+	config cfg(thr);
+
+	cfg.set("a", 1);
+	REQUIRE(cfg.get_local("a") == 1);
+	REQUIRE(cfg.get_local("a") == 1);
+	REQUIRE(cfg.num_reads() == 1);
+
+	std::thread([&cfg] {
+		REQUIRE(cfg.get_local("a") == 1);
+	}).join();
+	REQUIRE(cfg.num_reads() == 2);
+}
+
+TEST_CASE("cached actor consistency", "[read_cache]") {
+	constexpr int N = 2000;
+	constexpr int NTHR = 3;
+	work_thread thr;
+	config cfg(thr);
+
+	std::vector<std::thread> readers;
+	std::atomic<bool> ok { true };
+
+	for (int i=0; i<NTHR; ++i) {
+		readers.emplace_back([&] {
+			int last = 0;
+			while (last < N) {
+				int val = cfg.get("n");
+				if (val < last)
+					ok = false;
+				last = val;
+			}
+		});
+	}
+
+	for (int i=1; i<=N; ++i)
+		cfg.set("n", i);
+
+	for (auto& t : readers)
+		t.join();
+
+	REQUIRE(ok);
+	REQUIRE(cfg.get("n") == N);
+}
@@ -0,0 +1,137 @@
+// test_registry.cpp
+//
+// Test of the registry class in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#include "cooper/registry.h"
+#include "catch2_version.h"
+#include <vector>
+
+using namespace cooper;
+
+TEST_CASE("registry constructors", "[registry]") {
+	registry<std::string, int> reg;
+	REQUIRE(reg.empty());
+	REQUIRE(reg.size() == 0);
+	REQUIRE(!reg.find("bubba"));
+}
+
+TEST_CASE("registry updates", "[registry]") {
+	registry<std::string, int> reg;
+
+	SECTION("insert") {
+		REQUIRE(reg.insert("bubba", 42));
+		REQUIRE(!reg.insert("bubba", 99));
+		REQUIRE(reg.size() == 1);
+		REQUIRE(reg.contains("bubba"));
+		REQUIRE(*reg.find("bubba") == 42);
+
+		int val = 0;
+		REQUIRE(reg.find("bubba", &val));
+		REQUIRE(val == 42);
+		REQUIRE(!reg.find("wally", &val));
+	}
+
+	SECTION("insert_or_assign") {
+		reg.insert_or_assign("bubba", 42);
+		reg.insert_or_assign("bubba", 99);
+		REQUIRE(reg.size() == 1);
+		REQUIRE(*reg.find("bubba") == 99);
+	}
+
+	SECTION("erase") {
+		reg.insert("bubba", 42);
+		reg.insert("wally", 99);
+		REQUIRE(reg.erase("bubba"));
+		REQUIRE(!reg.erase("bubba"));
+		REQUIRE(reg.size() == 1);
+		REQUIRE(!reg.contains("bubba"));
+		REQUIRE(reg.contains("wally"));
+
+		reg.clear();
+		REQUIRE(reg.empty());
+	}
+
+	SECTION("batch update") {
+		reg.update([](auto& m) {
+			for (int i=0; i<10; ++i)
+				m[std::to_string(i)] = i;
+		});
+		REQUIRE(reg.size() == 10);
+
+		int sum = 0;
+		reg.for_each([&sum](const std::string&, int val) { sum += val; });
+		REQUIRE(sum == 45);
+	}
+}
+
+TEST_CASE("registry concurrent readers", "[registry]") {
+	constexpr int N = 1000;
+
+	actor_id_registry<int> reg;
+	std::atomic<bool> done{false};
+	std::atomic<int> nbad{0};
+
+	std::vector<std::thread> readers;
+	for (int i=0; i<2; ++i) {
+		readers.emplace_back([&] {
+			while (!done) {
+				for (uint64_t id=0; id<N; id += 97) {
+					auto h = reg.find(id);
+					if (h && **h != int(id))
+						++nbad;
+				}
+			}
+		});
+	}
+
+	for (int i=0; i<N; ++i)
+		reg.insert(uint64_t(i), std::make_shared<int>(i));
+	for (int i=0; i<N; i+=2)
+		reg.erase(uint64_t(i));
+
+	done = true;
+	for (auto& thr : readers)
+		thr.join();
+
+	REQUIRE(nbad == 0);
+	REQUIRE(reg.size() == N/2);
+}
@@ -0,0 +1,118 @@
+// test_ring_buffer.cpp
+//
+// Test of the ring_buffer class in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+
+#include "cooper/ring_buffer.h"
+#include "cooper/thread_queue.h"
+#include "catch2_version.h"
+#include <memory>
+#include <string>
+
+using namespace cooper;
+
+TEST_CASE("ring_buffer constructors", "[ring_buffer]") {
+	SECTION("default constructor") {
+		ring_buffer<int> buf;
+		REQUIRE(buf.empty());
+		REQUIRE(buf.size() == 0);
+		REQUIRE(buf.capacity() == 0);
+	}
+
+	SECTION("sized constructor") {
+		ring_buffer<int> buf(100);
+		REQUIRE(buf.empty());
+		REQUIRE(buf.capacity() == 100);
+	}
+}
+
+TEST_CASE("ring_buffer push and pop", "[ring_buffer]") {
+	constexpr int N = 8;
+	ring_buffer<std::string> buf(N);
+
+	// Cycle around the buffer a few times without it growing
+	int nxt = 0;
+	for (int i=0; i<5*N; ++i) {
+		buf.push_back(std::to_string(i));
+		if (buf.size() == N/2) {
+			REQUIRE(buf.front() == std::to_string(nxt++));
+			buf.pop_front();
+		}
+	}
+	REQUIRE(buf.capacity() == N);
+	REQUIRE(buf.back() == std::to_string(5*N-1));
+
+	// Now make it grow while wrapped
+	for (int i=5*N; i<7*N; ++i)
+		buf.emplace_back(std::to_string(i));
+	REQUIRE(buf.capacity() > N);
+
+	while (!buf.empty()) {
+		REQUIRE(buf.front() == std::to_string(nxt++));
+		buf.pop_front();
+	}
+	REQUIRE(nxt == 7*N);
+
+	buf.shrink_to_fit();
+	REQUIRE(buf.capacity() == 0);
+}
+
+TEST_CASE("ring_buffer move only", "[ring_buffer]") {
+	ring_buffer<std::unique_ptr<int>> buf;
+	for (int i=0; i<100; ++i)
+		buf.push_back(std::make_unique<int>(i));
+
+	ring_buffer<std::unique_ptr<int>> buf2(std::move(buf));
+	REQUIRE(buf.empty());
+	REQUIRE(buf2.size() == 100);
+	REQUIRE(*buf2.front() == 0);
+	REQUIRE(*buf2.back() == 99);
+}
+
+TEST_CASE("ring_buffer as thread_queue container", "[ring_buffer]") {
+	thread_queue<int, ring_buffer<int>> que;
+	que.reserve(64);
+
+	for (int i=0; i<10; ++i)
+		que.put(i);
+	for (int i=0; i<10; ++i)
+		REQUIRE(que.get() == i);
+}
@@ -0,0 +1,217 @@
+// test_simulation.cpp
+//
+// Test of the simulation executor in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/simulation.h"
+#include "catch2_version.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace std::chrono;
+using namespace cooper;
+
+TEST_CASE("sim queueing", "[simulation]") {
+	sim_executor sim;
+	auto& thr = sim.add_thread(fixed_cost(10ms));
+
+	std::vector<nanoseconds> t;
+	for (int i=0; i<3; ++i)
+		thr.post([&] { t.push_back(sim.elapsed()); });
+
+	sim.run();
+
+	// The tasks start back to back
+	REQUIRE(t == std::vector<nanoseconds>{ 0ms, 10ms, 20ms });
+	REQUIRE(sim.elapsed() == 30ms);
+
+	REQUIRE(thr.idle());
+	REQUIRE(thr.num_completed() == 3);
+	REQUIRE(thr.busy_time() == 30ms);
+	REQUIRE(thr.max_queue_size() == 2);
+	REQUIRE(thr.max_wait() == 20ms);
+	REQUIRE(thr.mean_wait() == 10ms);
+
+	// An explicit cost
+	thr.post(1s, [] {});
+	sim.run();
+	REQUIRE(sim.elapsed() == 1030ms);
+}
+
+TEST_CASE("sim message order", "[simulation]") {
+	sim_executor sim(3, interleave::random);
+	auto& thr = sim.add_thread(fixed_cost(1ms));
+	auto& other = sim.add_thread(fixed_cost(1ms));
+
+	// Messages from one sender stay in order, even with random
+	// interleaving of simultaneous events.
+	std::vector<int> v;
+	for (int i=0; i<100; ++i) {
+		thr.post([&v, i] { v.push_back(i); });
+		other.post([] {});
+	}
+	sim.run();
+
+	REQUIRE(v.size() == 100);
+	REQUIRE(std::is_sorted(v.begin(), v.end()));
+}
+
+TEST_CASE("sim timers", "[simulation]") {
+	sim_executor sim;
+
+	std::vector<nanoseconds> t;
+	sim.after(50ms, [&] { t.push_back(sim.elapsed()); });
+	auto id = sim.after(60ms, [&] { t.push_back(0ms); });
+	sim.cancel(id);
+	auto per = sim.every(20ms, [&] { t.push_back(sim.elapsed()); });
+
+	sim.run_for(70ms);
+	REQUIRE(sim.elapsed() == 70ms);
+	REQUIRE(t == std::vector<nanoseconds>{ 20ms, 40ms, 50ms, 60ms });
+
+	sim.cancel(per);
+	sim.run();
+	REQUIRE(t.size() == 4);
+}
+
+// Runs two threads that each log their tasks at the same times, and
+// returns the interleaving.
+static std::string interleaving(uint64_t seed, interleave policy)
+{
+	sim_executor sim(seed, policy);
+	auto& a = sim.add_thread(fixed_cost(1ms));
+	auto& b = sim.add_thread(fixed_cost(1ms));
+
+	std::string s;
+	for (int i=0; i<20; ++i) {
+		a.post([&s] { s += 'a'; });
+		b.post([&s] { s += 'b'; });
+	}
+	sim.run();
+	return s;
+}
+
+TEST_CASE("sim interleaving", "[simulation]") {
+	// In order, regardless of the seed
+	std::string ab;
+	for (int i=0; i<20; ++i)
+		ab += "ab";
+	REQUIRE(interleaving(1, interleave::fifo) == ab);
+	REQUIRE(interleaving(2, interleave::fifo) == ab);
+
+	// Reproducible with the same seed
+	auto s1 = interleaving(42, interleave::random);
+	REQUIRE(s1 == interleaving(42, interleave::random));
+	REQUIRE(s1.size() == 40);
+
+	// Different seeds explore different orders
+	bool diff = false;
+	for (uint64_t seed=0; seed<10 && !diff; ++seed)
+		diff = interleaving(seed, interleave::random) != s1;
+	REQUIRE(diff);
+}
+
+// --------------------------------------------------------------------------
+
+// A simulated actor that bounces a ball to another
+class player : public sim_actor
+{
+	player* other_ = nullptr;
+	std::vector<nanoseconds>& log_;
+
+public:
+	player(sim_thread& thr, std::vector<nanoseconds>& log)
+		: sim_actor(thr), log_(log) {}
+
+	void set_other(player* other) { other_ = other; }
+
+	void hit(int n) {
+		cast(5ms, [this, n] {
+			log_.push_back(executor().elapsed());
+			if (n > 1)
+				other_->hit(n-1);
+		});
+	}
+};
+
+TEST_CASE("sim actors", "[simulation]") {
+	sim_executor sim;
+	auto& t1 = sim.add_thread();
+	auto& t2 = sim.add_thread();
+
+	std::vector<nanoseconds> log;
+	player p1(t1, log), p2(t2, log);
+	p1.set_other(&p2);
+	p2.set_other(&p1);
+
+	p1.hit(4);
+	sim.run();
+
+	// Each hit arrives when the previous one is done
+	REQUIRE(log == std::vector<nanoseconds>{ 0ms, 5ms, 10ms, 15ms });
+	REQUIRE(sim.elapsed() == 20ms);
+}
+
+TEST_CASE("sim m/m/1", "[simulation]") {
+	constexpr int N = 100000;
+	sim_executor sim(7);
+	auto& thr = sim.add_thread(exponential_cost(800us));
+
+	// Poisson arrivals at 1000/sec, so the load is 0.8
+	std::exponential_distribution<double> gap(1.0 / 1e6);
+	nanoseconds t{0};
+	for (int i=0; i<N; ++i) {
+		t += nanoseconds(int64_t(gap(sim.rng())));
+		sim.at(sim_clock::time_point(t), [&thr] { thr.post([] {}); });
+	}
+	sim.run();
+
+	REQUIRE(thr.num_completed() == N);
+	double util = duration<double>(thr.busy_time()).count()
+					/ duration<double>(sim.elapsed()).count();
+	REQUIRE(util > 0.75);
+	REQUIRE(util < 0.85);
+
+	// Mean wait for M/M/1 is rho/(mu-lambda) = 0.8/(1250-1000) = 3.2ms
+	auto w = duration<double>(thr.mean_wait()).count();
+	REQUIRE(w > 0.0025);
+	REQUIRE(w < 0.0040);
+}
@@ -0,0 +1,164 @@
+// test_single_threaded.cpp
+//
+// Test of the single-threaded build of the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/actor.h"
+#include "cooper/timer.h"
+#include "cooper/execution.h"
+#include "catch2_version.h"
+#include <thread>
+#include <vector>
+#include <chrono>
+
+using namespace cooper;
+using namespace std::chrono;
+
+// A simple counter actor
+class counter : public actor
+{
+	int n_ = 0;
+
+public:
+	using actor::actor;
+
+	void inc() { cast([this] { ++n_; }); }
+	int get() { return call([this] { return n_; }); }
+	int get_self() { return call([this] { return get(); }); }
+	int get_from(counter& other) {
+		return call([&other] { return other.get(); });
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("single threaded actor", "[single_threaded]") {
+	work_thread thr;
+	counter act(thr);
+
+	REQUIRE(thr.get_id() == std::this_thread::get_id());
+
+	for (int i=0; i<10; ++i)
+		act.inc();
+	REQUIRE(thr.queue_size() == 10);
+
+	REQUIRE(act.get() == 10);
+	REQUIRE(thr.idle());
+}
+
+TEST_CASE("single threaded nested call", "[single_threaded]") {
+	work_thread thr1, thr2;
+	counter act1(thr1), act2(thr2);
+
+	act2.inc();
+	REQUIRE(act1.get_from(act2) == 1);
+
+	// A call back into the same thread can never complete
+	REQUIRE_THROWS_AS(act1.get_self(), would_block);
+}
+
+TEST_CASE("single threaded full queue", "[single_threaded]") {
+	work_thread thr;
+	thr.queue_capacity(4);
+
+	int n = 0;
+	for (int i=0; i<100; ++i)
+		thr.cast([&n] { ++n; });
+	REQUIRE(thr.queue_size() <= 4);
+
+	thr.flush();
+	REQUIRE(n == 100);
+}
+
+TEST_CASE("single threaded shutdown", "[single_threaded]") {
+	std::vector<int> order;
+	{
+		work_thread thr;
+		thr.cast([&order] { order.push_back(1); });
+		thr.close();
+		thr.finalize([&order] { order.push_back(2); });
+		REQUIRE(order.empty());
+	}
+	REQUIRE(order == std::vector<int>{ 1, 2 });
+}
+
+TEST_CASE("single threaded work threads", "[single_threaded]") {
+	work_threads thrs(4);
+	int n = 0;
+
+	// Each task hops across the threads, one at a time
+	std::function<void(int)> hop = [&](int i) {
+		++n;
+		if (i > 0)
+			thrs.next_thread().cast([&hop, i] { hop(i-1); });
+	};
+	thrs[0].cast([&hop] { hop(99); });
+
+	REQUIRE(!thrs.quiescent());
+	thrs.wait_quiescent();
+	REQUIRE(n == 100);
+}
+
+TEST_CASE("single threaded timer", "[single_threaded]") {
+	work_thread thr;
+	int nTick = 0, nShot = 0;
+
+	periodic_timer tmr([&] {
+		if (++nTick == 3)
+			tmr.stop();
+	});
+	one_shot shot([&] { ++nShot; });
+
+	tmr.start(5ms);
+	shot.start(10ms);
+
+	auto start = steady_clock::now();
+	event_loop::instance().run();
+
+	REQUIRE(nTick == 3);
+	REQUIRE(nShot == 1);
+	REQUIRE(steady_clock::now() - start >= 15ms);
+}
+
+TEST_CASE("single threaded sync wait", "[single_threaded]") {
+	work_thread thr;
+	auto res = sync_wait(schedule(thr) | then([] { return 42; }));
+	REQUIRE(res == 42);
+}
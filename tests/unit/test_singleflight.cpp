@@ -0,0 +1,169 @@
+// test_singleflight.cpp
+//
+// Test of the singleflight class in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/singleflight.h"
+#include "cooper/actor.h"
+#include "catch2_version.h"
+#include <future>
+#include <thread>
+#include <vector>
+#include <string>
+
+using namespace cooper;
+
+// Blocks a work thread until the returned promise is set.
+static std::promise<void> block(work_thread& thr) {
+	std::promise<void> gate, busy;
+	auto busyFut = busy.get_future();
+	thr.cast([fut=gate.get_future().share(), busy=std::move(busy)]() mutable {
+		busy.set_value();
+		fut.wait();
+	});
+	busyFut.wait();
+	return gate;
+}
+
+// An actor that loads values, deduplicating the concurrent requests
+class loader : public actor
+{
+	singleflight<std::string, std::string> loads_;
+	int nLoad_ = 0;
+
+public:
+	loader() : loads_(get_thread()) {}
+	explicit loader(work_thread& thr) : actor(thr), loads_(thr) {}
+
+	std::string get(const std::string& key) {
+		return loads_.call(key, [this, key] {
+			++nLoad_;
+			return key + "!";
+		});
+	}
+	int num_loads() { return call([this] { return nLoad_; }); }
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("singleflight dedup", "[singleflight]") {
+	constexpr int N = 10;
+	work_thread thr;
+	singleflight<int, int> sf(thr);
+	int nRun = 0;
+
+	auto gate = block(thr);
+
+	std::vector<std::shared_future<int>> futs;
+	for (int i=0; i<N; ++i)
+		futs.push_back(sf.submit(1, [&nRun] { ++nRun; return 42; }));
+	futs.push_back(sf.submit(2, [&nRun] { ++nRun; return 43; }));
+
+	REQUIRE(sf.in_flight() == 2);
+	REQUIRE(sf.num_shared() == N-1);
+
+	gate.set_value();
+	for (int i=0; i<N; ++i)
+		REQUIRE(futs[i].get() == 42);
+	REQUIRE(futs[N].get() == 43);
+
+	REQUIRE(nRun == 2);
+	REQUIRE(sf.num_executed() == 2);
+	REQUIRE(sf.in_flight() == 0);
+
+	// Once it has landed, the next request runs again
+	REQUIRE(sf.call(1, [&nRun] { ++nRun; return 44; }) == 44);
+	REQUIRE(nRun == 3);
+}
+
+TEST_CASE("singleflight error", "[singleflight]") {
+	work_thread thr;
+	singleflight<int, void> sf(thr);
+
+	auto gate = block(thr);
+	auto fut1 = sf.submit(1, [] { throw std::runtime_error("oops"); });
+	auto fut2 = sf.submit(1, [] {});
+	gate.set_value();
+
+	REQUIRE_THROWS_AS(fut1.get(), std::runtime_error);
+	REQUIRE_THROWS_AS(fut2.get(), std::runtime_error);
+	REQUIRE(sf.num_executed() == 1);
+}
+
+TEST_CASE("singleflight discard", "[singleflight]") {
+	work_thread thr;
+	singleflight<int, int> sf(thr);
+
+	auto gate = block(thr);
+	auto fut = sf.submit(1, [] { return 1; });
+	REQUIRE(sf.in_flight() == 1);
+
+	thr.discard();
+	REQUIRE(sf.in_flight() == 0);
+	REQUIRE_THROWS_AS(fut.get(), std::future_error);
+
+	gate.set_value();
+	REQUIRE(sf.call(1, [] { return 2; }) == 2);
+}
+
+TEST_CASE("singleflight actor", "[singleflight]") {
+	constexpr int NTHR = 8;
+	work_thread thr;
+	loader act(thr);
+
+	auto gate = block(thr);
+
+	std::vector<std::future<std::string>> futs;
+	for (int i=0; i<NTHR; ++i)
+		futs.push_back(std::async(std::launch::async, [&act] { return act.get("key"); }));
+
+	// Let all the clients queue up before the loader runs
+	while (thr.queue_size() == 0)
+		std::this_thread::yield();
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	gate.set_value();
+
+	for (auto& fut : futs)
+		REQUIRE(fut.get() == "key!");
+
+	// Some late clients might have started another load, but not many
+	REQUIRE(act.num_loads() >= 1);
+	REQUIRE(act.num_loads() < NTHR);
+}
@@ -0,0 +1,175 @@
+// test_stealing_pool.cpp
+//
+// Unit tests for the cooper 'stealing_pool' class.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/stealing_pool.h"
+#include "catch2_version.h"
+#include <atomic>
+#include <vector>
+#include <set>
+
+using namespace cooper;
+
+static stealing_options test_opts() {
+	stealing_options opts;
+	opts.pin = false;
+	return opts;
+}
+
+// Recursively splits a range of numbers, summing it up in the leaves.
+static void sum_range(stealing_pool& pool, uint64_t lo, uint64_t hi,
+					  std::atomic<uint64_t>& sum) {
+	if (hi - lo <= 16) {
+		uint64_t s = 0;
+		for (auto i=lo; i<hi; ++i)
+			s += i;
+		sum += s;
+		return;
+	}
+	auto mid = lo + (hi - lo) / 2;
+	pool.post([&pool, lo, mid, &sum] { sum_range(pool, lo, mid, sum); });
+	pool.post([&pool, mid, hi, &sum] { sum_range(pool, mid, hi, sum); });
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("cpu_topology", "[stealing_pool]") {
+	auto topo = cpu_topology::uniform(2, 2, 2);
+	REQUIRE(topo.size() == 8);
+	REQUIRE(topo.num_nodes() == 2);
+
+	REQUIRE(topo[0].node == 0);
+	REQUIRE(topo[0].complex == 0);
+	REQUIRE(topo[3].node == 0);
+	REQUIRE(topo[3].complex == 1);
+	REQUIRE(topo[5].node == 1);
+	REQUIRE(topo[5].complex == 2);
+	REQUIRE(topo[7].cpu == 7);
+
+	auto sys = cpu_topology::detect();
+	REQUIRE(sys.size() > 0);
+	REQUIRE(sys.num_nodes() > 0);
+}
+
+TEST_CASE("stealing_pool steal order", "[stealing_pool]") {
+	stealing_pool pool(cpu_topology::uniform(2, 2, 2), test_opts());
+	REQUIRE(pool.size() == 8);
+
+	// Same complex, then same node, then the other node
+	const auto& v = pool.steal_order(0);
+	REQUIRE(v == std::vector<size_t>{ 1, 2, 3, 4, 5, 6, 7 });
+
+	const auto& w = pool.steal_order(6);
+	REQUIRE(w.size() == 7);
+	REQUIRE(w[0] == 7);
+	REQUIRE(std::set<size_t>(w.begin()+1, w.begin()+3) == std::set<size_t>{ 4, 5 });
+	REQUIRE(std::set<size_t>(w.begin()+3, w.end()) == std::set<size_t>{ 0, 1, 2, 3 });
+}
+
+TEST_CASE("stealing_pool runs all tasks", "[stealing_pool]") {
+	stealing_pool pool(cpu_topology::uniform(2, 2, 2), test_opts());
+
+	std::atomic<int> n { 0 };
+	for (int i=0; i<1000; ++i)
+		pool.post([&n] { ++n; });
+
+	pool.wait();
+	REQUIRE(n == 1000);
+	REQUIRE(pool.num_pending() == 0);
+
+	// Every task was counted once, somewhere
+	uint64_t total = pool.num_local() + pool.num_injected()
+		+ pool.num_steals(steal_level::complex)
+		+ pool.num_steals(steal_level::node)
+		+ pool.num_steals(steal_level::remote);
+	REQUIRE(total == 1000);
+}
+
+TEST_CASE("stealing_pool nested tasks", "[stealing_pool]") {
+	stealing_pool pool(cpu_topology::uniform(2, 2, 2), test_opts());
+
+	constexpr uint64_t N = 100000;
+	std::atomic<uint64_t> sum { 0 };
+
+	pool.post([&pool, &sum] { sum_range(pool, 0, N, sum); });
+	pool.wait();
+
+	REQUIRE(sum == N*(N-1)/2);
+
+	// Tasks posted by the workers go on their own deques
+	REQUIRE(pool.num_local() > 0);
+}
+
+TEST_CASE("stealing_pool submit", "[stealing_pool]") {
+	stealing_pool pool(cpu_topology::uniform(1, 1, 2), test_opts());
+
+	auto fut = pool.submit([] { return 42; });
+	REQUIRE(fut.get() == 42);
+
+	auto bad = pool.submit([]() -> int { throw std::runtime_error("bad"); });
+	REQUIRE_THROWS_AS(bad.get(), std::runtime_error);
+}
+
+TEST_CASE("stealing_pool post to node", "[stealing_pool]") {
+	stealing_pool pool(cpu_topology::uniform(2, 1, 1), test_opts());
+
+	std::atomic<int> n { 0 };
+	for (int i=0; i<100; ++i)
+		pool.post_to_node(1, [&n] { ++n; });
+	pool.wait();
+
+	REQUIRE(n == 100);
+	REQUIRE(pool.num_local() == 0);
+	REQUIRE(pool.num_injected() + pool.num_steals(steal_level::remote) == 100);
+}
+
+TEST_CASE("stealing_pool drains on destruction", "[stealing_pool]") {
+	std::atomic<int> n { 0 };
+	{
+		stealing_pool pool(cpu_topology::uniform(1, 2, 1), test_opts());
+		for (int i=0; i<100; ++i) {
+			pool.post([&pool, &n] {
+				pool.post([&n] { ++n; });
+			});
+		}
+	}
+	REQUIRE(n == 100);
+}
@@ -0,0 +1,295 @@
+// test_stream.cpp
+//
+// Unit tests for the cooper 'stream' class.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/stream.h"
+#include "cooper/actor.h"
+#include "catch2_version.h"
+#include <stdexcept>
+#include <future>
+#include <vector>
+#include <map>
+
+using namespace cooper;
+
+// A generator that counts up to n, keeping track of how many it produced
+struct counter {
+	int i = 0, n;
+	std::shared_ptr<std::atomic<int>> nProduced;
+
+	explicit counter(int n) : n(n), nProduced(std::make_shared<std::atomic<int>>(0)) {}
+
+	std::optional<int> operator()() {
+		if (i == n)
+			return std::nullopt;
+		++*nProduced;
+		return i++;
+	}
+};
+
+// An actor that holds a map and can stream its contents
+class table : public actor
+{
+	std::map<int, int> tbl_;
+
+public:
+	explicit table(work_thread& thr) : actor(thr) {}
+
+	void put(int k, int v) { cast([this, k, v] { tbl_[k] = v; }); }
+
+	stream<std::pair<int,int>> scan(const stream_options& opts) {
+		return call_stream([this, after=std::optional<int>{}]() mutable
+				-> std::optional<std::pair<int,int>> {
+			auto p = after ? tbl_.upper_bound(*after) : tbl_.begin();
+			if (p == tbl_.end())
+				return std::nullopt;
+			after = p->first;
+			return *p;
+		}, opts);
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("stream reads all items", "[stream]") {
+	work_thread thr;
+	auto strm = make_stream(thr, counter(100));
+
+	int val, expected = 0;
+	while (strm.next(&val))
+		REQUIRE(val == expected++);
+
+	REQUIRE(expected == 100);
+	REQUIRE(strm.done());
+	REQUIRE(!strm.next(&val));
+}
+
+TEST_CASE("stream range for", "[stream]") {
+	work_thread thr;
+
+	std::vector<int> v;
+	for (int i : make_stream(thr, counter(10)))
+		v.push_back(i);
+
+	REQUIRE(v == std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+
+	SECTION("empty") {
+		int n = 0;
+		for ([[maybe_unused]] int i : make_stream(thr, counter(0)))
+			++n;
+		REQUIRE(n == 0);
+	}
+}
+
+TEST_CASE("stream flow control", "[stream]") {
+	work_thread thr;
+
+	stream_options opts;
+	opts.window = 8;
+	opts.batch = 4;
+
+	counter gen(1000);
+	auto nProduced = gen.nProduced;
+	auto strm = make_stream(thr, gen, opts);
+
+	// The producer stops once it fills the window
+	thr.flush();
+	thr.flush();
+	REQUIRE(*nProduced == 8);
+	REQUIRE(strm.buffered() == 8);
+
+	// Taking less than half the window doesn't wake it
+	int val;
+	for (int i=0; i<3; ++i)
+		REQUIRE(strm.next(&val));
+	thr.flush();
+	REQUIRE(*nProduced == 8);
+
+	// ...but taking half of it does
+	REQUIRE(strm.next(&val));
+	thr.flush();
+	thr.flush();
+	REQUIRE(*nProduced == 12);
+
+	// It never gets more than a window ahead of the reader
+	int nRead = 4;
+	while (strm.next(&val)) {
+		++nRead;
+		REQUIRE(*nProduced - nRead <= 8);
+	}
+	REQUIRE(nRead == 1000);
+}
+
+TEST_CASE("stream interleaves messages", "[stream]") {
+	work_thread thr;
+
+	stream_options opts;
+	opts.window = 1000;
+	opts.batch = 10;
+
+	counter gen(1000);
+	auto nProduced = gen.nProduced;
+
+	// Hold the thread so the first batch and the call queue up together
+	std::promise<void> gate;
+	thr.cast([fut=gate.get_future().share()] { fut.wait(); });
+
+	auto strm = make_stream(thr, gen, opts);
+	auto fut = thr.submit([nProduced] { return int(*nProduced); });
+	gate.set_value();
+
+	// The call ran after the first batch, not the whole stream
+	REQUIRE(fut.get() == 10);
+
+	int n = 0;
+	for ([[maybe_unused]] int i : strm)
+		++n;
+	REQUIRE(n == 1000);
+}
+
+TEST_CASE("stream producer error", "[stream]") {
+	work_thread thr;
+
+	int i = 0;
+	auto strm = make_stream(thr, [i]() mutable -> std::optional<int> {
+		if (i == 3)
+			throw std::runtime_error("bad");
+		return i++;
+	});
+
+	int val;
+	for (int j=0; j<3; ++j) {
+		REQUIRE(strm.next(&val));
+		REQUIRE(val == j);
+	}
+	REQUIRE_THROWS_AS(strm.next(&val), std::runtime_error);
+}
+
+TEST_CASE("stream cancel", "[stream]") {
+	work_thread thr;
+
+	stream_options opts;
+	opts.window = 4;
+	opts.batch = 4;
+
+	counter gen(1000);
+	auto nProduced = gen.nProduced;
+
+	{
+		auto strm = make_stream(thr, gen, opts);
+		int val;
+		REQUIRE(strm.next(&val));
+		REQUIRE(val == 0);
+	}
+
+	// Dropping the stream stops the producer
+	thr.flush();
+	thr.flush();
+	REQUIRE(*nProduced <= 8);
+
+	SECTION("explicit") {
+		auto strm = make_stream(thr, counter(10), opts);
+		strm.cancel();
+		int val;
+		REQUIRE(!strm.next(&val));
+		REQUIRE(strm.done());
+	}
+}
+
+TEST_CASE("stream discarded", "[stream]") {
+	work_thread thr;
+
+	// Hold the thread, so the producer is still queued
+	std::promise<void> gate, busy;
+	thr.cast([fut=gate.get_future().share(), &busy] {
+		busy.set_value();
+		fut.wait();
+	});
+	busy.get_future().wait();
+
+	auto strm = make_stream(thr, counter(10));
+
+	thr.close();
+	REQUIRE(thr.discard() == 1);
+	gate.set_value();
+
+	int val;
+	REQUIRE_THROWS_AS(strm.next(&val), queue_closed);
+	REQUIRE(strm.done());
+
+	SECTION("closed") {
+		auto strm2 = make_stream(thr, counter(10));
+		REQUIRE_THROWS_AS(strm2.next(&val), queue_closed);
+	}
+}
+
+TEST_CASE("stream default", "[stream]") {
+	stream<int> strm;
+	int val;
+	REQUIRE(!strm.next(&val));
+	REQUIRE(!strm.try_next(&val));
+	REQUIRE(strm.done());
+	REQUIRE(strm.buffered() == 0);
+}
+
+TEST_CASE("stream from actor", "[stream]") {
+	work_thread thr;
+	table tbl(thr);
+
+	for (int i=0; i<50; ++i)
+		tbl.put(i, i*i);
+
+	stream_options opts;
+	opts.window = 4;
+	opts.batch = 2;
+
+	auto strm = tbl.scan(opts);
+
+	// Entries added ahead of the scan position are seen
+	tbl.put(100, 10000);
+
+	int n = 0;
+	for (auto [k, v] : strm) {
+		REQUIRE(v == k*k);
+		++n;
+	}
+	REQUIRE(n == 51);
+}
@@ -0,0 +1,194 @@
+// test_task_graph.cpp
+//
+// Test of the task_graph class in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/task_graph.h"
+#include "catch2_version.h"
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <future>
+
+using namespace cooper;
+
+/////////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("task graph diamond", "[task_graph]") {
+	work_threads thrs(4);
+	task_graph g;
+	int a = 0, b = 0, c = 0, d = 0;
+
+	auto na = g.add([&] { a = 1; });
+	auto nb = g.add([&] { b = a + 1; }, { na });
+	auto nc = g.add([&] { c = a + 2; }, { na });
+	g.add([&] { d = b + c; }, { nb, nc });
+
+	REQUIRE(g.size() == 4);
+	g.run(thrs);
+	REQUIRE(d == 5);
+
+	// It can be run again
+	a = b = c = d = 0;
+	g.run(thrs);
+	REQUIRE(d == 5);
+	REQUIRE(!g.running());
+}
+
+TEST_CASE("task graph reuse", "[task_graph]") {
+	constexpr int N = 8;
+	constexpr int NRUN = 100;
+	work_threads thrs(4);
+	task_graph g;
+
+	std::vector<int> vals(N);
+	int sum = 0;
+
+	std::vector<task_graph::node_id> ids;
+	for (int i=0; i<N; ++i)
+		ids.push_back(g.add([&vals, i] { vals[i] += i; }));
+	g.add([&] { for (auto v : vals) sum += v; }, ids);
+
+	for (int i=0; i<NRUN; ++i) {
+		sum = 0;
+		g.run(thrs);
+	}
+	REQUIRE(sum == NRUN*N*(N-1)/2);
+}
+
+TEST_CASE("task graph locality", "[task_graph]") {
+	work_threads thrs(4);
+	task_graph g;
+
+	std::thread::id ids[4];
+	auto n0 = g.add([&] { ids[0] = std::this_thread::get_id(); });
+	auto n1 = g.add([&] { ids[1] = std::this_thread::get_id(); }, { n0 });
+	auto n2 = g.add([&] { ids[2] = std::this_thread::get_id(); });
+	auto n3 = g.add([&] { ids[3] = std::this_thread::get_id(); }, { n1, n2 });
+
+	SECTION("chain follows its producer") {
+		g.run(thrs);
+		REQUIRE(ids[1] == ids[0]);
+		REQUIRE(g.ran_on(n1) == g.ran_on(n0));
+	}
+
+	SECTION("pinned and near") {
+		g.run_on(n0, 1).run_on(n2, 2).run_near(n3, n2);
+		g.run(thrs);
+		REQUIRE(ids[0] == thrs[1].get_id());
+		REQUIRE(ids[1] == thrs[1].get_id());
+		REQUIRE(ids[3] == thrs[2].get_id());
+		REQUIRE(g.ran_on(n3) == 2);
+	}
+
+	REQUIRE_THROWS_AS(g.run_near(n3, n0), std::invalid_argument);
+	REQUIRE_THROWS_AS(g.add([]{}, { 99 }), std::out_of_range);
+}
+
+TEST_CASE("task graph error", "[task_graph]") {
+	work_threads thrs(2);
+	task_graph g;
+	std::atomic<bool> ran { false };
+
+	auto n0 = g.add([] { throw std::runtime_error("oops"); });
+	g.add([&] { ran = true; }, { n0 });
+
+	REQUIRE_THROWS_AS(g.run(thrs), std::runtime_error);
+	REQUIRE(!ran);
+	REQUIRE(!g.running());
+}
+
+TEST_CASE("task graph async", "[task_graph]") {
+	work_threads thrs(2);
+	task_graph g;
+	std::promise<void> gate;
+	auto fut = gate.get_future().share();
+
+	g.add([fut] { fut.wait(); });
+	g.start(thrs);
+
+	REQUIRE(g.running());
+	REQUIRE_THROWS_AS(g.start(thrs), std::logic_error);
+	REQUIRE_THROWS_AS(g.add([]{}), std::logic_error);
+
+	gate.set_value();
+	g.wait();
+	REQUIRE(!g.running());
+}
+
+TEST_CASE("task graph discarded", "[task_graph]") {
+	work_threads thrs(1);
+	task_graph g;
+	std::atomic<bool> ran { false };
+
+	auto n0 = g.add([&] { ran = true; });
+	g.add([&] { ran = true; }, { n0 });
+
+	// Hold the thread, so the first node is still queued
+	std::promise<void> gate, busy;
+	thrs[0].cast([fut=gate.get_future().share(), &busy] {
+		busy.set_value();
+		fut.wait();
+	});
+	busy.get_future().wait();
+	g.start(thrs);
+
+	thrs[0].close();
+	REQUIRE(thrs[0].discard() == 1);
+	gate.set_value();
+
+	REQUIRE_THROWS_AS(g.wait(), queue_closed);
+	REQUIRE(!ran);
+	REQUIRE(!g.running());
+}
+
+TEST_CASE("task graph long chain on closed threads", "[task_graph]") {
+	constexpr size_t N = 100000;
+	work_threads thrs(2);
+	task_graph g;
+
+	auto id = g.add([]{});
+	for (size_t i=1; i<N; ++i)
+		id = g.add([]{}, { id });
+
+	thrs.close();
+	REQUIRE_THROWS_AS(g.run(thrs), queue_closed);
+	REQUIRE(!g.running());
+}
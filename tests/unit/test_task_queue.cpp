@@ -42,6 +42,8 @@
 
 #include "cooper/task_queue.h"
 #include "catch2_version.h"
+#include <vector>
+#include <atomic>
 
 using namespace std::chrono;
 using namespace cooper;
@@ -189,3 +191,149 @@ TEST_CASE("task_queue get", "[task_queue]") {
 	}
 }
 
+
+TEST_CASE("task_queue close", "[task_queue]") {
+	constexpr auto TIMEOUT = 10ms;
+	constexpr size_t N = 3;
+
+	task_queue<int> que(N);
+	for (size_t i=1; i<N; ++i)
+		que.put(int(i));
+
+	REQUIRE(!que.closed());
+	que.close();
+	REQUIRE(que.closed());
+
+	SECTION("put") {
+		REQUIRE_THROWS_AS(que.put(42), queue_closed);
+		REQUIRE(!que.try_put(42));
+		REQUIRE(!que.try_put_for(42, TIMEOUT));
+		REQUIRE(que.size() == N-1);
+	}
+
+	SECTION("drain") {
+		int val;
+		REQUIRE(que.get() == 1);
+		REQUIRE(que.try_get(&val));
+		REQUIRE(val == 2);
+
+		REQUIRE(!que.try_get(&val));
+		REQUIRE(!que.try_get_for(&val, TIMEOUT));
+		REQUIRE_THROWS_AS(que.get(), queue_closed);
+	}
+
+	SECTION("clear") {
+		REQUIRE(que.clear() == N-1);
+		REQUIRE(que.empty());
+		REQUIRE(que.num_tasks() == 0);
+	}
+}
+
+TEST_CASE("task_queue close wakes waiters", "[task_queue]") {
+	task_queue<int> que;
+
+	std::thread thr([&que] { que.close(); });
+	REQUIRE_THROWS_AS(que.get(), queue_closed);
+	thr.join();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Lock-free variant
+
+TEST_CASE("lock-free task_queue put and get", "[task_queue]") {
+	constexpr auto TIMEOUT = 10ms;
+	constexpr size_t N = 4;
+
+	task_queue<int, mpmc_ring<int>> que(N);
+	REQUIRE(que.empty());
+	REQUIRE(que.capacity() == N);
+
+	for (size_t i=1; i<=N; ++i)
+		REQUIRE(que.try_put(int(i)));
+
+	REQUIRE(que.size() == N);
+	REQUIRE(que.num_tasks() == N);
+	REQUIRE(!que.try_put(int(N+1)));
+	REQUIRE(!que.try_put_for(int(N+1), TIMEOUT));
+	REQUIRE(que.num_tasks() == N);
+
+	int val;
+	REQUIRE(que.get() == 1);
+	REQUIRE(que.try_get(&val));
+	REQUIRE(val == 2);
+	REQUIRE(que.try_get_for(&val, TIMEOUT));
+	REQUIRE(val == 3);
+	REQUIRE(que.try_get_until(&val, system_clock::now() + TIMEOUT));
+	REQUIRE(val == 4);
+
+	REQUIRE(que.empty());
+	REQUIRE(!que.try_get_for(&val, TIMEOUT));
+	REQUIRE(que.num_tasks() == N);
+
+	for (size_t i=0; i<N; ++i)
+		que.task_done();
+	REQUIRE(que.num_tasks() == 0);
+	que.wait();
+}
+
+TEST_CASE("lock-free task_queue close", "[task_queue]") {
+	task_queue<int, mpmc_ring<int>> que(4);
+	que.put(1);
+	que.put(2);
+	que.close();
+
+	REQUIRE_THROWS_AS(que.put(42), queue_closed);
+	REQUIRE(!que.try_put(42));
+	REQUIRE(que.get() == 1);
+	REQUIRE(que.clear() == 1);
+	REQUIRE(que.num_tasks() == 1);
+	REQUIRE_THROWS_AS(que.get(), queue_closed);
+
+	task_queue<int, mpmc_ring<int>> que2;
+	std::thread thr([&que2] { que2.close(); });
+	REQUIRE_THROWS_AS(que2.get(), queue_closed);
+	thr.join();
+}
+
+TEST_CASE("lock-free task_queue multiple producers and consumers", "[task_queue]") {
+	constexpr int N_THR = 4;
+	constexpr int N = 10000;
+
+	// A small queue, so that both sides have to block
+	task_queue<int, mpmc_ring<int>> que(8);
+	std::atomic<long> sum{0};
+	std::atomic<int> nGot{0};
+
+	std::vector<std::thread> thrs;
+	for (int i=0; i<N_THR; ++i) {
+		thrs.emplace_back([&] {
+			try {
+				while (true) {
+					sum += que.get();
+					++nGot;
+					que.task_done();
+				}
+			}
+			catch (const queue_closed&) {}
+		});
+	}
+	for (int i=0; i<N_THR; ++i) {
+		thrs.emplace_back([&que] {
+			for (int j=1; j<=N; ++j)
+				que.put(j);
+		});
+	}
+
+	for (int i=N_THR; i<2*N_THR; ++i)
+		thrs[i].join();
+
+	que.wait();
+	que.close();
+
+	for (int i=0; i<N_THR; ++i)
+		thrs[i].join();
+
+	REQUIRE(nGot == N_THR*N);
+	REQUIRE(sum == long(N_THR) * N * (N+1) / 2);
+	REQUIRE(que.num_tasks() == 0);
+}
@@ -0,0 +1,211 @@
+// test_typed_actor.cpp
+//
+// Test of the typed_actor class in the cooper library.
+//
+// This file is part of the "cooper" C++ actor library.
+//
+
+/****************************************************************************
+ * BSD 3-Clause License
+ *
+ * Copyright (c) 2026, Frank Pagliughi
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************/
+
+#include "cooper/typed_actor.h"
+#include "catch2_version.h"
+#include <future>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+
+using namespace cooper;
+
+// The messages for the actor
+struct add {
+	int val;
+	add(int v) : val(v) {}
+};
+struct append {
+	std::string s;
+	append(std::string s) : s(std::move(s)) {}
+};
+struct get { std::promise<std::pair<int,std::string>>* res; };
+
+// An actor with a typed protocol
+class accum : public typed_actor<accum, add, append, get>
+{
+	int sum_ = 0;
+	std::string str_;
+	std::vector<char> order_;
+
+	friend typed_actor;
+
+	void handle(add& msg) { sum_ += msg.val; order_.push_back('a'); }
+	void handle(append& msg) { str_ += std::move(msg.s); order_.push_back('s'); }
+	void handle(get& msg) { msg.res->set_value({ sum_, str_ }); }
+
+public:
+	using typed_actor::typed_actor;
+	~accum() { stop(); }
+
+	std::pair<int,std::string> value() {
+		std::promise<std::pair<int,std::string>> res;
+		send(get{ &res });
+		return res.get_future().get();
+	}
+
+	std::vector<char> order() { return call([this] { return order_; }); }
+};
+
+TEST_CASE("typed actor", "[typed_actor]") {
+	work_thread thr;
+	accum act(thr);
+
+	act.send(add{ 1 });
+	act.send(append{ "ab" });
+	act.emplace<add>(2);
+	act.emplace<append>("cd");
+
+	auto [sum, str] = act.value();
+	REQUIRE(sum == 3);
+	REQUIRE(str == "abcd");
+	REQUIRE(act.order() == std::vector<char>{ 'a', 's', 'a', 's' });
+}
+
+TEST_CASE("typed actor many", "[typed_actor]") {
+	constexpr int N = 10000;
+	work_thread thr;
+	accum act(thr);
+	act.reserve(64);
+
+	for (int i=1; i<=N; ++i)
+		act.send(add{ i });
+
+	REQUIRE(act.value().first == N*(N+1)/2);
+}
+
+TEST_CASE("typed actor from many threads", "[typed_actor]") {
+	constexpr int N = 1000;
+	constexpr int NTHR = 4;
+	work_thread thr;
+	accum act(thr);
+
+	std::vector<std::thread> thrs;
+	for (int i=0; i<NTHR; ++i)
+		thrs.emplace_back([&act] {
+			for (int j=0; j<N; ++j)
+				act.send(add{ 1 });
+		});
+	for (auto& t : thrs)
+		t.join();
+
+	REQUIRE(act.value().first == N*NTHR);
+}
+
+TEST_CASE("typed actor destroy with pending", "[typed_actor]") {
+	work_thread thr;
+
+	// Hold the thread so the messages stay queued
+	std::promise<void> go;
+	auto fut = go.get_future().share();
+	thr.cast([fut] { fut.wait(); });
+
+	{
+		auto act = make_actor<accum>(thr);
+		for (int i=0; i<100; ++i)
+			act->send(add{ i });
+	}
+	{
+		accum act(thr);
+		act.send(add{ 1 });
+	}
+
+	// The stale drain tasks find the actors gone and do nothing
+	go.set_value();
+	REQUIRE(thr.call([] { return true; }));
+}
+
+// Messages for an actor whose handlers can fail, or destroy the actor
+struct fail {};
+struct count {};
+struct die {};
+
+class fragile : public typed_actor<fragile, fail, count, die>
+{
+	std::atomic<int>* n_;
+	std::string name_ = "fragile";
+
+	friend typed_actor;
+
+	void handle(fail&) { throw std::runtime_error("handler failed"); }
+	void handle(count&) { ++*n_; }
+	void handle(die&) { delete this; }
+
+public:
+	fragile(work_thread& thr, std::atomic<int>* n) : typed_actor(thr), n_(n) {}
+	~fragile() { stop(); name_.clear(); }
+};
+
+TEST_CASE("typed actor handler throws", "[typed_actor]") {
+	work_thread thr;
+	std::atomic<int> n{0};
+	fragile act(thr, &n);
+
+	act.send(count{});
+	act.send(fail{});
+	act.send(count{});
+	thr.flush();
+
+	// The actor isn't stalled by the failure
+	act.send(count{});
+	thr.flush();
+	REQUIRE(n == 3);
+}
+
+TEST_CASE("typed actor deletes itself", "[typed_actor]") {
+	work_thread thr;
+	std::atomic<int> n{0};
+
+	// Hold the thread so that everything lands in one batch
+	std::promise<void> go;
+	thr.cast([fut=go.get_future().share()] { fut.wait(); });
+
+	auto act = new fragile(thr, &n);
+	act->send(count{});
+	act->send(die{});
+	act->send(count{});
+	go.set_value();
+	thr.flush();
+
+	REQUIRE(n == 1);
+}
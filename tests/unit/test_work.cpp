@@ -73,3 +73,138 @@ TEST_CASE("work_thread constructors", "[work_thread]") {
 	REQUIRE(true);
 }
 
+
+// Bounces a task from one thread to the next, N times.
+static void bounce(cooper::work_threads& thrs, size_t i, int n,
+				   std::atomic<int>& count) {
+	++count;
+	if (n > 1) {
+		auto j = (i+1) % thrs.size();
+		thrs[j].cast([&thrs, j, n, &count] { bounce(thrs, j, n-1, count); });
+	}
+}
+
+TEST_CASE("work_threads flush", "[work_threads]") {
+	cooper::work_threads thrs(4);
+	std::atomic<int> count{0};
+
+	for (size_t i=0; i<thrs.size(); ++i)
+		thrs[i].cast([&count] { ++count; });
+
+	thrs.flush();
+	REQUIRE(count == 4);
+}
+
+TEST_CASE("work_threads quiescence", "[work_threads]") {
+	constexpr int N = 1000;
+
+	cooper::work_threads thrs(4);
+	REQUIRE(thrs.quiescent());
+
+	std::atomic<int> count{0};
+	thrs[0].cast([&] { bounce(thrs, 0, N, count); });
+	thrs.wait_quiescent();
+
+	REQUIRE(thrs.quiescent());
+	REQUIRE(count == N);
+
+	SECTION("timeout") {
+		thrs[1].cast([] { std::this_thread::sleep_for(std::chrono::milliseconds(50)); });
+		REQUIRE(!thrs.try_wait_quiescent_for(std::chrono::milliseconds(1)));
+		REQUIRE(thrs.try_wait_quiescent_for(std::chrono::seconds(5)));
+	}
+}
+
+TEST_CASE("work_thread shutdown", "[work_thread]") {
+	using namespace std::chrono;
+	constexpr int N = 10;
+
+	cooper::work_thread thr;
+	std::atomic<int> count{0};
+
+	auto slow = [&count] {
+		std::this_thread::sleep_for(milliseconds(5));
+		++count;
+	};
+
+	for (int i=0; i<N; ++i)
+		thr.cast(slow);
+
+	SECTION("drain") {
+		thr.shutdown(cooper::shutdown_mode::drain);
+		REQUIRE(count == N);
+		REQUIRE(thr.closed());
+		REQUIRE_THROWS_AS(thr.cast(slow), cooper::queue_closed);
+	}
+
+	SECTION("discard") {
+		auto fut = thr.submit(slow);
+		thr.shutdown(cooper::shutdown_mode::discard);
+		REQUIRE(count < N);
+		REQUIRE_THROWS_AS(fut.get(), std::future_error);
+	}
+
+	SECTION("drain with timeout") {
+		REQUIRE(!thr.shutdown_for(milliseconds(12)));
+		REQUIRE(count < N);
+	}
+
+	SECTION("finalize") {
+		thr.close();
+		thr.finalize([&count] { count = -1; });
+		thr.join();
+		REQUIRE(count == -1);
+
+		int n = 0;
+		thr.finalize([&n] { n = 42; });
+		REQUIRE(n == 42);
+	}
+}
+
+TEST_CASE("work_threads shutdown", "[work_threads]") {
+	cooper::work_threads thrs(4);
+	std::atomic<int> count{0};
+
+	for (size_t i=0; i<thrs.size(); ++i)
+		thrs[i].cast([&count] { ++count; });
+
+	REQUIRE(thrs.shutdown_for(std::chrono::seconds(5)));
+	REQUIRE(count == 4);
+	REQUIRE_THROWS_AS(thrs[0].cast([]{}), cooper::queue_closed);
+}
+
+TEST_CASE("work_threads warm up", "[work_threads]") {
+	cooper::work_threads thrs(2);
+
+	cooper::warm_up_options opts;
+	opts.queue_capacity = 1024;
+	opts.stack_size = 64*1024;
+	opts.num_allocs = 1024;
+
+	for (size_t i=0; i<thrs.size(); ++i)
+		REQUIRE(thrs[i].queue_reserved() < opts.queue_capacity);
+
+	thrs.warm_up(opts);
+
+	// The queue memory was reserved on each thread
+	for (size_t i=0; i<thrs.size(); ++i)
+		REQUIRE(thrs[i].queue_reserved() >= opts.queue_capacity);
+}
+
+TEST_CASE("work_thread warm up runs in the thread", "[work_thread]") {
+	cooper::work_thread thr;
+
+	// Hold the thread, so the warm up can't run yet
+	std::promise<void> gate;
+	thr.cast([fut=gate.get_future().share()] { fut.wait(); });
+
+	cooper::warm_up_options opts;
+	opts.stack_size = 64*1024;
+	opts.num_allocs = 1024;
+
+	auto fut = thr.warm_up(opts);
+	REQUIRE(fut.wait_for(std::chrono::milliseconds(20)) == std::future_status::timeout);
+
+	gate.set_value();
+	fut.get();
+}